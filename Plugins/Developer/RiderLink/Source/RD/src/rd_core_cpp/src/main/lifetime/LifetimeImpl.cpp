@@ -5,7 +5,7 @@
 namespace rd
 {
 #if __cplusplus < 201703L
-LifetimeImpl::counter_t LifetimeImpl::get_id = 0;
+std::atomic<LifetimeImpl::counter_t> LifetimeImpl::get_id{0};
 #endif
 
 LifetimeImpl::LifetimeImpl(bool is_eternal) : eternaled(is_eternal), id(LifetimeImpl::get_id++)
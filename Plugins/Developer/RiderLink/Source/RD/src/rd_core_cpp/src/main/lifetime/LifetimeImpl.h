@@ -79,9 +79,9 @@ public:
 	}
 
 #if __cplusplus >= 201703L
-	static inline counter_t get_id = 0;
+	static inline std::atomic<counter_t> get_id{0};
 #else
-	static counter_t get_id;
+	static std::atomic<counter_t> get_id;
 #endif
 
 	template <typename F, typename G>
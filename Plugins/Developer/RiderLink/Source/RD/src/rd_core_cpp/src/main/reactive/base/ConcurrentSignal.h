@@ -0,0 +1,244 @@
+#ifndef RD_CPP_CORE_CONCURRENTSIGNAL_H
+#define RD_CPP_CORE_CONCURRENTSIGNAL_H
+
+#include "interfaces.h"
+#include "SignalCookie.h"
+
+#include <lifetime/Lifetime.h>
+#include <util/core_util.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace rd
+{
+/**
+ * \brief [Signal] which may be fired, advised and have listeners terminated from any threads at once. Listeners are
+ * kept in immutable snapshots: [advise] publishes a copy with the new listener, [fire] calls listeners of the snapshot
+ * it started with and takes no locks. Replaced snapshots are freed once no fire is running.
+ */
+template <typename T>
+class ConcurrentSignal final : public ISignal<T>
+{
+private:
+	using WT = typename ISignal<T>::WT;
+
+	class Event
+	{
+	private:
+		std::function<void(T const&)> action;
+		Lifetime lifetime;
+
+	public:
+		// region ctor/dtor
+		Event() = delete;
+
+		template <typename F>
+		Event(F&& action, Lifetime lifetime) : action(std::forward<F>(action)), lifetime(lifetime)
+		{
+		}
+		// endregion
+
+		bool is_alive() const
+		{
+			return !lifetime->is_terminated();
+		}
+
+		/**
+		 * \return false if the listener is dead and has to be removed
+		 */
+		bool execute_if_alive(T const& value) const
+		{
+			if (is_alive())
+			{
+				action(value);
+				return true;
+			}
+			return false;
+		}
+	};
+
+	using listeners_t = std::vector<std::shared_ptr<Event const>>;
+
+	struct Snapshot
+	{
+		listeners_t priority_listeners;
+		listeners_t listeners;
+	};
+
+	mutable std::atomic<Snapshot*> snapshot{new Snapshot()};
+	// fires in progress, replaced snapshots are freed when there are none
+	mutable std::atomic<int32_t> readers{0};
+	mutable std::atomic<bool> has_dead{false};
+
+	// serializes replacing of [snapshot]
+	mutable std::mutex lock;
+	mutable std::vector<std::unique_ptr<Snapshot>> retired;
+	mutable std::atomic<bool> has_retired{false};
+
+	static void remove_dead(listeners_t& queue)
+	{
+		queue.erase(std::remove_if(queue.begin(), queue.end(),
+						[](std::shared_ptr<Event const> const& e) -> bool { return !e->is_alive(); }),
+			queue.end());
+	}
+
+	// under [lock]
+	void replace(Snapshot* next) const
+	{
+		retired.emplace_back(snapshot.exchange(next));
+		has_retired = true;
+		reclaim();
+	}
+
+	// under [lock], a fire starting from now on reads the current snapshot only
+	void reclaim() const
+	{
+		if (readers.load() == 0)
+		{
+			retired.clear();
+			has_retired = false;
+		}
+	}
+
+	void fire_impl(T const& value, listeners_t const& queue) const
+	{
+		for (auto const& event : queue)
+		{
+			if (!event->execute_if_alive(value))
+			{
+				has_dead = true;
+			}
+		}
+	}
+
+	class ReadScope
+	{
+		ConcurrentSignal const& signal;
+
+	public:
+		explicit ReadScope(ConcurrentSignal const& signal) : signal(signal)
+		{
+			++signal.readers;
+		}
+
+		ReadScope(ReadScope const&) = delete;
+
+		ReadScope& operator=(ReadScope const&) = delete;
+
+		~ReadScope()
+		{
+			if (--signal.readers == 0 && (signal.has_dead || signal.has_retired))
+			{
+				// fire doesn't wait: if another thread replaces the snapshot, it cleans up itself
+				std::unique_lock<decltype(signal.lock)> guard(signal.lock, std::try_to_lock);
+				if (guard.owns_lock())
+				{
+					signal.cleanup();
+				}
+			}
+		}
+	};
+
+	// under [lock]
+	void cleanup() const
+	{
+		if (has_dead.exchange(false))
+		{
+			Snapshot const* current = snapshot.load();
+			auto* next = new Snapshot(*current);
+			remove_dead(next->priority_listeners);
+			remove_dead(next->listeners);
+			replace(next);
+		}
+		else
+		{
+			reclaim();
+		}
+	}
+
+	template <typename F>
+	void advise0(const Lifetime& lifetime, F&& handler, bool priority) const
+	{
+		if (lifetime->is_terminated())
+			return;
+		std::shared_ptr<Event const> event = std::make_shared<Event>(std::forward<F>(handler), lifetime);
+
+		std::lock_guard<decltype(lock)> guard(lock);
+		auto* next = new Snapshot(*snapshot.load());
+		if (has_dead.exchange(false))
+		{
+			remove_dead(next->priority_listeners);
+			remove_dead(next->listeners);
+		}
+		(priority ? next->priority_listeners : next->listeners).push_back(std::move(event));
+		replace(next);
+	}
+
+public:
+	// region ctor/dtor
+
+	ConcurrentSignal() = default;
+
+	ConcurrentSignal(ConcurrentSignal const& other) = delete;
+
+	ConcurrentSignal& operator=(ConcurrentSignal const& other) = delete;
+
+	/**
+	 * \brief Moving isn't thread-safe, [other] mustn't be used concurrently.
+	 */
+	ConcurrentSignal(ConcurrentSignal&& other) noexcept : snapshot(other.snapshot.exchange(new Snapshot()))
+	{
+	}
+
+	ConcurrentSignal& operator=(ConcurrentSignal&& other) noexcept
+	{
+		if (this != &other)
+		{
+			delete snapshot.exchange(other.snapshot.exchange(new Snapshot()));
+		}
+		return *this;
+	}
+
+	virtual ~ConcurrentSignal()
+	{
+		delete snapshot.load();
+	}
+	// endregion
+
+	using ISignal<T>::fire;
+
+	/**
+	 * \brief Calls listeners advised before, ones advised meanwhile are called from the next fire on.
+	 */
+	void fire(T const& value) const override
+	{
+		const ReadScope scope(*this);
+		Snapshot const* current = snapshot.load();
+		fire_impl(value, current->priority_listeners);
+		fire_impl(value, current->listeners);
+	}
+
+	using ISignal<T>::advise;
+
+	void advise(Lifetime lifetime, std::function<void(T const&)> handler) const override
+	{
+		advise0(lifetime, std::move(handler), isPriorityAdvise());
+	}
+
+	static bool isPriorityAdvise()
+	{
+		return rd_signal_cookie_get() > 0;
+	}
+};
+}	 // namespace rd
+
+static_assert(std::is_move_constructible<rd::ConcurrentSignal<int>>::value,
+	"Is not move constructible from ConcurrentSignal<int>");
+
+#endif	  // RD_CPP_CORE_CONCURRENTSIGNAL_H
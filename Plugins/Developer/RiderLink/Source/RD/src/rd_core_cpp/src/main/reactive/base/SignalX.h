@@ -7,9 +7,12 @@
 #include <lifetime/Lifetime.h>
 #include <util/core_util.h>
 
-#include <utility>
-#include <functional>
+#include <algorithm>
 #include <atomic>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 namespace rd
 {
@@ -38,6 +41,8 @@ private:
 		}
 
 		Event(Event&&) = default;
+
+		Event& operator=(Event&&) = default;
 		// endregion
 
 		bool is_alive() const
@@ -45,44 +50,91 @@ private:
 			return !lifetime->is_terminated();
 		}
 
-		void execute_if_alive(T const& value) const
+		/**
+		 * \return false if the listener is dead and has to be removed
+		 */
+		bool execute_if_alive(T const& value) const
 		{
 			if (is_alive())
 			{
 				action(value);
+				return true;
 			}
+			return false;
 		}
 	};
 
-	using counter_t = int32_t;
-	using listeners_t = std::map<counter_t, Event>;
+	struct Listeners
+	{
+		// in order of advising
+		std::vector<Event> events;
+		// advised while firing, appended when the outermost fire returns, so [events] isn't reallocated under it
+		std::vector<Event> advised;
+		bool has_dead = false;
+	};
 
-	mutable counter_t advise_id = 0;
-	mutable listeners_t listeners, priority_listeners;
+	mutable Listeners listeners, priority_listeners;
+	mutable int32_t firing = 0;
 
-	static void cleanup(listeners_t& queue)
+	// removes dead listeners only if a fire has met one
+	static void compact(Listeners& queue)
 	{
-		util::erase_if(queue, [](Event const& e) -> bool { return !e.is_alive(); });
+		if (queue.has_dead)
+		{
+			queue.events.erase(std::remove_if(queue.events.begin(), queue.events.end(),
+								   [](Event const& e) -> bool { return !e.is_alive(); }),
+				queue.events.end());
+			queue.has_dead = false;
+		}
+		if (!queue.advised.empty())
+		{
+			std::move(queue.advised.begin(), queue.advised.end(), std::back_inserter(queue.events));
+			queue.advised.clear();
+		}
 	}
 
-	void fire_impl(T const& value, listeners_t& queue) const
+	class FireScope
 	{
-		for (auto const& p : queue)
+		Signal const& signal;
+
+	public:
+		explicit FireScope(Signal const& signal) : signal(signal)
 		{
-			auto const& event = p.second;
-			event.execute_if_alive(value);
+			++signal.firing;
+		}
+
+		FireScope(FireScope const&) = delete;
+
+		FireScope& operator=(FireScope const&) = delete;
+
+		~FireScope()
+		{
+			if (--signal.firing == 0)
+			{
+				compact(signal.priority_listeners);
+				compact(signal.listeners);
+			}
+		}
+	};
+
+	void fire_impl(T const& value, Listeners& queue) const
+	{
+		// by index, as nested fires of this signal iterate [events] too
+		for (size_t i = 0, size = queue.events.size(); i < size; ++i)
+		{
+			if (!queue.events[i].execute_if_alive(value))
+			{
+				queue.has_dead = true;
+			}
 		}
-		cleanup(queue);
 	}
 
 	template <typename F>
-	void advise0(const Lifetime& lifetime, F&& handler, listeners_t& queue) const
+	void advise0(const Lifetime& lifetime, F&& handler, Listeners& queue) const
 	{
 		if (lifetime->is_terminated())
 			return;
-		counter_t id = advise_id /*.load()*/;
-		queue.emplace(id, Event(std::forward<F>(handler), lifetime));
-		++advise_id;
+		(firing > 0 ? queue.advised : queue.events).emplace_back(std::forward<F>(handler), lifetime);
 	}
 
 public:
@@ -104,8 +156,12 @@ public:
 
 	using ISignal<T>::fire;
 
+	/**
+	 * \brief Calls listeners advised before, ones advised by them are called from the next fire on.
+	 */
 	void fire(T const& value) const override
 	{
+		const FireScope scope(*this);
 		fire_impl(value, priority_listeners);
 		fire_impl(value, listeners);
 	}
@@ -10,6 +10,8 @@
 #include "base/IRdReactive.h"
 #include "reactive/Property.h"
 
+#include <atomic>
+
 #include <rd_framework_export.h>
 
 namespace rd
@@ -19,6 +21,44 @@ namespace rd
  */
 class RD_FRAMEWORK_API IWire
 {
+	// sends in progress in the low half, the high half is incremented each time they drop to zero
+	mutable std::atomic<uint64_t> send_state{0};
+
+protected:
+	Buffer::Encoding encoding = Buffer::Encoding::FIXED;
+
+	/**
+	 * \brief Marks a send in progress for [sent_since], from writing the message till it's queued.
+	 */
+	class SendScope
+	{
+		IWire const& wire;
+
+	public:
+		explicit SendScope(IWire const& wire) : wire(wire)
+		{
+			++wire.send_state;
+		}
+
+		SendScope(SendScope const&) = delete;
+
+		SendScope& operator=(SendScope const&) = delete;
+
+		~SendScope()
+		{
+			uint64_t state = wire.send_state.load();
+			uint64_t next;
+			do
+			{
+				next = state - 1;
+				if ((next & 0xffffffffu) == 0)
+				{
+					next += uint64_t{1} << 32;
+				}
+			} while (!wire.send_state.compare_exchange_weak(state, next));
+		}
+	};
+
 public:
 	Property<bool> connected{false};
 	Property<bool> heartbeatAlive{false};
@@ -39,6 +79,24 @@ public:
 	 */
 	virtual void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const = 0;
 
+	/**
+	 * \brief Same as [send], [size] is the expected number of bytes [writer] writes so the buffer can be allocated once,
+	 * see [SerializedSize].
+	 */
+	virtual void send(RdId const& id, size_t /*size*/, std::function<void(Buffer& buffer)> writer) const
+	{
+		send(id, std::move(writer));
+	}
+
+	/**
+	 * \brief Same as [send] for a response of entity [origin] sent under [id], e.g. the result of a call an endpoint
+	 * handled. Wires which queue messages by entity queue it along with messages of [origin].
+	 */
+	virtual void send_reply(RdId const& /*origin*/, RdId const& id, std::function<void(Buffer& buffer)> writer) const
+	{
+		send(id, std::move(writer));
+	}
+
 	/**
 	 * \brief Adds a [handler] for receiving updated values of the object with the given [id]. The handler is removed
 	 * when the given [lifetime] is terminated.
@@ -46,6 +104,39 @@ public:
 	 * \param entity to be subscripted
 	 */
 	virtual void advise(Lifetime lifetime, IRdReactive const* entity) const = 0;
+
+	/**
+	 * \brief Selects the encoding of sent and received messages. The other side has to use the same one, so it's set
+	 * before the wire connects.
+	 */
+	void set_encoding(Buffer::Encoding value)
+	{
+		RD_ASSERT_MSG(!connected.get(), "encoding can't be changed on a connected wire");
+		encoding = value;
+	}
+
+	Buffer::Encoding get_encoding() const
+	{
+		return encoding;
+	}
+
+	/**
+	 * \return state to check with [sent_since] later
+	 */
+	uint64_t get_send_state() const
+	{
+		return send_state.load();
+	}
+
+	/**
+	 * \return true if messages of sends in progress at [state] have been queued, so anything sent from now on goes
+	 * after them. Wires which reorder queued messages keep the order for messages of the intern root at least, see
+	 * [ByteBufferAsyncProcessor::set_ordered].
+	 */
+	virtual bool sent_since(uint64_t state) const
+	{
+		return (state & 0xffffffffu) == 0 || (send_state.load() >> 32) != (state >> 32);
+	}
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
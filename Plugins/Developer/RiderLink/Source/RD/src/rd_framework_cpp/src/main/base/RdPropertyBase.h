@@ -3,6 +3,7 @@
 
 #include "base/RdReactiveBase.h"
 #include "serialization/Polymorphic.h"
+#include "serialization/SerializedSize.h"
 #include "reactive/Property.h"
 
 #if defined(_MSC_VER)
@@ -78,8 +79,9 @@ public:
 			{
 				master_version++;
 			}
-			get_wire()->send(rdid, [this, &v](Buffer& buffer) {
-				buffer.write_integral<int32_t>(master_version);
+			const size_t size = sizeof(int32_t) + rd::serialized_size(this->get_serialization_context(), v);
+			get_wire()->send(rdid, size, [this, &v](Buffer& buffer) {
+				buffer.write_varint32(master_version);
 				S::write(this->get_serialization_context(), buffer, v);
 				spdlog::get("logSend")->trace("SEND property {} + {}:: ver = {}, value = {}", to_string(location), to_string(rdid),
 					std::to_string(master_version), to_string(v));
@@ -101,7 +103,7 @@ public:
 
 	void on_wire_received(Buffer buffer) const override
 	{
-		int32_t version = buffer.read_integral<int32_t>();
+		int32_t version = buffer.read_varint32();
 		WT v = S::read(this->get_serialization_context(), buffer);
 
 		bool rejected = is_master && version < master_version;
@@ -2,6 +2,8 @@
 
 #include "protocol/Buffer.h"
 
+#include <algorithm>
+
 namespace rd
 {
 ExtWire::ExtWire()
@@ -35,16 +37,36 @@ void ExtWire::advise(Lifetime lifetime, IRdReactive const* entity) const
 
 void ExtWire::send(RdId const& id, std::function<void(Buffer& buffer)> writer) const
 {
+	send(id, 0, std::move(writer));
+}
+
+void ExtWire::send(RdId const& id, size_t size, std::function<void(Buffer& buffer)> writer) const
+{
+	const SendScope scope(*this);
 	{
 		std::lock_guard<decltype(lock)> guard(lock);
 		if (!sendQ.empty() || !connected.get())
 		{
-			Buffer buffer;
+			Buffer buffer((std::max)(size, size_t{16}));
+			buffer.set_encoding(encoding);
 			writer(buffer);
 			sendQ.emplace(id, buffer.getRealArray());
 			return;
 		}
 	}
-	realWire->send(id, std::move(writer));
+	realWire->send(id, size, std::move(writer));
+}
+
+bool ExtWire::sent_since(uint64_t state) const
+{
+	{
+		// queued messages are sent when the wire connects
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (!sendQ.empty())
+		{
+			return false;
+		}
+	}
+	return IWire::sent_since(state);
 }
 }	 // namespace rd
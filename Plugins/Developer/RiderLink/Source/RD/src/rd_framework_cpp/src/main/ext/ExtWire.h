@@ -32,6 +32,10 @@ public:
 	void advise(Lifetime lifetime, IRdReactive const* entity) const override;
 
 	void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const override;
+
+	void send(RdId const& id, size_t size, std::function<void(Buffer& buffer)> writer) const override;
+
+	bool sent_since(uint64_t state) const override;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
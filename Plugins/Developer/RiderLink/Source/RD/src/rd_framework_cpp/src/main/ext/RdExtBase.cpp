@@ -24,6 +24,7 @@ void RdExtBase::init(Lifetime lifetime) const
 
 	IScheduler* sc = parentProtocol->get_scheduler();
 	extWire->realWire = parentWire.get();
+	extWire->set_encoding(parentWire->get_encoding());
 	lifetime->bracket(
 		[&] {
 			extProtocol =
@@ -97,7 +97,7 @@ public:
 					Op op = static_cast<Op>(e.v.index());
 
 					buffer.write_integral<int64_t>(static_cast<int64_t>(op) | (next_version++ << versionedFlagShift));
-					buffer.write_integral<int32_t>(static_cast<const int32_t>(e.get_index()));
+					buffer.write_varint32(static_cast<int32_t>(e.get_index()));
 
 					T const* new_value = e.get_new_value();
 					if (new_value)
@@ -124,7 +124,7 @@ public:
 		int64_t header = (buffer.read_integral<int64_t>());
 		int64_t version = header >> versionedFlagShift;
 		Op op = static_cast<Op>((header & ((1 << versionedFlagShift) - 1L)));
-		int32_t index = (buffer.read_integral<int32_t>());
+		int32_t index = (buffer.read_varint32());
 
 		RD_ASSERT_MSG(version == next_version,
 			("Version conflict for " + to_string(location) + "}. Expected version " + std::to_string(next_version) + ", received " +
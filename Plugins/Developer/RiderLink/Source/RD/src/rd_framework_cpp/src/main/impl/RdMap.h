@@ -107,7 +107,7 @@ public:
 					int32_t versionedFlag = ((is_master ? 1 : 0)) << versionedFlagShift;
 					Op op = static_cast<Op>(e.v.index());
 
-					buffer.write_integral<int32_t>(static_cast<int32_t>(op) | versionedFlag);
+					buffer.write_varint32(static_cast<int32_t>(op) | versionedFlag);
 
 					int64_t version = is_master ? ++next_version : 0L;
 
@@ -140,7 +140,7 @@ public:
 
 	void on_wire_received(Buffer buffer) const override
 	{
-		int32_t header = buffer.read_integral<int32_t>();
+		int32_t header = buffer.read_varint32();
 		bool msg_versioned = (header >> versionedFlagShift) != 0;
 		Op op = static_cast<Op>(header & ((1 << versionedFlagShift) - 1));
 
@@ -196,6 +196,8 @@ public:
 		else
 		{
 			Buffer serialized_key;
+			// the key is copied into a message as is, so it has to be encoded the way the message is
+			serialized_key.set_encoding(buffer.get_encoding());
 			KS::write(this->get_serialization_context(), serialized_key, wrapper::get<K>(key));
 
 			bool is_put = (op == Op::ADD || op == Op::UPDATE);
@@ -226,7 +228,7 @@ public:
 			{
 				auto writer =
 					util::make_shared_function([version, serialized_key = std::move(serialized_key)](Buffer& innerBuffer) mutable {
-						innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
+						innerBuffer.write_varint32((1 << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
 						innerBuffer.write_integral<int64_t>(version);
 						// KS::write(this->get_serialization_context(), innerBuffer, wrapper::get<K>(key));
 						innerBuffer.write_byte_array_raw(serialized_key.getArray());
@@ -4,9 +4,10 @@
 #include "lifetime/Lifetime.h"
 #include "reactive/base/interfaces.h"
 #include "scheduler/base/IScheduler.h"
-#include "reactive/base/SignalX.h"
+#include "reactive/base/ConcurrentSignal.h"
 #include "base/RdReactiveBase.h"
 #include "serialization/Polymorphic.h"
+#include "serialization/SerializedSize.h"
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -41,7 +42,8 @@ private:
 	}
 
 protected:
-	Signal<T> signal;
+	// fired from the wire scheduler and, if async, from any thread firing this signal
+	ConcurrentSignal<T> signal;
 
 public:
 	// region ctor/dtor
@@ -102,7 +104,7 @@ public:
 
 		if (async && !is_bound()) return;
 
-		get_wire()->send(rdid, [this, &value](Buffer& buffer) {
+		get_wire()->send(rdid, rd::serialized_size(get_serialization_context(), value), [this, &value](Buffer& buffer) {
 			spdlog::get("logSend")->trace("SEND{}", logmsg(value));
 			S::write(get_serialization_context(), buffer, value);
 		});
@@ -111,13 +113,16 @@ public:
 
 	using ISource<T>::advise;
 
+	/**
+	 * \brief Async signals may be advised from any thread, others from the protocol scheduler once bound.
+	 */
 	void advise(Lifetime lifetime, std::function<void(T const&)> handler) const override
 	{
-		if (is_bound())
+		if (is_bound() && !async)
 		{
 			assert_threading();
 		}
-		signal.advise(lifetime, handler);
+		signal.advise(lifetime, std::move(handler));
 	}
 
 	template <typename F>
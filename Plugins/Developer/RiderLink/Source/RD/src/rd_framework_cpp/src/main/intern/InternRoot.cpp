@@ -10,6 +10,58 @@ InternRoot::InternRoot()
 	async = true;
 }
 
+void InternRoot::set_capacity(size_t value) const
+{
+	items.set_capacity(value);
+}
+
+InternTable::Stats InternRoot::get_stats() const
+{
+	return items.get_stats();
+}
+
+void InternRoot::rotate_if_full() const
+{
+	items.rotate_if_full(*get_protocol()->get_wire());
+	send_retired();
+}
+
+void InternRoot::send_retired() const
+{
+	int32_t retired = 0;
+	int32_t acknowledged = 0;
+	if (!items.take_sent(*get_protocol()->get_wire(), retired, acknowledged))
+	{
+		return;
+	}
+	get_protocol()->get_wire()->send(this->rdid, [retired, acknowledged](Buffer& buffer) {
+		// marked by a null value, so the other side ignores it if it doesn't evict
+		for (int32_t id : {retired, acknowledged})
+		{
+			if (id != 0)
+			{
+				RdId::Null().write(buffer);
+				buffer.write_varint32(id);
+			}
+		}
+	});
+}
+
+void InternRoot::on_retired(int32_t id) const
+{
+	if ((id & 1) == 0)
+	{
+		// the other side doesn't hand out its ids below [id] anymore
+		items.retire_other(id ^ 1, *get_protocol()->get_wire());
+	}
+	else
+	{
+		// the other side doesn't send own ids below [id] anymore
+		items.free_own(id ^ 1);
+	}
+	send_retired();
+}
+
 IScheduler* InternRoot::get_wire_scheduler() const
 {
 	return &intern_scheduler;
@@ -17,14 +69,26 @@ IScheduler* InternRoot::get_wire_scheduler() const
 
 void InternRoot::on_wire_received(Buffer buffer) const
 {
-	optional<InternedAny> value = InternedAnySerializer::read(get_serialization_context(), buffer);
-	if (!value)
+	// a message of [intern_values] holds several values
+	do
 	{
-		return;
-	}
-	const int32_t remote_id = buffer.read_integral<int32_t>();
-	set_interned_correspondence(remote_id ^ 1, *std::move(value));
-	RD_ASSERT_MSG(((remote_id & 1) == 0), "Remote sent ID marked as our own, bug?");
+		optional<InternedAny> value = InternedAnySerializer::read(get_serialization_context(), buffer);
+		if (!value)
+		{
+			if (buffer.available() == 0)
+			{
+				return;
+			}
+			// messages received before may refer to retired ids, so it's handled after them
+			const int32_t retired = buffer.read_varint32();
+			get_protocol()->get_scheduler()->queue([this, retired] { on_retired(retired); });
+			continue;
+		}
+		const int32_t remote_id = buffer.read_varint32();
+		set_interned_correspondence(remote_id ^ 1, *std::move(value));
+		RD_ASSERT_MSG(((remote_id & 1) == 0), "Remote sent ID marked as our own, bug?");
+	} while (buffer.available() > 0);
+	send_retired();
 }
 
 void InternRoot::bind(Lifetime lf, IRdDynamic const* parent, string_view name) const
@@ -42,13 +106,8 @@ void InternRoot::bind(Lifetime lf, IRdDynamic const* parent, string_view name) c
 			rdid = RdId::Null();
 		});
 
-	{
-		// if something's interned before bind
-		std::lock_guard<decltype(lock)> guard(lock);
-		my_items_lis.clear();
-		other_items_list.clear();
-		inverse_map.clear();
-	}
+	// if something's interned before bind
+	items.clear();
 	get_protocol()->get_wire()->advise(lf, this);
 }
 
@@ -64,8 +123,6 @@ void InternRoot::set_interned_correspondence(int32_t id, InternedAny&& value) co
 {
 	RD_ASSERT_MSG(!is_index_owned(id), "Setting interned correspondence for object that we should have written, bug?")
 
-	std::lock_guard<decltype(lock)> guard(lock);
-	other_items_list[id / 2] = value;
-	inverse_map[value] = id;
+	items.set_other(id, std::move(value));
 }
 }	 // namespace rd
@@ -3,16 +3,14 @@
 
 #include "base/RdReactiveBase.h"
 #include "InternScheduler.h"
+#include "InternTable.h"
 #include "lifetime/Lifetime.h"
 #include "types/wrapper.h"
 #include "serialization/RdAny.h"
 #include "util/core_traits.h"
 
-#include "tsl/ordered_map.h"
-
 #include <vector>
 #include <string>
-#include <mutex>
 
 #include <rd_framework_export.h>
 
@@ -36,17 +34,18 @@ class Identities;
 class RD_FRAMEWORK_API InternRoot final : public RdReactiveBase
 {
 private:
-	// template<typename T>
-	mutable std::vector<InternedAny> my_items_lis;
-
-	// template<typename T>
-	mutable ordered_map<int32_t, InternedAny> other_items_list;
-	// template<typename T>
-	mutable ordered_map<InternedAny, int32_t, any::TransparentHash, any::TransparentKeyEqual> inverse_map;
+	mutable InternTable items;
 
 	mutable InternScheduler intern_scheduler;
 
-	mutable std::recursive_mutex lock;
+	template <typename T>
+	void send_value(InternTable::Entry* entry, Wrapper<T> const& value) const;
+
+	void rotate_if_full() const;
+
+	void send_retired() const;
+
+	void on_retired(int32_t id) const;
 
 	void set_interned_correspondence(int32_t id, InternedAny&& value) const;
 
@@ -58,9 +57,26 @@ public:
 	InternRoot();
 	// endregion
 
+	/**
+	 * \brief Bounds values interned by this side, see [InternTable::set_capacity]. Evicted values are freed once the
+	 * other side acknowledges it doesn't use them, a side which doesn't evict never does. Has to be set before
+	 * anything's interned.
+	 */
+	void set_capacity(size_t value) const;
+
+	InternTable::Stats get_stats() const;
+
 	template <typename T>
 	int32_t intern_value(Wrapper<T> value) const;
 
+	/**
+	 * \brief Interns [values] sending all the new ones in a single message, which the other side has to read to the
+	 * end as [on_wire_received] does. With eviction on the ids have to be written to a message being sent.
+	 * \return ids of [values] in the same order
+	 */
+	template <typename T>
+	std::vector<int32_t> intern_values(std::vector<Wrapper<T>> const& values) const;
+
 	template <typename T>
 	Wrapper<T> un_intern_value(int32_t id) const;
 
@@ -78,15 +94,6 @@ public:
 
 namespace rd
 {
-/*template<typename T>
-std::vector<value_or_wrapper<T>> InternRoot::myItemsList = {};
-
-template<typename T>
-ordered_map<int32_t, value_or_wrapper<T>> InternRoot::otherItemsList = {};
-
-template<typename T>
-ordered_map<value_or_wrapper<T>, int32_t> InternRoot::inverseMap = {};*/
-
 constexpr bool InternRoot::is_index_owned(int32_t id)
 {
 	return !static_cast<bool>(id & 1);
@@ -95,40 +102,123 @@ constexpr bool InternRoot::is_index_owned(int32_t id)
 template <typename T>
 Wrapper<T> InternRoot::un_intern_value(int32_t id) const
 {
-	// don't need lock because value's already exists and never removes
-	return any::get<T>(is_index_owned(id) ? my_items_lis[id / 2] : other_items_list[id / 2]);
+	// don't need lock because value's already exists and isn't freed while it's read
+	InternTable::ReadGuard guard(items);
+	return any::get<T>(items.get(id));
+}
+
+template <typename T>
+void InternRoot::send_value(InternTable::Entry* entry, Wrapper<T> const& value) const
+{
+	try
+	{
+		get_protocol()->get_wire()->send(this->rdid, [this, &value, entry](Buffer& buffer) {
+			InternedAnySerializer::write<T>(get_serialization_context(), buffer, wrapper::get<T>(value));
+			buffer.write_varint32(entry->id);
+		});
+	}
+	catch (...)
+	{
+		items.fail(entry);
+		throw;
+	}
+	items.publish(entry);
 }
 
 template <typename T>
 int32_t InternRoot::intern_value(Wrapper<T> value) const
 {
 	InternedAny any = any::make_interned_any<T>(value);
+	const size_t hash = InternTable::hash(any);
 
-	std::lock_guard<decltype(lock)> guard(lock);
-
-	auto it = inverse_map.find(any);
-	int32_t index = 0;
-	if (it == inverse_map.end())
+	int32_t id;
+	bool sent = false;
 	{
-		get_protocol()->get_wire()->send(this->rdid, [this, &index, value, any](Buffer& buffer) {
-			InternedAnySerializer::write<T>(get_serialization_context(), buffer, wrapper::get<T>(value));
-			{
-				std::lock_guard<decltype(lock)> guard(lock);
-				index = static_cast<int32_t>(my_items_lis.size()) * 2;
-				my_items_lis.emplace_back(any);
-			}
-			buffer.write_integral<int32_t>(index);
-		});
+		InternTable::ReadGuard guard(items);
+		bool inserted = false;
+		InternTable::Entry* entry = items.find(any, hash);
+		if (entry == nullptr)
+		{
+			entry = items.find_or_insert(any, hash, inserted);
+		}
+		// the thread which inserted the value sends it, others wait for that
+		if (items.claim(entry, inserted))
+		{
+			send_value(entry, value);
+			sent = true;
+		}
+		id = entry->id;
 	}
-	else
+	if (sent)
 	{
-		index = it->second;
+		rotate_if_full();
 	}
-	if (inverse_map.count(any) == 0)
+	return id;
+}
+
+template <typename T>
+std::vector<int32_t> InternRoot::intern_values(std::vector<Wrapper<T>> const& values) const
+{
+	std::vector<int32_t> ids(values.size());
 	{
-		inverse_map[any] = index;
+		InternTable::ReadGuard guard(items);
+		std::vector<InternTable::Entry*> entries(values.size());
+		std::vector<size_t> inserted_values;
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			InternedAny any = any::make_interned_any<T>(values[i]);
+			const size_t hash = InternTable::hash(any);
+
+			bool inserted = false;
+			entries[i] = items.find(any, hash);
+			if (entries[i] == nullptr)
+			{
+				entries[i] = items.find_or_insert(any, hash, inserted);
+			}
+			if (inserted)
+			{
+				inserted_values.push_back(i);
+			}
+			ids[i] = entries[i]->id;
+		}
+
+		if (!inserted_values.empty())
+		{
+			try
+			{
+				get_protocol()->get_wire()->send(this->rdid, [this, &values, &ids, &inserted_values](Buffer& buffer) {
+					for (size_t i : inserted_values)
+					{
+						InternedAnySerializer::write<T>(get_serialization_context(), buffer, wrapper::get<T>(values[i]));
+						buffer.write_varint32(ids[i]);
+					}
+				});
+			}
+			catch (...)
+			{
+				for (size_t i : inserted_values)
+				{
+					items.fail(entries[i]);
+				}
+				throw;
+			}
+			for (size_t i : inserted_values)
+			{
+				items.publish(entries[i]);
+			}
+		}
+
+		// values sent by other threads are awaited only after publishing own ones, so threads can't wait for each other
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			if (items.claim(entries[i], false))
+			{
+				send_value(entries[i], values[i]);
+			}
+		}
 	}
-	return index;
+	rotate_if_full();
+	return ids;
 }
 }	 // namespace rd
 #if defined(_MSC_VER)
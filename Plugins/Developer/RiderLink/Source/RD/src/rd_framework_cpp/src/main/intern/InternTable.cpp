@@ -0,0 +1,505 @@
+#include "InternTable.h"
+
+#include "base/IWire.h"
+#include "util/core_util.h"
+
+#include <algorithm>
+#include <string>
+
+namespace rd
+{
+constexpr size_t InternTable::MIN_CAPACITY;
+constexpr size_t InternTable::Ids::SEGMENT;
+
+InternTable::ReadGuard::ReadGuard(InternTable const& table) : table(table), counted(table.capacity.load() != 0)
+{
+	if (counted)
+	{
+		++table.readers;
+	}
+}
+
+InternTable::ReadGuard::~ReadGuard()
+{
+	if (counted)
+	{
+		--table.readers;
+	}
+}
+
+InternTable::Slots::Slots(size_t capacity) : mask(capacity - 1), items(new std::atomic<Entry*>[capacity]())
+{
+}
+
+// region Ids
+
+InternTable::Ids::Directory::Directory(size_t size) : size(size), segments(new std::atomic<std::atomic<Entry*>*>[size]())
+{
+}
+
+InternTable::Ids::~Ids()
+{
+	clear();
+}
+
+void InternTable::Ids::set(size_t index, Entry* entry)
+{
+	const size_t s = index / SEGMENT;
+	Directory* dir = directory.load(std::memory_order_acquire);
+	std::atomic<Entry*>* items = dir != nullptr && s < dir->size ? dir->segments[s].load(std::memory_order_acquire) : nullptr;
+	if (items == nullptr)
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		dir = directory.load(std::memory_order_acquire);
+		if (dir == nullptr || s >= dir->size)
+		{
+			auto grown = std::make_unique<Directory>((std::max)({size_t{16}, s + 1, dir != nullptr ? dir->size * 2 : 0}));
+			for (size_t i = 0; dir != nullptr && i < dir->size; ++i)
+			{
+				grown->segments[i].store(dir->segments[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			}
+			dir = grown.get();
+			directory.store(dir, std::memory_order_release);
+			directories.push_back(std::move(grown));
+		}
+		items = dir->segments[s].load(std::memory_order_acquire);
+		if (items == nullptr)
+		{
+			if (owned_segments.size() <= s)
+			{
+				owned_segments.resize(s + 1);
+			}
+			owned_segments[s].reset(new std::atomic<Entry*>[SEGMENT]());
+			items = owned_segments[s].get();
+			dir->segments[s].store(items, std::memory_order_release);
+		}
+	}
+	items[index % SEGMENT].store(entry, std::memory_order_release);
+}
+
+InternTable::Entry* InternTable::Ids::get(size_t index) const
+{
+	const size_t s = index / SEGMENT;
+	Directory const* dir = directory.load(std::memory_order_acquire);
+	if (dir == nullptr || s >= dir->size)
+	{
+		return nullptr;
+	}
+	std::atomic<Entry*> const* items = dir->segments[s].load(std::memory_order_acquire);
+	return items != nullptr ? items[index % SEGMENT].load(std::memory_order_acquire) : nullptr;
+}
+
+size_t InternTable::Ids::get_freed() const
+{
+	return freed;
+}
+
+void InternTable::Ids::free_below(size_t index, Limbo& limbo)
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	Directory* dir = directory.load();
+	for (size_t s = freed / SEGMENT; dir != nullptr && s < dir->size && s * SEGMENT < index; ++s)
+	{
+		std::atomic<Entry*>* items = dir->segments[s].load();
+		if (items == nullptr)
+		{
+			continue;
+		}
+		for (size_t i = (std::max)(freed, s * SEGMENT); i < (std::min)(index, (s + 1) * SEGMENT); ++i)
+		{
+			if (Entry* entry = items[i % SEGMENT].exchange(nullptr))
+			{
+				limbo.entries.push_back(entry);
+			}
+		}
+		if ((s + 1) * SEGMENT <= index)
+		{
+			dir->segments[s].store(nullptr);
+			limbo.segments.push_back(std::move(owned_segments[s]));
+		}
+	}
+	freed = (std::max)(freed, index);
+}
+
+void InternTable::Ids::clear()
+{
+	for (auto& segment : owned_segments)
+	{
+		for (size_t i = 0; segment != nullptr && i < SEGMENT; ++i)
+		{
+			delete segment[i].exchange(nullptr);
+		}
+	}
+	owned_segments.clear();
+	directory = nullptr;
+	directories.clear();
+	freed = 0;
+}
+// endregion
+
+InternTable::InternTable() : table(new Slots(MIN_CAPACITY))
+{
+}
+
+InternTable::~InternTable()
+{
+	delete_all();
+}
+
+size_t InternTable::hash(InternedAny const& value)
+{
+	return any::TransparentHash()(value);
+}
+
+size_t InternTable::footprint(Entry const& entry)
+{
+	return sizeof(Entry) + visit(util::make_visitor([](any::wrapped_super_t const&) { return size_t{0}; },
+									 [](any::string const& value) { return value->size() * sizeof(wchar_t); }),
+							   entry.value);
+}
+
+void InternTable::set_capacity(size_t value)
+{
+	RD_ASSERT_MSG(next_own_index == 0, "Intern capacity has to be set before anything's interned");
+	capacity = value;
+}
+
+InternTable::Entry* InternTable::find(InternedAny const& value, size_t hash) const
+{
+	Slots const& slots = *table.load();
+	for (size_t i = hash & slots.mask;; i = (i + 1) & slots.mask)
+	{
+		Entry* entry = slots.items[i].load(std::memory_order_acquire);
+		if (entry == nullptr)
+		{
+			return nullptr;
+		}
+		if (entry->hash == hash && any::TransparentKeyEqual()(entry->value, value))
+		{
+			return entry;
+		}
+	}
+}
+
+bool InternTable::try_insert(Slots& slots, Entry* entry, Entry*& result)
+{
+	for (size_t i = entry->hash & slots.mask;; i = (i + 1) & slots.mask)
+	{
+		Entry* current = slots.items[i].load(std::memory_order_acquire);
+		if (current == nullptr && slots.items[i].compare_exchange_strong(current, entry, std::memory_order_acq_rel))
+		{
+			result = entry;
+			return true;
+		}
+		// the slot is taken, possibly by the same value just now
+		if (current->hash == entry->hash && any::TransparentKeyEqual()(current->value, entry->value))
+		{
+			result = current;
+			return false;
+		}
+	}
+}
+
+InternTable::Entry* InternTable::find_or_insert(InternedAny const& value, size_t hash, bool& inserted)
+{
+	std::unique_ptr<Entry> entry;
+	while (true)
+	{
+		{
+			std::shared_lock<decltype(resize_lock)> guard(resize_lock);
+			Slots& slots = *table.load();
+			// reserve a slot first, so the table is never more than half full and probing always ends
+			if (count.fetch_add(1) < (slots.mask + 1) / 2)
+			{
+				if (entry == nullptr)
+				{
+					// allocated under the lock, so eviction sees every index in use
+					const int32_t index = next_own_index++;
+					entry = std::make_unique<Entry>(hash, value, index * 2, Entry::State::PENDING);
+				}
+				Entry* result = nullptr;
+				inserted = try_insert(slots, entry.get(), result);
+				if (!inserted)
+				{
+					// the index stays unused
+					--count;
+					return result;
+				}
+				bytes += footprint(*entry);
+				++own_values;
+				own_ids.set(static_cast<size_t>(entry->id / 2), entry.get());
+				return entry.release();
+			}
+			--count;
+		}
+		grow();
+	}
+}
+
+template <typename F>
+void InternTable::rebuild(F&& keep)
+{
+	Slots* old = table.load();
+	size_t kept = 0;
+	for (size_t i = 0; i <= old->mask; ++i)
+	{
+		Entry const* entry = old->items[i].load(std::memory_order_relaxed);
+		if (entry != nullptr && keep(*entry))
+		{
+			++kept;
+		}
+	}
+	size_t size = MIN_CAPACITY;
+	while (size / 2 <= kept)
+	{
+		size *= 2;
+	}
+
+	auto rebuilt = std::make_unique<Slots>(size);
+	for (size_t i = 0; i <= old->mask; ++i)
+	{
+		Entry* entry = old->items[i].load(std::memory_order_relaxed);
+		if (entry != nullptr && keep(*entry))
+		{
+			size_t j = entry->hash & rebuilt->mask;
+			while (rebuilt->items[j].load(std::memory_order_relaxed) != nullptr)
+			{
+				j = (j + 1) & rebuilt->mask;
+			}
+			rebuilt->items[j].store(entry, std::memory_order_relaxed);
+		}
+	}
+	table = rebuilt.release();
+	count = kept;
+	// readers which loaded the old table before keep probing it
+	limbo.tables.emplace_back(old);
+}
+
+void InternTable::grow()
+{
+	std::lock_guard<decltype(resize_lock)> guard(resize_lock);
+	if (count < (table.load()->mask + 1) / 2)
+	{
+		return;	   // grown by another thread
+	}
+	rebuild([](Entry const&) { return true; });
+}
+
+void InternTable::free_below(Ids& ids, size_t index, std::atomic<size_t>& values)
+{
+	const size_t first = limbo.entries.size();
+	ids.free_below(index, limbo);
+	for (size_t i = first; i < limbo.entries.size(); ++i)
+	{
+		bytes -= footprint(*limbo.entries[i]);
+		--values;
+	}
+}
+
+void InternTable::reclaim()
+{
+	// without eviction readers aren't counted, what's freed is kept until clear
+	if (capacity == 0 || readers != 0)
+	{
+		return;
+	}
+	for (Entry* entry : limbo.entries)
+	{
+		delete entry;
+	}
+	limbo = Limbo{};
+}
+
+void InternTable::notify_published()
+{
+	{
+		// pairs with the predicate check of a waiting thread, so the notification can't be missed
+		std::lock_guard<decltype(publish_lock)> guard(publish_lock);
+	}
+	published_cv.notify_all();
+}
+
+bool InternTable::claim(Entry* entry, bool inserted)
+{
+	if (inserted)
+	{
+		return true;
+	}
+	Entry::State state = entry->state.load(std::memory_order_acquire);
+	while (state != Entry::State::PUBLISHED)
+	{
+		if (state == Entry::State::FAILED &&
+			entry->state.compare_exchange_strong(state, Entry::State::PENDING, std::memory_order_acq_rel))
+		{
+			return true;
+		}
+		if (state == Entry::State::PENDING)
+		{
+			std::unique_lock<decltype(publish_lock)> guard(publish_lock);
+			published_cv.wait(guard, [entry] { return entry->state.load(std::memory_order_acquire) != Entry::State::PENDING; });
+		}
+		state = entry->state.load(std::memory_order_acquire);
+	}
+	return false;
+}
+
+void InternTable::publish(Entry* entry)
+{
+	entry->state.store(Entry::State::PUBLISHED, std::memory_order_release);
+	notify_published();
+}
+
+void InternTable::fail(Entry* entry)
+{
+	entry->state.store(Entry::State::FAILED, std::memory_order_release);
+	notify_published();
+}
+
+void InternTable::rotate_if_full(IWire const& wire)
+{
+	const size_t limit = capacity;
+	if (limit == 0 || static_cast<size_t>(next_own_index) - generation_start < limit)
+	{
+		return;
+	}
+
+	std::lock_guard<decltype(resize_lock)> guard(resize_lock);
+	const size_t next = static_cast<size_t>(next_own_index);
+	const size_t unlinked = generation_start;
+	if (next - unlinked < limit)
+	{
+		return;	   // rotated by another thread
+	}
+	// the previous generation isn't handed out anymore, sends which may have got its ids are awaited
+	rebuild([unlinked](Entry const& entry) { return (entry.id & 1) != 0 || static_cast<size_t>(entry.id / 2) >= unlinked; });
+	unannounced.push_back({unlinked, wire.get_send_state()});
+	++pending;
+	generation_start = next;
+	++evictions;
+	reclaim();
+}
+
+void InternTable::set_other(int32_t id, InternedAny value)
+{
+	ReadGuard read_guard(*this);
+	const size_t hash = InternTable::hash(value);
+	auto entry = std::make_unique<Entry>(hash, std::move(value), id, Entry::State::PUBLISHED);
+	const size_t index = static_cast<size_t>(id / 2);
+	while (true)
+	{
+		{
+			std::shared_lock<decltype(resize_lock)> guard(resize_lock);
+			if (index < other_ids.get_freed())
+			{
+				return;	   // freed by the other side already
+			}
+			Slots& slots = *table.load();
+			if (count.fetch_add(1) < (slots.mask + 1) / 2)
+			{
+				Entry* result = nullptr;
+				// a retired value still resolves but isn't handed out, an interned one resolves to its copy
+				if (index < other_retired || !try_insert(slots, entry.get(), result))
+				{
+					--count;
+				}
+				bytes += footprint(*entry);
+				++other_values;
+				other_ids.set(index, entry.release());
+				return;
+			}
+			--count;
+		}
+		grow();
+	}
+}
+
+void InternTable::retire_other(int32_t id, IWire const& wire)
+{
+	std::lock_guard<decltype(resize_lock)> guard(resize_lock);
+	const size_t below = static_cast<size_t>(id / 2);
+	if (below <= other_retired)
+	{
+		return;
+	}
+	rebuild([below](Entry const& entry) { return (entry.id & 1) == 0 || static_cast<size_t>(entry.id / 2) >= below; });
+	other_retired = below;
+	free_below(other_ids, below, other_values);
+	unacknowledged.push_back({below, wire.get_send_state()});
+	++pending;
+	reclaim();
+}
+
+void InternTable::free_own(int32_t id)
+{
+	std::lock_guard<decltype(resize_lock)> guard(resize_lock);
+	free_below(own_ids, (std::min)(static_cast<size_t>(id / 2), generation_start.load()), own_values);
+	reclaim();
+}
+
+size_t InternTable::pop_sent(IWire const& wire, std::deque<Retired>& retired)
+{
+	size_t below = 0;
+	while (!retired.empty() && wire.sent_since(retired.front().send_state))
+	{
+		below = retired.front().below;
+		retired.pop_front();
+	}
+	return below;
+}
+
+bool InternTable::take_sent(IWire const& wire, int32_t& retired, int32_t& acknowledged)
+{
+	if (pending == 0)
+	{
+		return false;
+	}
+	std::lock_guard<decltype(resize_lock)> guard(resize_lock);
+	const size_t own = pop_sent(wire, unannounced);
+	const size_t other = pop_sent(wire, unacknowledged);
+	pending = unannounced.size() + unacknowledged.size();
+	retired = static_cast<int32_t>(own * 2);
+	acknowledged = other != 0 ? static_cast<int32_t>(other * 2 + 1) : 0;
+	return own != 0 || other != 0;
+}
+
+InternedAny InternTable::get(int32_t id) const
+{
+	Entry const* entry = ((id & 1) != 0 ? other_ids : own_ids).get(static_cast<size_t>(id / 2));
+	RD_ASSERT_THROW_MSG(entry != nullptr, "Unknown or evicted interned id: " + std::to_string(id));
+	return entry->value;
+}
+
+InternTable::Stats InternTable::get_stats() const
+{
+	return Stats{own_values, other_values, bytes, evictions};
+}
+
+void InternTable::delete_all()
+{
+	own_ids.clear();
+	other_ids.clear();
+	for (Entry* entry : limbo.entries)
+	{
+		delete entry;
+	}
+	limbo = Limbo{};
+	delete table.exchange(nullptr);
+}
+
+void InternTable::clear()
+{
+	std::lock_guard<decltype(resize_lock)> guard(resize_lock);
+	delete_all();
+	table = new Slots(MIN_CAPACITY);
+	count = 0;
+	next_own_index = 0;
+	generation_start = 0;
+	other_retired = 0;
+	unannounced.clear();
+	unacknowledged.clear();
+	pending = 0;
+	own_values = 0;
+	other_values = 0;
+	bytes = 0;
+}
+}	 // namespace rd
@@ -0,0 +1,304 @@
+#ifndef RD_CPP_INTERNTABLE_H
+#define RD_CPP_INTERNTABLE_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "serialization/RdAny.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+// region predeclared
+
+class IWire;
+// endregion
+
+/**
+ * \brief Interned values of [InternRoot] and their ids. Lookups take no locks, a new value is inserted once by CAS
+ * into an open addressing table, so threads interning different values don't serialize. The table is locked
+ * exclusively only to grow or evict.
+ *
+ * Values are kept until [clear] unless [set_capacity] bounds them. Then own values are evicted by generations: when
+ * the current generation has [capacity] values, the previous one stops being handed out. Once messages being written
+ * with its ids are sent, the other side is told to retire them. It forgets them and acknowledges that once its own
+ * messages with them are sent, then they're freed. So an id written to a message is never evicted before the
+ * message is read, provided messages are read on the protocol scheduler.
+ */
+class RD_FRAMEWORK_API InternTable
+{
+public:
+	struct Entry
+	{
+		enum class State : uint8_t
+		{
+			/**
+			 * \brief The value is being sent by the thread which inserted or claimed it.
+			 */
+			PENDING,
+			/**
+			 * \brief The value failed to be sent, the next thread interning it sends it again.
+			 */
+			FAILED,
+			PUBLISHED
+		};
+
+		const size_t hash;
+		const InternedAny value;
+		const int32_t id;
+		std::atomic<State> state;
+
+		Entry(size_t hash, InternedAny value, int32_t id, State state)
+			: hash(hash), value(std::move(value)), id(id), state(state)
+		{
+		}
+	};
+
+	struct Stats
+	{
+		size_t own_values;
+		size_t other_values;
+
+		/**
+		 * \brief Approximate memory held by values: entries and contents of strings.
+		 */
+		size_t bytes;
+
+		uint64_t evictions;
+	};
+
+	/**
+	 * \brief Counts a thread using entries without locks, so evicted ones aren't freed under it. Counts nothing unless
+	 * eviction is on.
+	 */
+	class ReadGuard
+	{
+		InternTable const& table;
+		const bool counted;
+
+	public:
+		explicit ReadGuard(InternTable const& table);
+
+		ReadGuard(ReadGuard const&) = delete;
+
+		ReadGuard& operator=(ReadGuard const&) = delete;
+
+		~ReadGuard();
+	};
+
+private:
+	struct Slots
+	{
+		const size_t mask;
+		std::unique_ptr<std::atomic<Entry*>[]> items;
+
+		explicit Slots(size_t capacity);
+	};
+
+	using Segment = std::unique_ptr<std::atomic<Entry*>[]>;
+
+	// ids below [below] aren't handed out, messages of sends in progress at [send_state] may still carry them
+	struct Retired
+	{
+		size_t below;
+		uint64_t send_state;
+	};
+
+	// freed entries and storage wait here until no thread reads without locks
+	struct Limbo
+	{
+		std::vector<Entry*> entries;
+		std::vector<Segment> segments;
+		std::vector<std::unique_ptr<Slots>> tables;
+	};
+
+	// id / 2 -> entry, owns the entries, segments below freed ids are released
+	class Ids
+	{
+		static constexpr size_t SEGMENT = 1024;
+
+		struct Directory
+		{
+			const size_t size;
+			std::unique_ptr<std::atomic<std::atomic<Entry*>*>[]> segments;
+
+			explicit Directory(size_t size);
+		};
+
+		std::atomic<Directory*> directory{nullptr};
+		// the current directory is the last one, replaced ones are kept as readers may still use them
+		std::vector<std::unique_ptr<Directory>> directories;
+		std::vector<Segment> owned_segments;
+		std::mutex lock;
+		size_t freed = 0;
+
+	public:
+		~Ids();
+
+		void set(size_t index, Entry* entry);
+
+		Entry* get(size_t index) const;
+
+		/**
+		 * \brief Ids below this one are freed.
+		 */
+		size_t get_freed() const;
+
+		void free_below(size_t index, Limbo& limbo);
+
+		void clear();
+	};
+
+	static constexpr size_t MIN_CAPACITY = 64;
+
+	std::atomic<Slots*> table;
+	// values are inserted under shared lock, table grows and evicts under exclusive one
+	mutable std::shared_timed_mutex resize_lock;
+	std::atomic<size_t> count{0};
+
+	Ids own_ids;
+	Ids other_ids;
+	std::atomic<int32_t> next_own_index{0};
+
+	std::mutex publish_lock;
+	std::condition_variable published_cv;
+
+	// region eviction
+
+	std::atomic<size_t> capacity{0};
+	// own indices below it are the previous generation
+	std::atomic<size_t> generation_start{0};
+	// the other side's indices below it aren't handed out
+	size_t other_retired = 0;
+	std::deque<Retired> unannounced;
+	std::deque<Retired> unacknowledged;
+	std::atomic<size_t> pending{0};
+	mutable std::atomic<size_t> readers{0};
+	Limbo limbo;
+
+	std::atomic<size_t> own_values{0};
+	std::atomic<size_t> other_values{0};
+	std::atomic<size_t> bytes{0};
+	std::atomic<uint64_t> evictions{0};
+	// endregion
+
+	static size_t footprint(Entry const& entry);
+
+	bool try_insert(Slots& slots, Entry* entry, Entry*& result);
+
+	template <typename F>
+	void rebuild(F&& keep);
+
+	void grow();
+
+	void free_below(Ids& ids, size_t index, std::atomic<size_t>& values);
+
+	static size_t pop_sent(IWire const& wire, std::deque<Retired>& retired);
+
+	void reclaim();
+
+	void delete_all();
+
+	void notify_published();
+
+public:
+	// region ctor/dtor
+
+	InternTable();
+
+	InternTable(InternTable const&) = delete;
+
+	InternTable& operator=(InternTable const&) = delete;
+
+	~InternTable();
+	// endregion
+
+	static size_t hash(InternedAny const& value);
+
+	/**
+	 * \brief Bounds own values handed out to two generations of [value] values each, 0 means unbounded. Has to be set
+	 * before anything's interned.
+	 */
+	void set_capacity(size_t value);
+
+	/**
+	 * \return entry of [value] with precomputed [hash] or nullptr
+	 */
+	Entry* find(InternedAny const& value, size_t hash) const;
+
+	/**
+	 * \brief Inserts [value] with a new own id in [Entry::State::PENDING] unless it's already there.
+	 * \param inserted set to true if the returned entry is inserted by this call
+	 */
+	Entry* find_or_insert(InternedAny const& value, size_t hash, bool& inserted);
+
+	/**
+	 * \brief Waits until the value of [entry] is sent by another thread.
+	 * \param inserted true if this thread inserted [entry]
+	 * \return true if this thread has to send the value, then [publish] or [fail] must follow
+	 */
+	bool claim(Entry* entry, bool inserted);
+
+	void publish(Entry* entry);
+
+	void fail(Entry* entry);
+
+	/**
+	 * \brief Starts a new generation if the current one is full, the previous one is retired.
+	 * \param wire messages with ids of the retired generation are sent by
+	 */
+	void rotate_if_full(IWire const& wire);
+
+	/**
+	 * \brief Maps [id] received from the other side to [value].
+	 */
+	void set_other(int32_t id, InternedAny value);
+
+	/**
+	 * \brief Frees the other side's ids below [id], they mustn't be read anymore.
+	 * \param wire messages with the ids are sent by
+	 */
+	void retire_other(int32_t id, IWire const& wire);
+
+	/**
+	 * \brief Frees own ids below [id], the other side doesn't send them anymore.
+	 */
+	void free_own(int32_t id);
+
+	/**
+	 * \brief Takes retired ids which aren't sent anymore.
+	 * \param retired set to the id below which own ids are to be announced retired, 0 if none
+	 * \param acknowledged set to the id below which the other side's ids are to be acknowledged, 0 if none
+	 * \return true if there's something to tell the other side
+	 */
+	bool take_sent(IWire const& wire, int32_t& retired, int32_t& acknowledged);
+
+	/**
+	 * \return value of an own (even) or other side's (odd) [id]
+	 */
+	InternedAny get(int32_t id) const;
+
+	Stats get_stats() const;
+
+	/**
+	 * \brief Removes all values, mustn't run concurrently with other calls.
+	 */
+	void clear();
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_INTERNTABLE_H
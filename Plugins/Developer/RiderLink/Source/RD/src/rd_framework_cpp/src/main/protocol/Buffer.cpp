@@ -2,8 +2,11 @@
 
 #include "protocol/Buffer.h"
 
+#include "protocol/Utf8.h"
+
 #include <string>
 #include <algorithm>
+#include <cstring>
 
 namespace rd
 {
@@ -19,6 +22,32 @@ Buffer::Buffer(ByteArray array, size_t offset) : data_(std::move(array)), offset
 {
 }
 
+Buffer::Buffer(std::shared_ptr<ByteArray const> slab, size_t begin, size_t size)
+	: slab_(std::move(slab)), view_(slab_->data() + begin), view_size_(size)
+{
+}
+
+void Buffer::detach()
+{
+	if (slab_ != nullptr)
+	{
+		data_.assign(view_, view_ + view_size_);
+		slab_.reset();
+		view_ = nullptr;
+		view_size_ = 0;
+	}
+}
+
+bool Buffer::is_view() const
+{
+	return slab_ != nullptr;
+}
+
+Buffer::word_t const* Buffer::const_data() const
+{
+	return slab_ != nullptr ? view_ : data_.data();
+}
+
 size_t Buffer::get_position() const
 {
 	return offset;
@@ -38,12 +67,18 @@ void Buffer::check_available(size_t moreSize) const
 	}
 }
 
+size_t Buffer::available() const
+{
+	return size() - offset;
+}
+
 void Buffer::read(word_t* dst, size_t size)
 {
 	if (size == 0)
 		return;
 	check_available(size);
-	std::copy(&data_[offset], &data_[offset] + size, dst);
+	word_t const* src = const_data() + offset;
+	std::copy(src, src + size, dst);
 	offset += size;
 }
 
@@ -58,7 +93,8 @@ void Buffer::write(const word_t* src, size_t size)
 
 void Buffer::require_available(size_t moreSize)
 {
-	if (offset + moreSize >= size())
+	detach();
+	if (offset + moreSize > size())
 	{
 		const size_t new_size = (std::max)(size() * 2, offset + moreSize);
 		data_.resize(new_size);
@@ -70,13 +106,140 @@ void Buffer::rewind()
 	set_position(0);
 }
 
+Buffer::Encoding Buffer::get_encoding() const
+{
+	return encoding;
+}
+
+void Buffer::set_encoding(Encoding value)
+{
+	encoding = value;
+}
+
+void Buffer::write_leb128(uint32_t value)
+{
+	word_t bytes[5];
+	size_t count = 0;
+	while (value >= 0x80)
+	{
+		bytes[count++] = static_cast<word_t>(value | 0x80);
+		value >>= 7;
+	}
+	bytes[count++] = static_cast<word_t>(value);
+	write(bytes, count);
+}
+
+uint32_t Buffer::read_leb128()
+{
+	uint32_t result = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		check_available(1);
+		const word_t byte = const_data()[offset++];
+		result |= static_cast<uint32_t>(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return result;
+		}
+	}
+	throw std::out_of_range("Malformed varint at position " + std::to_string(offset));
+}
+
+int32_t Buffer::read_length()
+{
+	if (encoding == Encoding::FIXED)
+	{
+		return read_integral<int32_t>();
+	}
+	return static_cast<int32_t>(read_leb128());
+}
+
+void Buffer::write_length(int32_t value)
+{
+	if (encoding == Encoding::FIXED)
+	{
+		write_integral<int32_t>(value);
+		return;
+	}
+	write_leb128(static_cast<uint32_t>(value));
+}
+
+int32_t Buffer::read_varint32()
+{
+	if (encoding == Encoding::FIXED)
+	{
+		return read_integral<int32_t>();
+	}
+	const uint32_t zigzag = read_leb128();
+	return static_cast<int32_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+}
+
+void Buffer::write_varint32(int32_t value)
+{
+	if (encoding == Encoding::FIXED)
+	{
+		write_integral<int32_t>(value);
+		return;
+	}
+	const uint32_t bits = static_cast<uint32_t>(value);
+	write_leb128((bits << 1) ^ (value < 0 ? 0xffffffffu : 0u));
+}
+
+size_t Buffer::reserve_length()
+{
+	const size_t position = offset;
+	if (encoding == Encoding::FIXED)
+	{
+		write_integral<int32_t>(0);
+	}
+	else
+	{
+		// most objects are shorter than 128 bytes, so a single byte is reserved
+		write_integral<word_t>(0);
+	}
+	return position;
+}
+
+void Buffer::write_length_at(size_t position)
+{
+	const size_t end = offset;
+	if (encoding == Encoding::FIXED)
+	{
+		const size_t start = position + sizeof(int32_t);
+		offset = position;
+		write_integral<int32_t>(static_cast<int32_t>(end - start));
+		offset = end;
+		return;
+	}
+	const size_t start = position + 1;
+	const size_t length = end - start;
+	size_t bytes = 1;
+	for (size_t rest = length >> 7; rest != 0; rest >>= 7)
+	{
+		++bytes;
+	}
+	if (bytes > 1)
+	{
+		require_available(bytes - 1);
+		std::copy_backward(&data_[start], &data_[start] + length, &data_[start] + length + bytes - 1);
+	}
+	offset = position;
+	write_leb128(static_cast<uint32_t>(length));
+	offset = end + bytes - 1;
+}
+
 Buffer::ByteArray Buffer::getArray() const&
 {
+	if (slab_ != nullptr)
+	{
+		return ByteArray(view_, view_ + view_size_);
+	}
 	return data_;
 }
 
 Buffer::ByteArray Buffer::getArray() &&
 {
+	detach();
 	rewind();
 	return std::move(data_);
 }
@@ -90,6 +253,7 @@ Buffer::ByteArray Buffer::getRealArray() const&
 
 Buffer::ByteArray Buffer::getRealArray() &&
 {
+	detach();
 	auto res = std::move(data_);
 	res.resize(offset);
 	rewind();
@@ -98,11 +262,12 @@ Buffer::ByteArray Buffer::getRealArray() &&
 
 Buffer::word_t const* Buffer::data() const
 {
-	return data_.data();
+	return const_data();
 }
 
 Buffer::word_t* Buffer::data()
 {
+	detach();
 	return data_.data();
 }
 
@@ -118,7 +283,7 @@ Buffer::word_t* Buffer::current_pointer()
 
 size_t Buffer::size() const
 {
-	return data_.size();
+	return slab_ != nullptr ? view_size_ : data_.size();
 }
 
 /*std::string Buffer::readString() const {
@@ -131,41 +296,78 @@ std::vector<uint8_t> v(value.begin(), value.end());
 writeArray<uint8_t>(v);
 }*/
 
-template <int>
-std::wstring read_wstring_spec(Buffer& buffer)
+template <typename C>
+size_t Buffer::read_string(size_t length, C* dst)
 {
-	auto v = buffer.read_array<std::vector, uint16_t>();
-	return std::wstring(v.begin(), v.end());
+	word_t const* src = const_data() + offset;
+	if (encoding == Encoding::FIXED)
+	{
+		offset += sizeof(uint16_t) * length;
+		if (sizeof(C) == sizeof(uint16_t))
+		{
+			std::copy(src, src + sizeof(uint16_t) * length, reinterpret_cast<word_t*>(dst));
+			return length;
+		}
+		for (size_t i = 0; i < length; ++i)
+		{
+			uint16_t unit;
+			std::memcpy(&unit, src + sizeof(uint16_t) * i, sizeof(uint16_t));
+			dst[i] = static_cast<C>(unit);
+		}
+		return length;
+	}
+	offset += length;
+	return utf8::decode(src, length, dst);
 }
 
-template <>
-std::wstring read_wstring_spec<2>(Buffer& buffer)
+template <typename C>
+void Buffer::write_string(C const* src, size_t count)
 {
-	const int32_t len = buffer.read_integral<int32_t>();
-	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
-	std::wstring result;
-	result.resize(len);
-	buffer.read(reinterpret_cast<Buffer::word_t*>(&result[0]), sizeof(wchar_t) * len);
-	return result;
+	if (encoding == Encoding::FIXED)
+	{
+		write_length(static_cast<int32_t>(count));
+		if (sizeof(C) == sizeof(uint16_t))
+		{
+			write(reinterpret_cast<word_t const*>(src), sizeof(uint16_t) * count);
+			return;
+		}
+		require_available(sizeof(uint16_t) * count);
+		word_t* dst = data_.data() + offset;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint16_t unit = static_cast<uint16_t>(src[i]);
+			std::memcpy(dst + sizeof(uint16_t) * i, &unit, sizeof(uint16_t));
+		}
+		offset += sizeof(uint16_t) * count;
+		return;
+	}
+	const size_t bytes = utf8::length(src, count);
+	write_length(static_cast<int32_t>(bytes));
+	require_available(bytes);
+	utf8::encode(src, count, data_.data() + offset);
+	offset += bytes;
 }
 
-std::wstring Buffer::read_wstring()
+size_t Buffer::read_string_length()
 {
-	return read_wstring_spec<sizeof(wchar_t)>(*this);
+	const int32_t len = read_length();
+	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
+	check_available(encoding == Encoding::FIXED ? sizeof(uint16_t) * len : static_cast<size_t>(len));
+	return static_cast<size_t>(len);
 }
 
-template <int>
-void write_wstring_spec(Buffer& buffer, wstring_view value)
+size_t Buffer::read_string_units(size_t length, uint16_t* dst)
 {
-	const std::vector<uint16_t> v(value.begin(), value.end());
-	buffer.write_array<std::vector, uint16_t>(v);
+	return read_string(length, dst);
 }
 
-template <>
-void write_wstring_spec<2>(Buffer& buffer, wstring_view value)
+std::wstring Buffer::read_wstring()
 {
-	buffer.write_integral<int32_t>(static_cast<int32_t>(value.size()));
-	buffer.write(reinterpret_cast<Buffer::word_t const*>(value.data()), sizeof(wchar_t) * value.size());
+	const size_t length = read_string_length();
+	std::wstring result;
+	result.resize(length);
+	result.resize(read_string(length, &result[0]));
+	return result;
 }
 
 void Buffer::write_wstring(std::wstring const& value)
@@ -175,23 +377,20 @@ void Buffer::write_wstring(std::wstring const& value)
 
 void Buffer::write_char16_string(const uint16_t* data, size_t len)
 {
-	write_integral<int32_t>(static_cast<int32_t>(len));
-	write(reinterpret_cast<word_t const*>(data), sizeof(uint16_t) * len);
+	write_string(data, len);
 }
 
 uint16_t* Buffer::read_char16_string()
-{	
-	const int32_t len = read_integral<int32_t>();
-	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
-	uint16_t * result = new uint16_t[len+1];
-	read(reinterpret_cast<Buffer::word_t*>(&result[0]), sizeof(uint16_t) * len);
-	result[len] = 0;
+{
+	const size_t length = read_string_length();
+	uint16_t* result = new uint16_t[length + 1];
+	result[read_string(length, result)] = 0;
 	return result;
 }
 
 void Buffer::write_wstring(wstring_view value)
 {
-	write_wstring_spec<sizeof(wchar_t)>(*this, value);
+	write_string(value.data(), value.size());
 }
 
 void Buffer::write_wstring(Wrapper<std::wstring> const& value)
@@ -239,7 +438,7 @@ void Buffer::write_char(wchar_t value)
 
 void Buffer::read_byte_array(ByteArray& array)
 {
-	const int32_t length = read_integral<int32_t>();
+	const int32_t length = read_length();
 	array.resize(length);
 	read_byte_array_raw(array);
 }
@@ -256,6 +455,7 @@ void Buffer::write_byte_array_raw(const ByteArray& array)
 
 Buffer::ByteArray& Buffer::get_data()
 {
+	detach();
 	return data_;
 }
 }	 // namespace rd
@@ -11,6 +11,7 @@
 #include "types/wrapper.h"
 #include "std/allocator.h"
 #include "std/list.h"
+#include "protocol/BufferPool.h"
 
 #include <vector>
 #include <type_traits>
@@ -31,21 +32,56 @@ public:
 
 	using word_t = uint8_t;
 
-	using Allocator = std::allocator<word_t>;
+	using Allocator = PooledAllocator<word_t>;
 
 	using ByteArray = std::vector<word_t, Allocator>;
 
-private:
-	template <int>
-	friend std::wstring read_wstring_spec(Buffer&);
-
-	template <int>
-	friend void write_wstring_spec(Buffer&, wstring_view);
+	/**
+	 * \brief How lengths, enums, tags and strings are written. [COMPACT] writes integers as LEB128 varints, signed ones
+	 * zigzag encoded first, and strings as UTF-8 instead of UTF-16. Both sides of a wire have to use the same encoding.
+	 */
+	enum class Encoding : uint8_t
+	{
+		FIXED,
+		COMPACT
+	};
 
+private:
 	ByteArray data_;
 
 	size_t offset = 0;
 
+	/**
+	 * \brief Shared storage this buffer is a read-only view of, [data_] isn't used while it's set.
+	 */
+	std::shared_ptr<ByteArray const> slab_;
+
+	word_t const* view_ = nullptr;
+
+	size_t view_size_ = 0;
+
+	Encoding encoding = Encoding::FIXED;
+
+	void write_leb128(uint32_t value);
+
+	uint32_t read_leb128();
+
+	// reads the length of a string and checks it's available, returns max number of code units it decodes to
+	size_t read_string_length();
+
+	size_t read_string_units(size_t length, uint16_t* dst);
+
+	template <typename C>
+	size_t read_string(size_t length, C* dst);
+
+	template <typename C>
+	void write_string(C const* src, size_t count);
+
+	// copies viewed bytes into own storage before any modification
+	void detach();
+
+	word_t const* const_data() const;
+
 	// read
 	void read(word_t* dst, size_t size);
 
@@ -63,6 +99,12 @@ public:
 
 	explicit Buffer(ByteArray array, size_t offset = 0);
 
+	/**
+	 * \brief Creates a read-only view of [size] bytes of [slab] starting at [begin]. Data is copied only if the buffer
+	 * gets modified.
+	 */
+	Buffer(std::shared_ptr<ByteArray const> slab, size_t begin, size_t size);
+
 	Buffer(Buffer const&) = delete;
 
 	Buffer& operator=(Buffer const&) = delete;
@@ -81,8 +123,45 @@ public:
 
 	void check_available(size_t moreSize) const;
 
+	/**
+	 * \return number of bytes after the position, a received message ends exactly at the end
+	 */
+	size_t available() const;
+
 	void rewind();
 
+	bool is_view() const;
+
+	Encoding get_encoding() const;
+
+	void set_encoding(Encoding value);
+
+	/**
+	 * \brief Length of an array or a string, a plain int32_t in [Encoding::FIXED].
+	 */
+	int32_t read_length();
+
+	void write_length(int32_t value);
+
+	/**
+	 * \brief Enum value or a tag, a plain int32_t in [Encoding::FIXED].
+	 */
+	int32_t read_varint32();
+
+	void write_varint32(int32_t value);
+
+	/**
+	 * \brief Reserves place for the length of data written next, [write_length_at] fills it in.
+	 * \return position to pass to [write_length_at]
+	 */
+	size_t reserve_length();
+
+	/**
+	 * \brief Writes the length of data written since [reserve_length] returned [position]. A compact length which
+	 * doesn't fit the reserved byte shifts the data.
+	 */
+	void write_length_at(size_t position);
+
 	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value, T>>
 	T read_integral()
 	{
@@ -115,7 +194,7 @@ public:
 		typename = typename std::enable_if_t<util::is_pod_v<T>>>
 	C<T, A> read_array()
 	{
-		int32_t len = read_integral<int32_t>();
+		int32_t len = read_length();
 		RD_ASSERT_MSG(len >= 0, "read null array(length = " + std::to_string(len) + ")");
 		C<T, A> result;
 		using rd::resize;
@@ -130,7 +209,7 @@ public:
 	template <template <class, class> class C, typename T, typename A = allocator<value_or_wrapper<T>>>
 	C<value_or_wrapper<T>, A> read_array(std::function<value_or_wrapper<T>()> reader)
 	{
-		int32_t len = read_integral<int32_t>();
+		int32_t len = read_length();
 		C<value_or_wrapper<T>, A> result;
 		using rd::resize;
 		resize(result, len);
@@ -147,7 +226,7 @@ public:
 	{
 		using rd::size;
 		const int32_t& len = rd::size(container);
-		write_integral<int32_t>(static_cast<int32_t>(len));
+		write_length(len);
 		if (len > 0)
 		{
 			write(reinterpret_cast<word_t const*>(&container[0]), sizeof(T) * len);
@@ -159,7 +238,7 @@ public:
 	void write_array(C<T, A> const& container, std::function<void(T const&)> writer)
 	{
 		using rd::size;
-		write_integral<int32_t>(size(container));
+		write_length(static_cast<int32_t>(size(container)));
 		for (auto const& e : container)
 		{
 			writer(e);
@@ -170,7 +249,7 @@ public:
 	void write_array(C<Wrapper<T>, A> const& container, std::function<void(T const&)> writer)
 	{
 		using rd::size;
-		write_integral<int32_t>(size(container));
+		write_length(static_cast<int32_t>(size(container)));
 		for (auto const& e : container)
 		{
 			writer(*e);
@@ -199,6 +278,18 @@ public:
 
 	uint16_t * read_char16_string();
 
+	/**
+	 * \brief Reads a string straight into storage returned by [allocate], which is called once with the max number of
+	 * UTF-16 units the string takes.
+	 * \return number of units read
+	 */
+	template <typename F>
+	size_t read_char16_string(F&& allocate)
+	{
+		const size_t length = read_string_length();
+		return read_string_units(length, allocate(length));
+	}
+
 	std::wstring read_wstring();
 
 	void write_wstring(std::wstring const& value);
@@ -214,27 +305,27 @@ public:
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	T read_enum()
 	{
-		int32_t x = read_integral<int32_t>();
+		int32_t x = read_varint32();
 		return static_cast<T>(x);
 	}
 
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	void write_enum(T const& x)
 	{
-		write_integral<int32_t>(static_cast<int32_t>(x));
+		write_varint32(static_cast<int32_t>(x));
 	}
 
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	T read_enum_set()
 	{
-		int32_t x = read_integral<int32_t>();
+		int32_t x = read_varint32();
 		return static_cast<T>(x);
 	}
 
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	void write_enum_set(T const& x)
 	{
-		write_integral<int32_t>(static_cast<int32_t>(x));
+		write_varint32(static_cast<int32_t>(x));
 	}
 
 	template <typename T, typename F, typename = typename std::enable_if_t<util::is_same_v<typename util::result_of_t<F()>, T>>>
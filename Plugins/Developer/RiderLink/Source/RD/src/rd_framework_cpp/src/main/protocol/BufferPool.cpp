@@ -0,0 +1,93 @@
+#include "protocol/BufferPool.h"
+
+namespace rd
+{
+constexpr size_t BufferPool::MIN_BLOCK_SHIFT;
+constexpr size_t BufferPool::MAX_BLOCK_SHIFT;
+constexpr size_t BufferPool::CLASS_COUNT;
+constexpr size_t BufferPool::MAX_CACHED_BYTES_PER_CLASS;
+
+size_t BufferPool::class_of(size_t size)
+{
+	size_t shift = MIN_BLOCK_SHIFT;
+	while ((static_cast<size_t>(1) << shift) < size)
+	{
+		++shift;
+	}
+	return shift - MIN_BLOCK_SHIFT;
+}
+
+void* BufferPool::allocate(size_t size)
+{
+	if (size > (static_cast<size_t>(1) << MAX_BLOCK_SHIFT))
+	{
+		++misses;
+		return ::operator new(size);
+	}
+	const size_t index = class_of(size);
+	const size_t block_size = static_cast<size_t>(1) << (index + MIN_BLOCK_SHIFT);
+	{
+		SizeClass& c = classes[index];
+		std::lock_guard<decltype(c.lock)> guard(c.lock);
+		if (!c.free.empty())
+		{
+			void* res = c.free.back();
+			c.free.pop_back();
+			cached_bytes -= block_size;
+			++hits;
+			return res;
+		}
+	}
+	++misses;
+	return ::operator new(block_size);
+}
+
+void BufferPool::deallocate(void* p, size_t size) noexcept
+{
+	if (p == nullptr)
+	{
+		return;
+	}
+	if (size > (static_cast<size_t>(1) << MAX_BLOCK_SHIFT))
+	{
+		::operator delete(p);
+		return;
+	}
+	const size_t index = class_of(size);
+	const size_t block_size = static_cast<size_t>(1) << (index + MIN_BLOCK_SHIFT);
+	{
+		SizeClass& c = classes[index];
+		std::lock_guard<decltype(c.lock)> guard(c.lock);
+		if (c.free.size() * block_size < MAX_CACHED_BYTES_PER_CLASS)
+		{
+			try
+			{
+				c.free.push_back(p);
+				cached_bytes += block_size;
+				return;
+			}
+			catch (std::bad_alloc const&)
+			{
+			}
+		}
+	}
+	::operator delete(p);
+}
+
+BufferPool::Stats BufferPool::get_stats() const
+{
+	return Stats{hits.load(), misses.load(), cached_bytes.load()};
+}
+
+void BufferPool::reset_stats()
+{
+	hits = 0;
+	misses = 0;
+}
+
+BufferPool& BufferPool::Instance()
+{
+	static BufferPool* instance = new BufferPool();
+	return *instance;
+}
+}	 // namespace rd
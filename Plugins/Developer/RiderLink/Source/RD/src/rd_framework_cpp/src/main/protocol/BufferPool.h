@@ -0,0 +1,138 @@
+#ifndef RD_CPP_BUFFERPOOL_H
+#define RD_CPP_BUFFERPOOL_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Thread-safe size-class arena for byte storage of [Buffer]s. Freed blocks are kept in per-class free lists
+ * and handed out again, so steady state serialization doesn't hit the heap.
+ */
+class RD_FRAMEWORK_API BufferPool
+{
+public:
+	static constexpr size_t MIN_BLOCK_SHIFT = 6;	// 64 bytes
+	static constexpr size_t MAX_BLOCK_SHIFT = 20;	// 1 MiB
+	static constexpr size_t CLASS_COUNT = MAX_BLOCK_SHIFT - MIN_BLOCK_SHIFT + 1;
+
+	/**
+	 * \brief Upper bound of memory kept in the free list of every size class.
+	 */
+	static constexpr size_t MAX_CACHED_BYTES_PER_CLASS = 4 * 1024 * 1024;
+
+	struct Stats
+	{
+		/**
+		 * \brief Allocations served from a free list.
+		 */
+		uint64_t hits;
+
+		/**
+		 * \brief Allocations which went to the heap, including oversized ones.
+		 */
+		uint64_t misses;
+
+		/**
+		 * \brief Bytes currently kept in free lists.
+		 */
+		uint64_t cached_bytes;
+	};
+
+private:
+	struct SizeClass
+	{
+		std::mutex lock;
+		std::vector<void*> free;
+	};
+
+	std::array<SizeClass, CLASS_COUNT> classes;
+
+	std::atomic<uint64_t> hits{0};
+	std::atomic<uint64_t> misses{0};
+	std::atomic<uint64_t> cached_bytes{0};
+
+	static size_t class_of(size_t size);
+
+	BufferPool() = default;
+
+public:
+	// region ctor/dtor
+
+	BufferPool(BufferPool const&) = delete;
+
+	BufferPool& operator=(BufferPool const&) = delete;
+	// endregion
+
+	void* allocate(size_t size);
+
+	void deallocate(void* p, size_t size) noexcept;
+
+	Stats get_stats() const;
+
+	void reset_stats();
+
+	/**
+	 * \brief Process-wide pool. It is never destroyed, so blocks may be released during static destruction.
+	 */
+	static BufferPool& Instance();
+};
+
+/**
+ * \brief Stateless allocator drawing from [BufferPool::Instance].
+ */
+template <typename T>
+class PooledAllocator
+{
+public:
+	using value_type = T;
+
+	PooledAllocator() = default;
+
+	template <typename U>
+	PooledAllocator(PooledAllocator<U> const&) noexcept
+	{
+	}
+
+	T* allocate(size_t n)
+	{
+		return static_cast<T*>(BufferPool::Instance().allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, size_t n) noexcept
+	{
+		BufferPool::Instance().deallocate(p, n * sizeof(T));
+	}
+
+	template <typename U>
+	friend bool operator==(PooledAllocator const&, PooledAllocator<U> const&) noexcept
+	{
+		return true;
+	}
+
+	template <typename U>
+	friend bool operator!=(PooledAllocator const&, PooledAllocator<U> const&) noexcept
+	{
+		return false;
+	}
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+
+#endif	  // RD_CPP_BUFFERPOOL_H
@@ -7,6 +7,46 @@ namespace rd
 std::shared_ptr<spdlog::logger> MessageBroker::logger =
 	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logger", spdlog::color_mode::automatic);
 
+constexpr size_t SubscriptionTable::SHARDS;
+
+SubscriptionTable::Shard& SubscriptionTable::shard(RdId const& id)
+{
+	auto const hash = static_cast<uint64_t>(id.get_hash());
+	return shards[((hash ^ (hash >> 29)) * 0xbf58476d1ce4e5b9ULL) >> 60];
+}
+
+SubscriptionTable::Shard const& SubscriptionTable::shard(RdId const& id) const
+{
+	return const_cast<SubscriptionTable*>(this)->shard(id);
+}
+
+IRdReactive const* SubscriptionTable::find(RdId const& id) const
+{
+	auto const& s = shard(id);
+	std::shared_lock<decltype(s.lock)> guard(s.lock);
+	auto const* subscription = s.subscriptions.find(id);
+	return subscription != nullptr ? *subscription : nullptr;
+}
+
+bool SubscriptionTable::contains(RdId const& id) const
+{
+	return find(id) != nullptr;
+}
+
+void SubscriptionTable::insert(RdId const& id, IRdReactive const* entity)
+{
+	auto& s = shard(id);
+	std::unique_lock<decltype(s.lock)> guard(s.lock);
+	s.subscriptions[id] = entity;
+}
+
+void SubscriptionTable::erase(RdId const& id)
+{
+	auto& s = shard(id);
+	std::unique_lock<decltype(s.lock)> guard(s.lock);
+	s.subscriptions.erase(id);
+}
+
 static void execute(const IRdReactive* that, Buffer msg)
 {
 	msg.read_integral<int16_t>();	   // skip context
@@ -22,12 +62,7 @@ void MessageBroker::invoke(const IRdReactive* that, Buffer msg, bool sync) const
 	else
 	{
 		auto action = [this, that, message = std::move(msg)]() mutable {
-			bool exists_id = false;
-			{
-				std::lock_guard<decltype(lock)> guard(lock);
-				exists_id = subscriptions.count(that->get_id()) > 0;
-			}
-			if (exists_id)
+			if (subscriptions.contains(that->get_id()))
 			{
 				execute(that, std::move(message));
 			}
@@ -37,7 +72,7 @@ void MessageBroker::invoke(const IRdReactive* that, Buffer msg, bool sync) const
 			}
 		};
 		std::function<void()> function = util::make_shared_function(std::move(action));
-		that->get_wire_scheduler()->queue(std::move(function));
+		that->get_wire_scheduler()->queue_ordered(that->get_id().get_hash(), std::move(function));
 	}
 }
 
@@ -45,62 +80,95 @@ MessageBroker::MessageBroker(IScheduler* defaultScheduler) : default_scheduler(d
 {
 }
 
+void MessageBroker::schedule_drain(RdId id) const
+{
+	default_scheduler->queue([this, id] { drain(id); });
+}
+
+void MessageBroker::drain(RdId id) const
+{
+	std::queue<Buffer> messages;
+	IRdReactive const* subscription = nullptr;
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		Mq* mq = broker.find(id);
+		if (mq == nullptr)
+		{
+			return;
+		}
+		messages.swap(mq->default_scheduler_messages);
+		subscription = subscriptions.find(id);
+		if (subscription == nullptr)
+		{
+			broker.erase(id);
+		}
+	}
+	if (subscription == nullptr)
+	{
+		logger->trace("No handler for id: {}, {} messages dropped", to_string(id), messages.size());
+		return;
+	}
+
+	const bool sync = subscription->get_wire_scheduler() == default_scheduler;
+	for (; !messages.empty(); messages.pop())
+	{
+		if (!subscriptions.contains(id))
+		{
+			logger->trace("Disappeared Handler for Reactive entities with id: {}", to_string(id));
+			break;
+		}
+		invoke(subscription, std::move(messages.front()), sync);
+	}
+
+	std::lock_guard<decltype(lock)> guard(lock);
+	Mq* mq = broker.find(id);
+	if (!mq->default_scheduler_messages.empty())
+	{
+		// unsubscribed while draining, messages received since then are handled by the next drain
+		schedule_drain(id);
+		return;
+	}
+	// messages received for a custom scheduler while draining follow the drained ones
+	for (auto& message : mq->custom_scheduler_messages)
+	{
+		RD_ASSERT_MSG(!sync, "require equals of wire and default schedulers")
+		invoke(subscription, std::move(message));
+	}
+	broker.erase(id);
+}
+
 void MessageBroker::dispatch(RdId id, Buffer message) const
 {
-	RD_ASSERT_MSG(!id.isNull(), "id mustn't be null")
+	if (id.isNull())
+	{
+		// no entity has the null id, a message for it is malformed
+		logger->error("message for null id is dropped");
+		return;
+	}
+
+	{
+		// fast path: subscribed entities whose messages can't be queued behind ones received before the subscription
+		IRdReactive const* s = subscriptions.find(id);
+		if (s != nullptr && (s->get_wire_scheduler() == default_scheduler || s->get_wire_scheduler()->out_of_order_execution))
+		{
+			invoke(s, std::move(message));
+			return;
+		}
+	}
 
 	{	 // synchronized recursively
 		std::lock_guard<decltype(lock)> guard(lock);
-		IRdReactive const* s = subscriptions[id];
+		// subscriptions only change under [lock], so this one is final while it's held
+		IRdReactive const* s = subscriptions.find(id);
 		if (s == nullptr)
 		{
-			auto it = broker.find(id);
-			if (it == broker.end())
+			auto inserted = broker.try_emplace(id);
+			inserted.first->default_scheduler_messages.emplace(std::move(message));
+			if (inserted.second)
 			{
-				it = broker.emplace(id, Mq{}).first;
+				// one drain per queue delivers everything accumulated until it runs
+				schedule_drain(id);
 			}
-
-			broker[id].default_scheduler_messages.emplace(std::move(message));
-
-			auto action = [this, it, id]() mutable {
-				auto& current = it->second;
-				IRdReactive const* subscription = subscriptions[id];
-
-				optional<Buffer> message;
-				{
-					std::lock_guard<decltype(lock)> guard(lock);
-					if (!current.default_scheduler_messages.empty())
-					{
-						message = make_optional<Buffer>(std::move(current.default_scheduler_messages.front()));
-						current.default_scheduler_messages.pop();
-					}
-				}
-				if (subscription != nullptr)
-				{
-					if (message)
-					{
-						invoke(subscription, *std::move(message), subscription->get_wire_scheduler() == default_scheduler);
-					}
-				}
-				else
-				{
-					logger->trace("No handler for id: {}", to_string(id));
-				}
-
-				if (current.default_scheduler_messages.empty())
-				{
-					auto t = std::move(broker[id]);
-					broker.erase(id);
-					for (auto& it : t.custom_scheduler_messages)
-					{
-						RD_ASSERT_MSG(subscription->get_wire_scheduler() != default_scheduler,
-							"require equals of wire and default schedulers")
-						invoke(subscription, std::move(it));
-					}
-				}
-			};
-			std::function<void()> function = util::make_shared_function(std::move(action));
-			default_scheduler->queue(std::move(function));
 		}
 		else
 		{
@@ -110,15 +178,14 @@ void MessageBroker::dispatch(RdId id, Buffer message) const
 			}
 			else
 			{
-				auto it = broker.find(id);
-				if (it == broker.end())
+				Mq* mq = broker.find(id);
+				if (mq == nullptr)
 				{
 					invoke(s, std::move(message));
 				}
 				else
 				{
-					Mq& mq = it->second;
-					mq.custom_scheduler_messages.push_back(std::move(message));
+					mq->custom_scheduler_messages.push_back(std::move(message));
 				}
 			}
 		}
@@ -127,6 +194,11 @@ void MessageBroker::dispatch(RdId id, Buffer message) const
 	//        }
 }
 
+bool MessageBroker::is_subscribed(RdId const& id) const
+{
+	return subscriptions.contains(id);
+}
+
 void MessageBroker::advise_on(Lifetime lifetime, IRdReactive const* entity) const
 {
 	RD_ASSERT_MSG(!entity->get_id().isNull(), ("id is null for entities: " + std::string(typeid(*entity).name())))
@@ -139,8 +211,11 @@ void MessageBroker::advise_on(Lifetime lifetime, IRdReactive const* entity) cons
 	{
 		auto key = entity->get_id();
 		IRdReactive const* value = entity;
-		subscriptions[key] = value;
-		lifetime->add_action([this, key]() { subscriptions.erase(key); });
+		subscriptions.insert(key, value);
+		lifetime->add_action([this, key]() {
+			std::lock_guard<decltype(lock)> guard(lock);
+			subscriptions.erase(key);
+		});
 	}
 }
 }	 // namespace rd
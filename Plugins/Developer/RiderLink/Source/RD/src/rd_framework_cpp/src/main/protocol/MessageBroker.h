@@ -8,11 +8,13 @@
 
 #include "base/IRdReactive.h"
 
-#include "std/unordered_map.h"
+#include "util/rdid_map.h"
 
 #include "spdlog/spdlog.h"
 
+#include <array>
 #include <queue>
+#include <shared_mutex>
 
 #include <rd_framework_export.h>
 
@@ -38,12 +40,45 @@ public:
 	std::vector<Buffer> custom_scheduler_messages;
 };
 
+/**
+ * \brief Subscriptions sharded by id. Lookups only share the lock of their shard, so receiving threads neither contend
+ * with each other nor wait for [MessageBroker::advise_on] of entities in other shards.
+ */
+class RD_FRAMEWORK_API SubscriptionTable
+{
+	static constexpr size_t SHARDS = 16;
+
+	struct Shard
+	{
+		mutable std::shared_timed_mutex lock;
+		util::rdid_map<IRdReactive const*> subscriptions;
+	};
+
+	std::array<Shard, SHARDS> shards;
+
+	Shard& shard(RdId const& id);
+
+	Shard const& shard(RdId const& id) const;
+
+public:
+	/**
+	 * \return subscription of [id] or nullptr, a missing id is not inserted
+	 */
+	IRdReactive const* find(RdId const& id) const;
+
+	bool contains(RdId const& id) const;
+
+	void insert(RdId const& id, IRdReactive const* entity);
+
+	void erase(RdId const& id);
+};
+
 class RD_FRAMEWORK_API MessageBroker final
 {
 private:
 	IScheduler* default_scheduler = nullptr;
-	mutable rd::unordered_map<RdId, IRdReactive const*> subscriptions;
-	mutable rd::unordered_map<RdId, Mq> broker;
+	mutable SubscriptionTable subscriptions;
+	mutable util::rdid_map<Mq> broker;
 
 	mutable std::recursive_mutex lock;
 
@@ -51,6 +86,13 @@ private:
 
 	void invoke(const IRdReactive* that, Buffer msg, bool sync = false) const;
 
+	void schedule_drain(RdId id) const;
+
+	/**
+	 * \brief Delivers all messages queued for [id] before it was subscribed, in order.
+	 */
+	void drain(RdId id) const;
+
 public:
 	// region ctor/dtor
 
@@ -59,6 +101,11 @@ public:
 
 	void dispatch(RdId id, Buffer message) const;
 
+	/**
+	 * \brief Whether an entity is bound to [id], messages for other ids wait until one is or are dropped.
+	 */
+	bool is_subscribed(RdId const& id) const;
+
 	void advise_on(Lifetime lifetime, IRdReactive const* entity) const;
 };
 }	 // namespace rd
@@ -39,6 +39,21 @@ Protocol::Protocol(Identities::IdKind kind, IScheduler* scheduler, std::shared_p
 
 Protocol::~Protocol() = default;
 
+void Protocol::set_encoding(Buffer::Encoding value) const
+{
+	wire->set_encoding(value);
+}
+
+void Protocol::set_intern_capacity(size_t value) const
+{
+	internRoot->set_capacity(value);
+}
+
+InternTable::Stats Protocol::get_intern_stats() const
+{
+	return internRoot->get_stats();
+}
+
 SerializationCtx& Protocol::get_serialization_context() const
 {
 	if (!context)
@@ -8,6 +8,7 @@
 
 #include "base/IProtocol.h"
 #include "protocol/Identities.h"
+#include "intern/InternTable.h"
 #include "serialization/SerializationCtx.h"
 
 #include <memory>
@@ -28,8 +29,13 @@ class InternRoot;
  */
 class RD_FRAMEWORK_API Protocol : /*IRdDynamic, */ public IProtocol
 {
+public:
+	/**
+	 * \brief Name the intern root of a protocol is bound under, so its id is the same in every protocol.
+	 */
 	constexpr static string_view InternRootName{"ProtocolInternRoot"};
 
+private:
 	Lifetime lifetime;
 
 	mutable std::unique_ptr<SerializationCtx> context;
@@ -56,6 +62,19 @@ public:
 
 	SerializationCtx& get_serialization_context() const override;
 
+	/**
+	 * \brief Makes the wire of this protocol send lengths, enums and tags compactly. There's no handshake for it, the
+	 * counterpart has to be configured with the same encoding before the wire connects.
+	 */
+	void set_encoding(Buffer::Encoding value) const;
+
+	/**
+	 * \brief Bounds values interned by the protocol, see [InternRoot::set_capacity]. The counterpart has to evict too.
+	 */
+	void set_intern_capacity(size_t value) const;
+
+	InternTable::Stats get_intern_stats() const;
+
 	static std::shared_ptr<spdlog::logger> initializationLogger;
 };
 }	 // namespace rd
@@ -0,0 +1,245 @@
+#ifndef RD_CPP_UTF8_H
+#define RD_CPP_UTF8_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RD_UTF8_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace rd
+{
+/**
+ * \brief Transcoding of UTF-16 (or UTF-32 for 4-byte wchar_t) strings to UTF-8 and back. Runs of ASCII are converted
+ * 16 bytes at a time where SSE2 is available. Unpaired surrogates are kept as 3-byte sequences, so any UTF-16 string
+ * survives a round trip, malformed UTF-8 is decoded to U+FFFD.
+ */
+namespace utf8
+{
+namespace detail
+{
+constexpr uint32_t REPLACEMENT = 0xfffd;
+
+inline size_t width(uint32_t c)
+{
+	return c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+}
+
+template <typename C>
+uint32_t next_code_point(C const* src, size_t count, size_t& i)
+{
+	const uint32_t c = static_cast<uint32_t>(src[i++]);
+	if (c >= 0xd800 && c < 0xdc00 && i < count)
+	{
+		const uint32_t low = static_cast<uint32_t>(src[i]);
+		if (low >= 0xdc00 && low < 0xe000)
+		{
+			++i;
+			return 0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00);
+		}
+	}
+	return c <= 0x10ffff ? c : REPLACEMENT;
+}
+
+template <typename C>
+size_t put_code_point(uint32_t c, C* dst)
+{
+	if (sizeof(C) == sizeof(uint16_t) && c >= 0x10000)
+	{
+		c -= 0x10000;
+		dst[0] = static_cast<C>(0xd800 + (c >> 10));
+		dst[1] = static_cast<C>(0xdc00 + (c & 0x3ff));
+		return 2;
+	}
+	dst[0] = static_cast<C>(c);
+	return 1;
+}
+
+// number of leading code units below 0x80
+template <typename C>
+size_t ascii_prefix(C const* src, size_t count)
+{
+	size_t i = 0;
+#if defined(RD_UTF8_SSE2)
+	if (sizeof(C) == sizeof(uint16_t))
+	{
+		const __m128i mask = _mm_set1_epi16(static_cast<short>(0xff80));
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m128i units = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(units, mask), _mm_setzero_si128())) != 0xffff)
+			{
+				break;
+			}
+		}
+	}
+#endif
+	while (i < count && static_cast<uint32_t>(src[i]) < 0x80)
+	{
+		++i;
+	}
+	return i;
+}
+
+// copies leading ASCII bytes widening them to code units, returns their number
+template <typename C>
+size_t copy_ascii(uint8_t const* src, size_t size, C* dst)
+{
+	size_t i = 0;
+#if defined(RD_UTF8_SSE2)
+	if (sizeof(C) == sizeof(uint16_t))
+	{
+		const __m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= size; i += 16)
+		{
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+			if (_mm_movemask_epi8(bytes) != 0)
+			{
+				break;
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(bytes, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(bytes, zero));
+		}
+	}
+#endif
+	for (; i < size && src[i] < 0x80; ++i)
+	{
+		dst[i] = static_cast<C>(src[i]);
+	}
+	return i;
+}
+}	 // namespace detail
+
+/**
+ * \return number of bytes [count] code units of [src] take in UTF-8
+ */
+template <typename C>
+size_t length(C const* src, size_t count)
+{
+	size_t i = detail::ascii_prefix(src, count);
+	size_t bytes = i;
+	while (i < count)
+	{
+		bytes += detail::width(detail::next_code_point(src, count, i));
+	}
+	return bytes;
+}
+
+/**
+ * \brief Writes [count] code units of [src] to [dst], which has room for [length] of them.
+ */
+template <typename C>
+void encode(C const* src, size_t count, uint8_t* dst)
+{
+	size_t i = 0;
+#if defined(RD_UTF8_SSE2)
+	if (sizeof(C) == sizeof(uint16_t))
+	{
+		const __m128i mask = _mm_set1_epi16(static_cast<short>(0xff80));
+		const __m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= count; i += 16)
+		{
+			const __m128i low = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+			const __m128i high = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i + 8));
+			const __m128i non_ascii = _mm_and_si128(_mm_or_si128(low, high), mask);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, zero)) != 0xffff)
+			{
+				break;
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(low, high));
+			dst += 16;
+		}
+	}
+#endif
+	while (i < count)
+	{
+		const uint32_t c = detail::next_code_point(src, count, i);
+		if (c < 0x80)
+		{
+			*dst++ = static_cast<uint8_t>(c);
+		}
+		else if (c < 0x800)
+		{
+			*dst++ = static_cast<uint8_t>(0xc0 | (c >> 6));
+			*dst++ = static_cast<uint8_t>(0x80 | (c & 0x3f));
+		}
+		else if (c < 0x10000)
+		{
+			*dst++ = static_cast<uint8_t>(0xe0 | (c >> 12));
+			*dst++ = static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3f));
+			*dst++ = static_cast<uint8_t>(0x80 | (c & 0x3f));
+		}
+		else
+		{
+			*dst++ = static_cast<uint8_t>(0xf0 | (c >> 18));
+			*dst++ = static_cast<uint8_t>(0x80 | ((c >> 12) & 0x3f));
+			*dst++ = static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3f));
+			*dst++ = static_cast<uint8_t>(0x80 | (c & 0x3f));
+		}
+	}
+}
+
+/**
+ * \brief Decodes [size] bytes of [src] into [dst], which has room for [size] code units.
+ * \return number of code units written
+ */
+template <typename C>
+size_t decode(uint8_t const* src, size_t size, C* dst)
+{
+	size_t i = 0;
+	size_t n = 0;
+	while (i < size)
+	{
+		const size_t ascii = detail::copy_ascii(src + i, size - i, dst + n);
+		i += ascii;
+		n += ascii;
+		if (i == size)
+		{
+			break;
+		}
+
+		const uint8_t lead = src[i];
+		size_t width = 0;
+		uint32_t c = 0;
+		if ((lead & 0xe0) == 0xc0)
+		{
+			width = 2;
+			c = lead & 0x1f;
+		}
+		else if ((lead & 0xf0) == 0xe0)
+		{
+			width = 3;
+			c = lead & 0x0f;
+		}
+		else if ((lead & 0xf8) == 0xf0)
+		{
+			width = 4;
+			c = lead & 0x07;
+		}
+		for (size_t k = 1; k < width; ++k)
+		{
+			if (i + k >= size || (src[i + k] & 0xc0) != 0x80)
+			{
+				width = 0;
+				break;
+			}
+			c = (c << 6) | (src[i + k] & 0x3f);
+		}
+		if (width == 0 || c > 0x10ffff)
+		{
+			// a byte of a malformed sequence decodes to a single replacement character
+			dst[n++] = static_cast<C>(detail::REPLACEMENT);
+			++i;
+			continue;
+		}
+		i += width;
+		n += detail::put_code_point(c, dst + n);
+	}
+	return n;
+}
+}	 // namespace utf8
+}	 // namespace rd
+
+#endif	  // RD_CPP_UTF8_H
@@ -0,0 +1,228 @@
+#include "WorkStealingScheduler.h"
+
+#include "util/core_util.h"
+#include <util/thread_util.h>
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+#include <algorithm>
+
+namespace rd
+{
+constexpr size_t WorkStealingScheduler::MAX_LANE_BATCH;
+
+namespace
+{
+thread_local WorkStealingScheduler const* current_scheduler = nullptr;
+thread_local size_t current_worker = 0;
+}	 // namespace
+
+WorkStealingScheduler::WorkStealingScheduler(Lifetime lifetime, std::string name, size_t threads)
+	: log(spdlog::stderr_color_mt<spdlog::synchronous_factory>(name, spdlog::color_mode::automatic))
+	, name(std::move(name))
+	, lifetime(lifetime)
+{
+	out_of_order_execution = true;
+
+	if (threads == 0)
+	{
+		threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+	}
+	for (size_t i = 0; i < threads; ++i)
+	{
+		workers.push_back(std::make_unique<Worker>());
+	}
+	for (size_t i = 0; i < threads; ++i)
+	{
+		workers[i]->thread = std::thread([this, i] {
+			rd::util::set_thread_name((this->name + "-" + std::to_string(i)).c_str());
+			run(i);
+		});
+	}
+	thread_id = workers.front()->thread.get_id();
+
+	lifetime->add_action([this] { stop(); });
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+	stop();
+}
+
+void WorkStealingScheduler::stop()
+{
+	{
+		std::lock_guard<decltype(idle_lock)> guard(idle_lock);
+		if (stopped)
+		{
+			return;
+		}
+		stopped = true;
+	}
+	idle_cv.notify_all();
+	for (auto& worker : workers)
+	{
+		if (worker->thread.get_id() == std::this_thread::get_id())
+		{
+			log->error("{}: stopped from its own worker, the worker is detached", name);
+			worker->thread.detach();
+		}
+		else if (worker->thread.joinable())
+		{
+			worker->thread.join();
+		}
+	}
+}
+
+void WorkStealingScheduler::push(std::function<void()> action)
+{
+	++pending;
+	const size_t index = current_scheduler == this ? current_worker : next_worker++ % workers.size();
+	{
+		std::lock_guard<decltype(Worker::lock)> guard(workers[index]->lock);
+		workers[index]->actions.push_back(std::move(action));
+	}
+	++queued;
+	{
+		// pairs with the predicate check of an idle worker, so the notification can't be missed
+		std::lock_guard<decltype(idle_lock)> guard(idle_lock);
+	}
+	idle_cv.notify_one();
+}
+
+bool WorkStealingScheduler::try_take(size_t index, std::function<void()>& action)
+{
+	{
+		Worker& own = *workers[index];
+		std::lock_guard<decltype(Worker::lock)> guard(own.lock);
+		if (!own.actions.empty())
+		{
+			action = std::move(own.actions.front());
+			own.actions.pop_front();
+			--queued;
+			return true;
+		}
+	}
+	for (size_t i = 1; i < workers.size(); ++i)
+	{
+		Worker& victim = *workers[(index + i) % workers.size()];
+		std::lock_guard<decltype(Worker::lock)> guard(victim.lock);
+		if (!victim.actions.empty())
+		{
+			// the owner takes from the front, steal from the back to contend less
+			action = std::move(victim.actions.back());
+			victim.actions.pop_back();
+			--queued;
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorkStealingScheduler::execute(std::function<void()> const& action) const
+{
+	try
+	{
+		action();
+	}
+	catch (std::exception const& e)
+	{
+		log->error("Background task failed, scheduler={}, thread_id={} | {}", name, current_worker, e.what());
+	}
+}
+
+void WorkStealingScheduler::run(size_t index)
+{
+	current_scheduler = this;
+	current_worker = index;
+
+	while (true)
+	{
+		std::function<void()> action;
+		if (try_take(index, action))
+		{
+			execute(action);
+			if (--pending == 0)
+			{
+				std::lock_guard<decltype(idle_lock)> guard(idle_lock);
+				flush_cv.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock<decltype(idle_lock)> guard(idle_lock);
+		idle_cv.wait(guard, [this] { return stopped || queued > 0; });
+		if (stopped && queued == 0)
+		{
+			break;
+		}
+	}
+}
+
+void WorkStealingScheduler::run_lane(int64_t key)
+{
+	for (size_t executed = 1;; ++executed)
+	{
+		std::function<void()> action;
+		{
+			std::lock_guard<decltype(lanes_lock)> guard(lanes_lock);
+			// the action stays in the lane while it's executed, so the lane isn't scheduled twice
+			action = std::move(lanes[key].front());
+		}
+		execute(action);
+		{
+			std::lock_guard<decltype(lanes_lock)> guard(lanes_lock);
+			auto it = lanes.find(key);
+			it->second.pop();
+			if (it->second.empty())
+			{
+				lanes.erase(it);
+				return;
+			}
+		}
+		if (executed == MAX_LANE_BATCH)
+		{
+			break;
+		}
+	}
+	push([this, key] { run_lane(key); });
+}
+
+void WorkStealingScheduler::queue(std::function<void()> action)
+{
+	push(std::move(action));
+}
+
+void WorkStealingScheduler::queue_ordered(int64_t key, std::function<void()> action)
+{
+	bool schedule;
+	{
+		std::lock_guard<decltype(lanes_lock)> guard(lanes_lock);
+		auto& lane = lanes[key];
+		lane.push(std::move(action));
+		schedule = lane.size() == 1;
+	}
+	if (schedule)
+	{
+		push([this, key] { run_lane(key); });
+	}
+}
+
+void WorkStealingScheduler::flush()
+{
+	RD_ASSERT_MSG(!is_active(), "Can't flush this scheduler in a reentrant way: we are inside queued item's execution");
+
+	std::unique_lock<decltype(idle_lock)> guard(idle_lock);
+	flush_cv.wait(guard, [this] { return pending == 0; });
+}
+
+bool WorkStealingScheduler::is_active() const
+{
+	return current_scheduler == this;
+}
+
+size_t WorkStealingScheduler::size() const
+{
+	return workers.size();
+}
+}	 // namespace rd
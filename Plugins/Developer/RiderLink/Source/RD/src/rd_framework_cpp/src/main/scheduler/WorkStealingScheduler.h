@@ -0,0 +1,119 @@
+#ifndef RD_CPP_WORKSTEALINGSCHEDULER_H
+#define RD_CPP_WORKSTEALINGSCHEDULER_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "scheduler/base/IScheduler.h"
+#include "lifetime/Lifetime.h"
+#include "std/unordered_map.h"
+#include "spdlog/spdlog.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Pool of threads, each with its own queue of actions. Actions queued from a worker go to its own queue,
+ * idle workers steal from the others. Actions are executed in parallel, [queue_ordered] keeps the order among
+ * actions of the same key, so handlers of one entity never run concurrently or out of order.
+ */
+class RD_FRAMEWORK_API WorkStealingScheduler : public IScheduler
+{
+public:
+	/**
+	 * \brief Actions of one key executed by a worker in a row before the rest of the key is requeued.
+	 */
+	static constexpr size_t MAX_LANE_BATCH = 64;
+
+private:
+	struct Worker
+	{
+		std::mutex lock;
+		std::deque<std::function<void()>> actions;
+		std::thread thread;
+	};
+
+	std::shared_ptr<spdlog::logger> log;
+	std::string name;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<size_t> next_worker{0};
+
+	/**
+	 * \brief Actions in worker queues which were not taken yet.
+	 */
+	std::atomic<size_t> queued{0};
+
+	/**
+	 * \brief Actions queued or executing, [flush] waits for it to reach zero.
+	 */
+	std::atomic<size_t> pending{0};
+
+	std::mutex idle_lock;
+	std::condition_variable idle_cv;
+	std::condition_variable flush_cv;
+	bool stopped = false;
+
+	std::mutex lanes_lock;
+	rd::unordered_map<int64_t, std::queue<std::function<void()>>> lanes;
+
+	void push(std::function<void()> action);
+
+	bool try_take(size_t index, std::function<void()>& action);
+
+	void execute(std::function<void()> const& action) const;
+
+	void run_lane(int64_t key);
+
+	void run(size_t index);
+
+	void stop();
+
+public:
+	Lifetime lifetime;
+
+	// region ctor/dtor
+
+	/**
+	 * \param threads number of workers, hardware concurrency if zero
+	 */
+	WorkStealingScheduler(Lifetime lifetime, std::string name, size_t threads = 0);
+
+	WorkStealingScheduler(WorkStealingScheduler const&) = delete;
+
+	WorkStealingScheduler& operator=(WorkStealingScheduler const&) = delete;
+
+	virtual ~WorkStealingScheduler();
+	// endregion
+
+	void queue(std::function<void()> action) override;
+
+	void queue_ordered(int64_t key, std::function<void()> action) override;
+
+	void flush() override;
+
+	/**
+	 * \brief true on any of the workers.
+	 */
+	bool is_active() const override;
+
+	size_t size() const;
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_WORKSTEALINGSCHEDULER_H
@@ -6,6 +6,7 @@
 #pragma warning(disable:4251)
 #endif
 
+#include <cstdint>
 #include <functional>
 #include <thread>
 
@@ -36,6 +37,15 @@ public:
 	 */
 	virtual void queue(std::function<void()> action) = 0;
 
+	/**
+	 * \brief Queues [action] after the actions queued earlier with the same [key]. Schedulers executing actions in
+	 * parallel keep the order only among actions of one key, others execute all of them in order anyway.
+	 *
+	 * \param key ordering lane, e.g. hash of the entity the action is addressed to
+	 * \param action to be queued.
+	 */
+	virtual void queue_ordered(int64_t key, std::function<void()> action);
+
 	// TO-DO
 	bool out_of_order_execution = false;
 
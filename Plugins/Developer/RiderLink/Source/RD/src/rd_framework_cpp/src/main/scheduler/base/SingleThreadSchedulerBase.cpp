@@ -17,12 +17,15 @@ void SingleThreadSchedulerBase::PoolTask::operator()(int id) const
 	try
 	{
 		f();
-		--scheduler->tasks_executing;
 	}
 	catch (std::exception const& e)
 	{
 		scheduler->log->error("Background task failed, scheduler={}, thread_id={} | {}", scheduler->name, id, e.what());
-		--scheduler->tasks_executing;
+	}
+	if (--scheduler->tasks_executing == 0)
+	{
+		std::lock_guard<decltype(scheduler->flush_lock)> guard(scheduler->flush_lock);
+		scheduler->flush_cv.notify_all();
 	}
 }
 
@@ -39,10 +42,8 @@ void SingleThreadSchedulerBase::flush()
 {
 	RD_ASSERT_MSG(!is_active(), "Can't flush this scheduler in a reentrant way: we are inside queued item's execution");
 
-	while (tasks_executing != 0)
-	{
-		std::this_thread::yield();
-	}
+	std::unique_lock<decltype(flush_lock)> guard(flush_lock);
+	flush_cv.wait(guard, [this] { return tasks_executing == 0; });
 }
 
 void SingleThreadSchedulerBase::queue(std::function<void()> action)
@@ -10,6 +10,8 @@
 #include "lifetime/Lifetime.h"
 #include "spdlog/spdlog.h"
 
+#include <condition_variable>
+#include <mutex>
 #include <utility>
 
 #include <rd_framework_export.h>
@@ -28,6 +30,8 @@ protected:
 	std::string name;
 
 	std::atomic_uint32_t tasks_executing{0};
+	std::mutex flush_lock;
+	std::condition_variable flush_cv;
 	std::atomic_uint32_t active{0};
 	std::unique_ptr<ctpl::thread_pool> pool;
 
@@ -1,14 +1,37 @@
 #include "serialization/ISerializable.h"
 
+#include "protocol/RdId.h"
 #include "std/hash.h"
+#include "util/hashing.h"
+
+#include <typeindex>
+#include <unordered_map>
 
 namespace rd
 {
+size_t ISerializable::serialized_size(SerializationCtx& /*ctx*/) const
+{
+	return 0;
+}
+
 size_t IPolymorphicSerializable::hashCode() const noexcept
 {
 	return rd::hash<void const*>()(static_cast<void const*>(this));
 }
 
+RdId IPolymorphicSerializable::type_id() const
+{
+	// the name is built at runtime, so its hash is cached by the dynamic type rather than computed for every value
+	thread_local std::unordered_map<std::type_index, RdId> ids;
+	const std::type_index type(typeid(*this));
+	auto it = ids.find(type);
+	if (it == ids.end())
+	{
+		it = ids.emplace(type, RdId(util::getPlatformIndependentHash(type_name()))).first;
+	}
+	return it->second;
+}
+
 bool operator==(const IPolymorphicSerializable& lhs, const IPolymorphicSerializable& rhs)
 {
 	return lhs.equals(rhs);
@@ -12,6 +12,8 @@ namespace rd
 class Buffer;
 
 class SerializationCtx;
+
+class RdId;
 // endregion
 
 /**
@@ -24,6 +26,11 @@ public:
 	virtual ~ISerializable() = default;
 
 	virtual void write(SerializationCtx& ctx, Buffer& buffer) const = 0;
+
+	/**
+	 * \return number of bytes [write] writes, 0 if it's unknown. See [SerializedSize].
+	 */
+	virtual size_t serialized_size(SerializationCtx& ctx) const;
 };
 
 /**
@@ -38,6 +45,12 @@ public:
 	virtual std::string type_name()
 		const = 0 /*{ throw std::invalid_argument("type doesn't support polymorphic serialization"); }*/;
 
+	/**
+	 * \return id written before the value in polymorphic serialization, the hash of [type_name] cached per dynamic
+	 * type unless overridden.
+	 */
+	virtual RdId type_id() const;
+
 	//		virtual bool equals(IPolymorphicSerializable const& object) const = 0;
 
 	virtual size_t hashCode() const noexcept;
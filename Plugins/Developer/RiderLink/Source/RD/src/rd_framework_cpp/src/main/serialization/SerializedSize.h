@@ -0,0 +1,131 @@
+#ifndef RD_CPP_SERIALIZEDSIZE_H
+#define RD_CPP_SERIALIZEDSIZE_H
+
+#include "protocol/Buffer.h"
+#include "serialization/ISerializable.h"
+#include "types/DateTime.h"
+#include "types/wrapper.h"
+#include "std/allocator.h"
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace rd
+{
+// region predeclared
+
+class SerializationCtx;
+// endregion
+
+/**
+ * \brief Computes how many bytes [Polymorphic] writes for a value of [T] in [Buffer::Encoding::FIXED], so a buffer
+ * can be allocated once before writing. It's exact, 0 means unknown. Types of fixed layout provide it as constexpr
+ * [value].
+ * \tparam T type to measure
+ * \tparam R trait specialisation (void by default)
+ */
+template <typename T, typename R = void>
+struct SerializedSize
+{
+	static size_t get(SerializationCtx& /*ctx*/, T const& /*value*/)
+	{
+		return 0;
+	}
+};
+
+template <typename T>
+struct SerializedSize<T, typename std::enable_if_t<util::is_base_of_v<ISerializable, T>>>
+{
+	static size_t get(SerializationCtx& ctx, T const& value)
+	{
+		return value.serialized_size(ctx);
+	}
+};
+
+template <typename T>
+struct SerializedSize<T, typename std::enable_if_t<std::is_arithmetic<T>::value>>
+{
+	static constexpr size_t value =
+		std::is_same<T, bool>::value ? sizeof(uint8_t) : std::is_same<T, wchar_t>::value ? sizeof(uint16_t) : sizeof(T);
+
+	static constexpr size_t get(SerializationCtx& /*ctx*/, T const& /*value*/)
+	{
+		return value;
+	}
+};
+
+template <typename T>
+struct SerializedSize<T, typename std::enable_if_t<util::is_enum_v<T>>>
+{
+	static constexpr size_t value = sizeof(int32_t);
+
+	static constexpr size_t get(SerializationCtx& /*ctx*/, T const& /*value*/)
+	{
+		return value;
+	}
+};
+
+template <>
+struct SerializedSize<DateTime>
+{
+	static constexpr size_t value = sizeof(int64_t);
+
+	static constexpr size_t get(SerializationCtx& /*ctx*/, DateTime const& /*value*/)
+	{
+		return value;
+	}
+};
+
+template <>
+struct SerializedSize<std::wstring>
+{
+	static size_t get(SerializationCtx& /*ctx*/, std::wstring const& value)
+	{
+		return sizeof(int32_t) + sizeof(uint16_t) * value.size();
+	}
+};
+
+template <typename T>
+struct SerializedSize<optional<T>>
+{
+	static size_t get(SerializationCtx& ctx, optional<T> const& value)
+	{
+		return sizeof(uint8_t) + (value ? SerializedSize<T>::get(ctx, *value) : 0);
+	}
+};
+
+template <typename T, typename A>
+struct SerializedSize<Wrapper<T, A>>
+{
+	static size_t get(SerializationCtx& ctx, Wrapper<T, A> const& value)
+	{
+		return value ? SerializedSize<T>::get(ctx, *value) : 0;
+	}
+};
+
+template <typename T, typename A>
+struct SerializedSize<std::vector<T, A>>
+{
+	static size_t get(SerializationCtx& ctx, std::vector<T, A> const& value)
+	{
+		size_t result = sizeof(int32_t);
+		for (auto const& e : value)
+		{
+			result += SerializedSize<T>::get(ctx, e);
+		}
+		return result;
+	}
+};
+
+/**
+ * \brief See [SerializedSize].
+ */
+template <typename T>
+size_t serialized_size(SerializationCtx& ctx, T const& value)
+{
+	return SerializedSize<T>::get(ctx, value);
+}
+}	 // namespace rd
+
+#endif	  // RD_CPP_SERIALIZEDSIZE_H
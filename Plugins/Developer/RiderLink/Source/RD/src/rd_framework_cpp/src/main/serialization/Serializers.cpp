@@ -13,7 +13,7 @@ RdId Serializers::real_rd_id(const IUnknownInstance& value)
 
 RdId Serializers::real_rd_id(const IPolymorphicSerializable& value)
 {
-	return RdId(util::getPlatformIndependentHash(value.type_name()));
+	return value.type_id();
 }
 
 RdId Serializers::real_rd_id(const std::wstring& /*value*/)
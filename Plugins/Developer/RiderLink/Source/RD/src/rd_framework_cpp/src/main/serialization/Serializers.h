@@ -14,7 +14,7 @@
 #include "serialization/RdAny.h"
 #include "DefaultAbstractDeclaration.h"
 
-#include "std/unordered_map.h"
+#include "util/rdid_map.h"
 
 #include <utility>
 #include <iostream>
@@ -46,7 +46,7 @@ private:
 
 	void register_in();
 
-	mutable rd::unordered_map<RdId, std::function<InternedAny(SerializationCtx&, Buffer&)>> readers;
+	mutable util::rdid_map<std::function<InternedAny(SerializationCtx&, Buffer&)>> readers;
 
 public:
 	Serializers();
@@ -83,7 +83,7 @@ void Serializers::registry() const
 	util::hash_t h = util::getPlatformIndependentHash(type_name);
 	RdId id(h);
 
-	RD_ASSERT_MSG(readers.count(id) == 0, "Can't register " + type_name + " with id: " + to_string(id));
+	RD_ASSERT_MSG(!readers.contains(id), "Can't register " + type_name + " with id: " + to_string(id));
 
 	readers[id] = [](SerializationCtx& ctx, Buffer& buffer) -> Wrapper<IPolymorphicSerializable> {
 		return wrapper::make_wrapper<T>(T::read(ctx, buffer));
@@ -98,15 +98,15 @@ optional<InternedAny> Serializers::readAny(SerializationCtx& ctx, Buffer& buffer
 	{
 		return nullopt;
 	}
-	int32_t size = buffer.read_integral<int32_t>();
+	int32_t size = buffer.read_length();
 	buffer.check_available(static_cast<size_t>(size));
 
-	if (readers.count(id) == 0)
+	auto const* reader = readers.find(id);
+	if (reader == nullptr)
 	{
 		return any::make_interned_any<T>(T::readUnknownInstance(ctx, buffer, id, size));
 	}
-	auto const& reader = readers.at(id);
-	return reader(ctx, buffer);
+	return (*reader)(ctx, buffer);
 }
 
 template <typename T>
@@ -121,15 +121,10 @@ void Serializers::writePolymorphicNullable(SerializationCtx& ctx, Buffer& buffer
 {
 	real_rd_id(value).write(buffer);
 
-	int32_t length_tag_position = static_cast<int32_t>(buffer.get_position());
-	buffer.write_integral<int32_t>(0);
-	int32_t object_start_position = static_cast<int32_t>(buffer.get_position());
+	const size_t length_tag_position = buffer.reserve_length();
 	real_write(ctx, buffer, value);
 	//		value.write(ctx, buffer);
-	int32_t object_end_position = static_cast<int32_t>(buffer.get_position());
-	buffer.set_position(static_cast<size_t>(length_tag_position));
-	buffer.write_integral<int32_t>(object_end_position - object_start_position);
-	buffer.set_position(static_cast<size_t>(object_end_position));
+	buffer.write_length_at(length_tag_position);
 }
 
 template <typename T>
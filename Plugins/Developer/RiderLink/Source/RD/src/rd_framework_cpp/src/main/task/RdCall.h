@@ -2,6 +2,7 @@
 #define RD_CPP_RDCALL_H
 
 #include "serialization/Polymorphic.h"
+#include "serialization/SerializedSize.h"
 #include "RdTask.h"
 #include "RdTaskResult.h"
 #include "scheduler/SynchronousScheduler.h"
@@ -73,11 +74,7 @@ public:
 	{
 		auto task = start_internal(request, true, &SynchronousScheduler::Instance());
 		auto time_at_start = std::chrono::system_clock::now();
-		while (!task.has_value() && !(*bind_lifetime)->is_terminated() &&
-			   ((std::chrono::system_clock::now() - time_at_start) < timeout))
-		{
-			std::this_thread::yield();
-		}
+		task.wait(*bind_lifetime, timeout);
 		spdlog::debug("Time elapsed: {}, has_value={}", to_string(std::chrono::system_clock::now() - time_at_start),
 			to_string(task.has_value()));
 		task.value_or_throw().unwrap();	   // check for existing value
@@ -129,7 +126,8 @@ private:
 			sync_task_id = task_id;
 		}
 
-		get_wire()->send(rdid, [&](Buffer& buffer) {
+		const size_t size = sizeof(RdId::hash_t) + rd::serialized_size(get_serialization_context(), request);
+		get_wire()->send(rdid, size, [&](Buffer& buffer) {
 			spdlog::get("logSend")->trace("call {}::{} send {} request {} : {}", to_string(location), to_string(rdid), (sync ? "SYNC" : "ASYNC"),
 				to_string(task_id), to_string(request));
 			task_id.write(buffer);
@@ -3,6 +3,7 @@
 
 #include "serialization/Polymorphic.h"
 #include "RdTask.h"
+#include "util/rdid_map.h"
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -28,7 +29,9 @@ class RdEndpoint : public virtual RdReactiveBase, public ISerializable
 	using handler_t = std::function<RdTask<TRes, ResSer>(Lifetime, TReq const&)>;
 	mutable handler_t local_handler;
 
-	mutable tsl::ordered_map<RdId, RdTask<TRes, ResSer>, rd::hash<RdId>> awaiting_tasks;	// TO-DO get rid of it
+	mutable util::rdid_map<RdTask<TRes, ResSer>> awaiting_tasks;	// TO-DO get rid of it
+
+	mutable IScheduler* handler_scheduler = nullptr;
 public:
 	// region ctor/dtor
 
@@ -83,6 +86,21 @@ public:
 		{ return RdTask<TRes, ResSer>::from_result(handler(req)); };
 	}
 
+	/**
+	 * \brief Executes the handler on [scheduler] instead of the protocol scheduler, e.g. to handle requests of
+	 * several endpoints in parallel on a [WorkStealingScheduler]. Requests of one endpoint are still handled one by
+	 * one and in order.
+	 */
+	void set_handler_scheduler(IScheduler* scheduler) const
+	{
+		handler_scheduler = scheduler;
+	}
+
+	IScheduler* get_wire_scheduler() const override
+	{
+		return handler_scheduler != nullptr ? handler_scheduler : RdReactiveBase::get_wire_scheduler();
+	}
+
 	void init(Lifetime lifetime) const override
 	{
 		RdReactiveBase::init(lifetime);
@@ -109,12 +127,12 @@ public:
 			task.fault(e);
 		}
 		task.advise(*bind_lifetime,
-			[this, task_id, &task](RdTaskResult<TRes, ResSer> const& task_result)
+			[this, task_id](RdTaskResult<TRes, ResSer> const& task_result)
 			{
 				spdlog::get("logSend")->trace(
-					"endpoint {}::{} response = {}", to_string(location), to_string(rdid), to_string(*task.result));
-				get_wire()->send(
-					task_id, [&](Buffer& inner_buffer) { task_result.write(get_serialization_context(), inner_buffer); });
+					"endpoint {}::{} response = {}", to_string(location), to_string(rdid), to_string(task_result));
+				get_wire()->send_reply(rdid, task_id,
+					[&](Buffer& inner_buffer) { task_result.write(get_serialization_context(), inner_buffer); });
 				// TO-DO remove from awaiting_tasks
 			});
 	}
@@ -4,6 +4,9 @@
 #include "RdTaskImpl.h"
 #include "serialization/Polymorphic.h"
 
+#include "lifetime/LifetimeDefinition.h"
+
+#include <chrono>
 #include <functional>
 
 namespace rd
@@ -120,6 +123,25 @@ public:
 			}
 		});
 	}
+
+	/**
+	 * \brief Blocks until the task has a value, [lifetime] is terminated or [timeout] elapses.
+	 *
+	 * \return whether the task has a value
+	 */
+	bool wait(Lifetime lifetime, std::chrono::milliseconds timeout) const
+	{
+		LifetimeDefinition waiting(lifetime);
+		if (!waiting.lifetime->is_terminated())
+		{
+			waiting.lifetime->add_action([impl = impl] { impl->notify(); });
+		}
+		{
+			std::unique_lock<decltype(impl->lock)> guard(impl->lock);
+			impl->completed.wait_for(guard, timeout, [&] { return has_value() || lifetime->is_terminated(); });
+		}
+		return has_value();
+	}
 };
 }	 // namespace rd
 
@@ -6,6 +6,9 @@
 
 #include "thirdparty.hpp"
 
+#include <condition_variable>
+#include <mutex>
+
 namespace rd
 {
 template <typename, typename>
@@ -19,7 +22,25 @@ class RdTaskImpl
 private:
 	mutable Property<RdTaskResult<T, S>> result;
 
+	mutable std::mutex lock;
+	mutable std::condition_variable completed;
+
+	void notify() const
+	{
+		{
+			// pairs with the predicate check of a waiter, so the notification can't be missed
+			std::lock_guard<decltype(lock)> guard(lock);
+		}
+		completed.notify_all();
+	}
+
 public:
+	RdTaskImpl()
+	{
+		// subscribed once before the task is shared, so setting the result concurrently doesn't race with advising
+		result.advise(Lifetime::Eternal(), [this](optional<RdTaskResult<T, S>> const&) { notify(); });
+	}
+
 	template <typename, typename>
 	friend class ::rd::RdTask;
 };
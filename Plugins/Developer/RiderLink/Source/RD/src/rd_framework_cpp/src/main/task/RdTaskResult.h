@@ -79,7 +79,7 @@ public:
 
 	static RdTaskResult<T, S> read(SerializationCtx& ctx, Buffer& buffer)
 	{
-		const int32_t kind = buffer.read_integral<int32_t>();
+		const int32_t kind = buffer.read_varint32();
 		switch (kind)
 		{
 			case 0:
@@ -106,12 +106,12 @@ public:
 	{
 		visit(util::make_visitor(
 				  [&ctx, &buffer](Success const& value) {
-					  buffer.write_integral<int32_t>(0);
+					  buffer.write_varint32(0);
 					  S::write(ctx, buffer, value.value);
 				  },
-				  [&buffer](Cancelled const&) { buffer.write_integral<int32_t>(1); },
+				  [&buffer](Cancelled const&) { buffer.write_varint32(1); },
 				  [&buffer](Fault const& value) {
-					  buffer.write_integral<int32_t>(2);
+					  buffer.write_varint32(2);
 					  buffer.write_wstring(value.reason_type_fqn);
 					  buffer.write_wstring(value.reason_message);
 					  buffer.write_wstring(value.reason_as_text);
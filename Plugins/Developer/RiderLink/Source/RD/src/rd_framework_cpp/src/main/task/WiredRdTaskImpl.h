@@ -18,7 +18,8 @@ private:
 	Lifetime lifetime;
 	RdReactiveBase const* cutpoint{};
 	IScheduler* scheduler{};
-	Property<RdTaskResult<T, S>>* result{};
+	// shares ownership of the task, a waiter woken by the result may drop the task while it's still being set
+	std::shared_ptr<Property<RdTaskResult<T, S>>> result{};
 
 	LifetimeImpl::counter_t termination_lifetime_id{};
 
@@ -26,9 +27,9 @@ public:
 	template <typename, typename>
 	friend class ::rd::WiredRdTask;
 
-	WiredRdTaskImpl(
-		Lifetime lifetime, RdReactiveBase const& cutpoint, RdId rdid, IScheduler* scheduler, Property<RdTaskResult<T, S>>* result)
-		: lifetime(lifetime), cutpoint(&cutpoint), scheduler(scheduler), result(result)
+	WiredRdTaskImpl(Lifetime lifetime, RdReactiveBase const& cutpoint, RdId rdid, IScheduler* scheduler,
+		std::shared_ptr<Property<RdTaskResult<T, S>>> result)
+		: lifetime(lifetime), cutpoint(&cutpoint), scheduler(scheduler), result(std::move(result))
 	{
 		this->rdid = std::move(rdid);
 		cutpoint.get_wire()->advise(lifetime, this);
@@ -47,15 +48,15 @@ public:
 		spdlog::get("logReceived")
 			->trace("call {} {} received response {} : {}", to_string(cutpoint->get_location()), to_string(rdid), to_string(rdid),
 				to_string(read_result));
-		scheduler->queue([&, result = std::move(read_result)]() mutable {
-			if (this->result->has_value())
+		scheduler->queue([&, task_result = this->result, result = std::move(read_result)]() mutable {
+			if (task_result->has_value())
 			{
 				spdlog::get("logReceived")->trace("call {} {} response was dropped, task result is: {}", to_string(location), to_string(rdid),
 					to_string(result.unwrap()));
 			}
 			else
 			{
-				this->result->set_if_empty(std::move(result));
+				task_result->set_if_empty(std::move(result));
 			}
 		});
 	}
@@ -18,9 +18,14 @@ constexpr constexpr_hash_t DEFAULT_HASH = 19;
 constexpr constexpr_hash_t HASH_FACTOR = 31;
 
 // PLEASE DO NOT CHANGE IT!!! IT'S EXACTLY THE SAME ON C# SIDE
+// a loop rather than recursion, so long names don't hit constexpr depth limits when hashed at compile time
 constexpr hash_t hashImpl(constexpr_hash_t initial, char const* begin, char const* end)
 {
-	return (begin == end) ? initial : hashImpl(initial * HASH_FACTOR + *begin, begin + 1, end);
+	for (; begin != end; ++begin)
+	{
+		initial = initial * HASH_FACTOR + *begin;
+	}
+	return static_cast<hash_t>(initial);
 }
 
 /*template<size_t N>
@@ -30,7 +35,7 @@ constexpr hash_t getPlatformIndependentHash(char const (&that)[N], constexpr_has
 
 constexpr hash_t getPlatformIndependentHash(string_view that, constexpr_hash_t initial = DEFAULT_HASH)
 {
-	return static_cast<hash_t>(hashImpl(initial, &that[0], &that[that.length() - 1] + 1));
+	return static_cast<hash_t>(hashImpl(initial, that.data(), that.data() + that.length()));
 }
 
 constexpr hash_t getPlatformIndependentHash(int32_t const& that, constexpr_hash_t initial = DEFAULT_HASH)
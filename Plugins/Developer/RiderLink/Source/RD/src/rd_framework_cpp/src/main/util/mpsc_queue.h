@@ -0,0 +1,86 @@
+#ifndef RD_CPP_MPSC_QUEUE_H
+#define RD_CPP_MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Unbounded lock-free queue for many producers and a single consumer. [push] is wait-free and may be called
+ * from any thread, [try_pop] and [empty] only from the consumer thread.
+ */
+template <typename T>
+class mpsc_queue
+{
+	struct node
+	{
+		std::atomic<node*> next{nullptr};
+		T value{};
+
+		node() = default;
+
+		explicit node(T&& value) : value(std::move(value))
+		{
+		}
+	};
+
+	std::atomic<node*> head;
+
+	// consumed node, its successor is the front of the queue
+	node* tail;
+
+public:
+	// region ctor/dtor
+
+	mpsc_queue() : head(new node()), tail(head.load())
+	{
+	}
+
+	mpsc_queue(mpsc_queue const&) = delete;
+
+	mpsc_queue& operator=(mpsc_queue const&) = delete;
+
+	~mpsc_queue()
+	{
+		while (tail != nullptr)
+		{
+			node* next = tail->next.load(std::memory_order_relaxed);
+			delete tail;
+			tail = next;
+		}
+	}
+	// endregion
+
+	void push(T value)
+	{
+		node* n = new node(std::move(value));
+		node* prev = head.exchange(n, std::memory_order_acq_rel);
+		// seq_cst so that a producer checking for a parked consumer afterwards can't be reordered before the link
+		prev->next.store(n, std::memory_order_seq_cst);
+	}
+
+	bool try_pop(T& result)
+	{
+		node* next = tail->next.load(std::memory_order_acquire);
+		if (next == nullptr)
+		{
+			return false;
+		}
+		result = std::move(next->value);
+		delete tail;
+		tail = next;
+		return true;
+	}
+
+	bool empty() const
+	{
+		return tail->next.load(std::memory_order_seq_cst) == nullptr;
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_MPSC_QUEUE_H
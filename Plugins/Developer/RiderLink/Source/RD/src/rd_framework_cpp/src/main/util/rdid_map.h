@@ -0,0 +1,297 @@
+#ifndef RD_CPP_RDID_MAP_H
+#define RD_CPP_RDID_MAP_H
+
+#include "protocol/RdId.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Open addressing map keyed by non-null [RdId]. Ids are hashes already, so they're stored as is in a flat array
+ * which is probed linearly and doesn't need hashing beyond one multiplication to spread them. The null id marks empty
+ * slots. Erasing shifts following entries back instead of leaving tombstones, so probes never get longer than the
+ * table is full.
+ *
+ * Values don't move unless the table grows or an entry before them is erased: pointers returned by [find] are valid
+ * until the next insertion or erasure.
+ */
+template <typename V>
+class rdid_map
+{
+	using hash_t = RdId::hash_t;
+	using storage_t = typename std::aligned_storage<sizeof(V), alignof(V)>::type;
+
+	static constexpr hash_t EMPTY = RdId::Null().get_hash();
+	static constexpr size_t MIN_CAPACITY = 16;
+
+	std::unique_ptr<hash_t[]> keys;
+	std::unique_ptr<storage_t[]> values;
+	size_t mask = 0;
+	size_t count = 0;
+	int shift = 64;
+
+	size_t home(hash_t key) const
+	{
+		// Fibonacci hashing, the high bits of the product depend on all bits of the id
+		return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ULL) >> shift);
+	}
+
+	V& value_at(size_t i)
+	{
+		return *reinterpret_cast<V*>(&values[i]);
+	}
+
+	V const& value_at(size_t i) const
+	{
+		return *reinterpret_cast<V const*>(&values[i]);
+	}
+
+	size_t index_of(hash_t key) const
+	{
+		// the null id would match the first empty slot
+		if (keys == nullptr || key == EMPTY)
+		{
+			return SIZE_MAX;
+		}
+		for (size_t i = home(key);; i = (i + 1) & mask)
+		{
+			if (keys[i] == key)
+			{
+				return i;
+			}
+			if (keys[i] == EMPTY)
+			{
+				return SIZE_MAX;
+			}
+		}
+	}
+
+	void allocate(size_t capacity)
+	{
+		keys.reset(new hash_t[capacity]);
+		std::fill(keys.get(), keys.get() + capacity, EMPTY);
+		values.reset(new storage_t[capacity]);
+		mask = capacity - 1;
+		shift = 64;
+		for (size_t c = capacity; c > 1; c >>= 1)
+		{
+			--shift;
+		}
+	}
+
+	void grow()
+	{
+		const size_t old_capacity = keys != nullptr ? mask + 1 : 0;
+		std::unique_ptr<hash_t[]> old_keys = std::move(keys);
+		std::unique_ptr<storage_t[]> old_values = std::move(values);
+		allocate(old_capacity != 0 ? old_capacity * 2 : MIN_CAPACITY);
+		for (size_t j = 0; j < old_capacity; ++j)
+		{
+			if (old_keys[j] != EMPTY)
+			{
+				V& value = *reinterpret_cast<V*>(&old_values[j]);
+				size_t i = home(old_keys[j]);
+				while (keys[i] != EMPTY)
+				{
+					i = (i + 1) & mask;
+				}
+				keys[i] = old_keys[j];
+				new (&values[i]) V(std::move(value));
+				value.~V();
+			}
+		}
+	}
+
+	void destroy()
+	{
+		for (size_t i = 0; keys != nullptr && i <= mask; ++i)
+		{
+			if (keys[i] != EMPTY)
+			{
+				value_at(i).~V();
+				keys[i] = EMPTY;
+			}
+		}
+		count = 0;
+	}
+
+public:
+	// region ctor/dtor
+
+	rdid_map() = default;
+
+	rdid_map(rdid_map const&) = delete;
+
+	rdid_map& operator=(rdid_map const&) = delete;
+
+	rdid_map(rdid_map&& other) noexcept
+		: keys(std::move(other.keys))
+		, values(std::move(other.values))
+		, mask(other.mask)
+		, count(other.count)
+		, shift(other.shift)
+	{
+		other.mask = 0;
+		other.count = 0;
+	}
+
+	rdid_map& operator=(rdid_map&& other) noexcept
+	{
+		if (this != &other)
+		{
+			destroy();
+			keys = std::move(other.keys);
+			values = std::move(other.values);
+			mask = other.mask;
+			count = other.count;
+			shift = other.shift;
+			other.mask = 0;
+			other.count = 0;
+		}
+		return *this;
+	}
+
+	~rdid_map()
+	{
+		destroy();
+	}
+	// endregion
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	/**
+	 * \return value of [id] or nullptr
+	 */
+	V* find(RdId const& id)
+	{
+		const size_t i = index_of(id.get_hash());
+		return i != SIZE_MAX ? &value_at(i) : nullptr;
+	}
+
+	V const* find(RdId const& id) const
+	{
+		const size_t i = index_of(id.get_hash());
+		return i != SIZE_MAX ? &value_at(i) : nullptr;
+	}
+
+	bool contains(RdId const& id) const
+	{
+		return index_of(id.get_hash()) != SIZE_MAX;
+	}
+
+	/**
+	 * \brief Constructs the value of [id] from [args] unless it's there, throws if [id] is null.
+	 * \return the value of [id] and true if it's inserted
+	 */
+	template <typename... Args>
+	std::pair<V*, bool> try_emplace(RdId const& id, Args&&... args)
+	{
+		const hash_t key = id.get_hash();
+		// ids may come from the other side, so this is checked in release builds as well
+		RD_ASSERT_THROW_MSG(key != EMPTY, "id mustn't be null");
+		// at most 3/4 full
+		if (keys == nullptr || (count + 1) * 4 > (mask + 1) * 3)
+		{
+			if (keys != nullptr)
+			{
+				const size_t i = index_of(key);
+				if (i != SIZE_MAX)
+				{
+					return {&value_at(i), false};
+				}
+			}
+			grow();
+		}
+		size_t i = home(key);
+		for (; keys[i] != EMPTY; i = (i + 1) & mask)
+		{
+			if (keys[i] == key)
+			{
+				return {&value_at(i), false};
+			}
+		}
+		new (&values[i]) V(std::forward<Args>(args)...);
+		keys[i] = key;
+		++count;
+		return {&value_at(i), true};
+	}
+
+	V& operator[](RdId const& id)
+	{
+		return *try_emplace(id).first;
+	}
+
+	/**
+	 * \return true if [id] was there
+	 */
+	bool erase(RdId const& id)
+	{
+		size_t i = index_of(id.get_hash());
+		if (i == SIZE_MAX)
+		{
+			return false;
+		}
+		value_at(i).~V();
+		// shift back entries which would be unreachable from their home slot through the hole
+		for (size_t j = (i + 1) & mask; keys[j] != EMPTY; j = (j + 1) & mask)
+		{
+			const size_t h = home(keys[j]);
+			if (((j - h) & mask) >= ((j - i) & mask))
+			{
+				keys[i] = keys[j];
+				new (&values[i]) V(std::move(value_at(j)));
+				value_at(j).~V();
+				i = j;
+			}
+		}
+		keys[i] = EMPTY;
+		--count;
+		return true;
+	}
+
+	void clear()
+	{
+		destroy();
+	}
+
+	/**
+	 * \brief Calls [f] with the id and value of each entry in no particular order, [f] mustn't modify the map.
+	 */
+	template <typename F>
+	void for_each(F&& f) const
+	{
+		for (size_t i = 0; keys != nullptr && i <= mask; ++i)
+		{
+			if (keys[i] != EMPTY)
+			{
+				f(RdId(keys[i]), value_at(i));
+			}
+		}
+	}
+};
+
+template <typename V>
+constexpr RdId::hash_t rdid_map<V>::EMPTY;
+
+template <typename V>
+constexpr size_t rdid_map<V>::MIN_CAPACITY;
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_RDID_MAP_H
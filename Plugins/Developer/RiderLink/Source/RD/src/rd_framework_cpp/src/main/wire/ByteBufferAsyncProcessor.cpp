@@ -1,22 +1,44 @@
 #include "ByteBufferAsyncProcessor.h"
 
+#include "util/core_util.h"
 #include "util/guards.h"
 #include <util/thread_util.h>
+#include "std/unordered_map.h"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 
+#include <algorithm>
+
 namespace rd
 {
-size_t ByteBufferAsyncProcessor::INITIAL_CAPACITY = 1024 * 1024;
+constexpr size_t ByteBufferAsyncProcessor::DEFAULT_MAX_BATCH_SIZE;
+constexpr size_t ByteBufferAsyncProcessor::PRIORITY_COUNT;
+constexpr size_t ByteBufferAsyncProcessor::WEIGHT_QUANTUM;
 
 std::shared_ptr<spdlog::logger> ByteBufferAsyncProcessor::logger =
 	spdlog::stderr_color_mt<spdlog::synchronous_factory>("byteBufferLog", spdlog::color_mode::automatic);
 
 ByteBufferAsyncProcessor::ByteBufferAsyncProcessor(
 	std::string id, std::function<bool(Buffer::ByteArray const&, sequence_number_t)> processor)
+	: ByteBufferAsyncProcessor(std::move(id), [processor = std::move(processor)](batch_t const& batch, sequence_number_t first_seqn) {
+		for (size_t i = 0; i < batch.size(); ++i)
+		{
+			if (!processor(*batch[i], first_seqn + static_cast<sequence_number_t>(i)))
+			{
+				return false;
+			}
+		}
+		return true;
+	})
+{
+	max_batch_size = 1;
+}
+
+ByteBufferAsyncProcessor::ByteBufferAsyncProcessor(std::string id, batch_processor_t processor)
 	: id(std::move(id)), processor(std::move(processor))
 {
-	data.reserve(INITIAL_CAPACITY);
+	batch.reserve(max_batch_size);
+	batch_slots.reserve(max_batch_size);
 }
 
 void ByteBufferAsyncProcessor::cleanup0()
@@ -29,6 +51,7 @@ void ByteBufferAsyncProcessor::cleanup0()
 	// TO-DO clean data
 
 	cv.notify_all();
+	notify_space();
 }
 
 bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set, string_view action)
@@ -44,13 +67,14 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 
 		if (state >= state_to_set)
 		{
-			logger->debug("Trying to {} async processor \'{}' but it's in state {}", std::string(action), id, to_string(state));
+			logger->debug("Trying to {} async processor \'{}' but it's in state {}", std::string(action), id, to_string(state.load()));
 			return true;
 		}
 
 		state = state_to_set;
 	}
 	cv.notify_all();
+	notify_space();
 
 	std::future_status status = async_future.wait_for(timeout);
 
@@ -67,13 +91,374 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 	return success;
 }
 
-void ByteBufferAsyncProcessor::add_data(std::vector<Buffer::ByteArray>&& new_data)
+void ByteBufferAsyncProcessor::drain_incoming()
 {
 	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
-	std::move(new_data.begin(), new_data.end(), std::back_inserter(queue));
-	//		for (auto &&item : new_data) {
-	//			queue.emplace(std::move(item));
-	//		}
+	drain_incoming0();
+}
+
+void ByteBufferAsyncProcessor::drain_incoming0()
+{
+	std::lock_guard<decltype(lanes_lock)> guard(lanes_lock);
+	Entry item;
+	while (incoming.try_pop(item))
+	{
+		auto priority = Priority::Normal;
+		const int64_t lane_key = item.lane_key != 0 ? item.lane_key : item.key;
+		if (lane_key != 0 && !priorities.empty())
+		{
+			auto it = priorities.find(lane_key);
+			if (it != priorities.end())
+			{
+				priority = it->second;
+			}
+		}
+		const uint64_t order = drained++;
+		const bool ordered = item.ordered || (item.key != 0 && !ordered_keys.empty() && ordered_keys.count(item.key) > 0);
+		if (ordered)
+		{
+			ordered_queued.push_back(order);
+		}
+		Lane& lane = lanes[static_cast<size_t>(priority)];
+		if (item.fragment || (item.key != 0 && !lane.bulk_keys.empty() && lane.bulk_keys.count(item.key) > 0))
+		{
+			++lane.bulk_keys[item.key];
+			lane.bulk.push_back(BulkEntry{std::move(item.data), item.key, lane.queue_in, order, ordered});
+		}
+		else
+		{
+			lane.queue.push_back(QueueEntry{std::move(item.data), false, order, ordered});
+			++lane.queue_in;
+		}
+	}
+}
+
+size_t ByteBufferAsyncProcessor::fill_batch(std::deque<Buffer::ByteArray> const& source, size_t from)
+{
+	batch.clear();
+	const size_t to = (std::min)(source.size(), from + max_batch_size);
+	for (size_t i = from; i < to; ++i)
+	{
+		batch.push_back(&source[i]);
+	}
+	return batch.size();
+}
+
+bool ByteBufferAsyncProcessor::has_queued() const
+{
+	return std::any_of(lanes.begin(), lanes.end(), [](Lane const& lane) { return !lane.queue.empty() || !lane.bulk.empty(); });
+}
+
+Buffer::ByteArray const* ByteBufferAsyncProcessor::slot_head(size_t slot) const
+{
+	Lane const& lane = lanes[slot / 2];
+	if (slot % 2 == 0)
+	{
+		if (lane.taken == lane.queue.size())
+		{
+			return nullptr;
+		}
+		QueueEntry const& entry = lane.queue[lane.taken];
+		return in_order(entry.order, entry.ordered) ? &entry.data : nullptr;
+	}
+	if (lane.bulk_taken == lane.bulk.size())
+	{
+		return nullptr;
+	}
+	BulkEntry const& entry = lane.bulk[lane.bulk_taken];
+	// it waits until packages of the lane queued before it are in the batch
+	return entry.barrier <= lane.queue_out + lane.taken && in_order(entry.order, entry.ordered) ? &entry.data : nullptr;
+}
+
+bool ByteBufferAsyncProcessor::in_order(uint64_t order, bool ordered) const
+{
+	if (ordered_taken == ordered_queued.size())
+	{
+		return true;
+	}
+	if (!ordered)
+	{
+		return order < ordered_queued[ordered_taken];
+	}
+	// slots are queued in the order packages are drained, so their heads are the oldest packages not in the batch
+	for (auto const& lane : lanes)
+	{
+		if ((lane.taken < lane.queue.size() && lane.queue[lane.taken].order < order) ||
+			(lane.bulk_taken < lane.bulk.size() && lane.bulk[lane.bulk_taken].order < order))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void ByteBufferAsyncProcessor::discard_dropped()
+{
+	for (auto& lane : lanes)
+	{
+		if (lane.dropped == 0)
+		{
+			continue;
+		}
+		if (!ordered_queued.empty())
+		{
+			for (auto const& entry : lane.queue)
+			{
+				if (entry.dropped && entry.ordered)
+				{
+					ordered_queued.erase(std::find(ordered_queued.begin(), ordered_queued.end(), entry.order));
+				}
+			}
+		}
+		auto end = std::remove_if(lane.queue.begin(), lane.queue.end(), [](QueueEntry const& entry) { return entry.dropped; });
+		lane.queue_out += static_cast<uint64_t>(lane.queue.end() - end);
+		lane.queue.erase(end, lane.queue.end());
+		lane.dropped = 0;
+	}
+}
+
+void ByteBufferAsyncProcessor::fill_lanes_batch()
+{
+	std::lock_guard<decltype(lanes_lock)> guard(lanes_lock);
+	batch.clear();
+	batch_slots.clear();
+	for (auto& lane : lanes)
+	{
+		lane.taken = 0;
+		lane.bulk_taken = 0;
+	}
+	ordered_taken = 0;
+	// no batch refers to lanes now, so packages dropped meanwhile can be erased
+	discard_dropped();
+	// a batch takes a round at most, so packages put meanwhile are scheduled before the next one
+	size_t visited = 0;
+	while (batch.size() < max_batch_size)
+	{
+		Buffer::ByteArray const* head = slot_head(current_slot);
+		if (head == nullptr || (slot_visited && head->size() > deficits[current_slot]))
+		{
+			if (head == nullptr)
+			{
+				// an idle slot doesn't save up its deficit
+				deficits[current_slot] = 0;
+			}
+			current_slot = (current_slot + 1) % deficits.size();
+			slot_visited = false;
+			if (++visited >= deficits.size() && !batch.empty())
+			{
+				break;
+			}
+			bool ready = false;
+			for (size_t slot = 0; slot < deficits.size() && !ready; ++slot)
+			{
+				ready = slot_head(slot) != nullptr;
+			}
+			if (!ready)
+			{
+				break;
+			}
+			continue;
+		}
+		if (!slot_visited)
+		{
+			deficits[current_slot] += weights[current_slot / 2] * WEIGHT_QUANTUM;
+			slot_visited = true;
+			if (head->size() > deficits[current_slot])
+			{
+				continue;
+			}
+		}
+		deficits[current_slot] -= head->size();
+		batch.push_back(head);
+		batch_slots.push_back(current_slot);
+		Lane& lane = lanes[current_slot / 2];
+		size_t& taken = current_slot % 2 == 0 ? lane.taken : lane.bulk_taken;
+		if (current_slot % 2 == 0 ? lane.queue[taken].ordered : lane.bulk[taken].ordered)
+		{
+			++ordered_taken;
+		}
+		++taken;
+	}
+}
+
+void ByteBufferAsyncProcessor::move_to_pending(size_t slot)
+{
+	Lane& lane = lanes[slot / 2];
+	Buffer::ByteArray data;
+	bool ordered;
+	if (slot % 2 == 0)
+	{
+		ordered = lane.queue.front().ordered;
+		data = std::move(lane.queue.front().data);
+		lane.queue.pop_front();
+		++lane.queue_out;
+		--lane.taken;
+	}
+	else
+	{
+		BulkEntry& entry = lane.bulk.front();
+		ordered = entry.ordered;
+		data = std::move(entry.data);
+		auto it = lane.bulk_keys.find(entry.key);
+		if (--it->second == 0)
+		{
+			lane.bulk_keys.erase(it);
+		}
+		lane.bulk.pop_front();
+		--lane.bulk_taken;
+	}
+	if (ordered)
+	{
+		// ordered packages join the batch in the order they were drained
+		ordered_queued.pop_front();
+		--ordered_taken;
+	}
+	const size_t size = data.size();
+	queued_bytes -= size;
+	--queued_messages;
+	pending_bytes += size;
+	++pending_messages;
+	pending_queue.push_back(std::move(data));
+}
+
+void ByteBufferAsyncProcessor::trim_acknowledged()
+{
+	trim_requested = false;
+	const sequence_number_t acknowledged = acknowledged_seqn;
+	if (acknowledged < current_seqn || pending_queue.empty())
+	{
+		return;
+	}
+	// acks are cumulative, so a single one may cover many packages which are erased at once
+	const size_t count = (std::min)(static_cast<size_t>(acknowledged - current_seqn + 1), pending_queue.size());
+	size_t freed = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		freed += pending_queue[i].size();
+	}
+	pending_queue.erase(pending_queue.begin(), pending_queue.begin() + static_cast<std::ptrdiff_t>(count));
+	pending_bytes -= freed;
+	pending_messages -= count;
+	current_seqn += static_cast<sequence_number_t>(count);
+	notify_space();
+}
+
+void ByteBufferAsyncProcessor::notify_space()
+{
+	if (blocked_producers > 0)
+	{
+		{
+			std::lock_guard<decltype(space_lock)> guard(space_lock);
+		}
+		space_cv.notify_all();
+	}
+}
+
+bool ByteBufferAsyncProcessor::fits(Limits const& l, size_t size, size_t count) const
+{
+	const size_t messages = queued_messages + pending_messages;
+	if (messages == 0)
+	{
+		// a package larger than the whole window still goes through an empty one
+		return true;
+	}
+	const size_t bytes = queued_bytes + pending_bytes;
+	return (l.max_bytes == 0 || bytes + size <= l.max_bytes) && (l.max_messages == 0 || messages + count <= l.max_messages);
+}
+
+void ByteBufferAsyncProcessor::drop_superseded(Limits const& l, Buffer::ByteArray const& new_data)
+{
+	std::lock_guard<decltype(lanes_lock)> guard(lanes_lock);
+	if (!droppable_key)
+	{
+		return;
+	}
+	// packages before [Lane::taken] are being processed, they are neither counted nor dropped
+	rd::unordered_map<int64_t, int32_t> later;
+	for (auto const& lane : lanes)
+	{
+		for (auto it = lane.queue.begin() + static_cast<std::ptrdiff_t>(lane.taken); it != lane.queue.end(); ++it)
+		{
+			const int64_t key = it->dropped ? 0 : droppable_key(it->data);
+			if (key != 0)
+			{
+				++later[key];
+			}
+		}
+	}
+	const int64_t new_key = droppable_key(new_data);
+	if (new_key != 0)
+	{
+		++later[new_key];
+	}
+	for (auto& lane : lanes)
+	{
+		for (auto it = lane.queue.begin() + static_cast<std::ptrdiff_t>(lane.taken);
+			 it != lane.queue.end() && !fits(l, new_data.size(), 1); ++it)
+		{
+			const int64_t key = it->dropped ? 0 : droppable_key(it->data);
+			if (key == 0)
+			{
+				continue;
+			}
+			if (later[key]-- > 1)
+			{
+				// the async thread erases it, the space is freed right away
+				queued_bytes -= it->data.size();
+				--queued_messages;
+				++dropped_messages;
+				Buffer::ByteArray().swap(it->data);
+				it->dropped = true;
+				++lane.dropped;
+			}
+		}
+	}
+}
+
+bool ByteBufferAsyncProcessor::reserve_space(size_t size, size_t count, Buffer::ByteArray const* new_data)
+{
+	if (bounded)
+	{
+		// the check and the accounting are done at once, so concurrent producers don't overshoot the limits together
+		std::unique_lock<decltype(space_lock)> ul(space_lock);
+		if (!fits(limits, size, count))
+		{
+			switch (limits.policy)
+			{
+				case OverflowPolicy::Block:
+				{
+					util::increment_guard<std::atomic<int32_t>> guard(blocked_producers);
+					space_cv.wait_for(ul, limits.block_timeout,
+						[this, size, count]() -> bool { return fits(limits, size, count) || state >= StateKind::Stopping; });
+					break;
+				}
+				case OverflowPolicy::DropOldest:
+				{
+					if (new_data != nullptr)
+					{
+						drop_superseded(limits, *new_data);
+					}
+					break;
+				}
+				case OverflowPolicy::Fail:
+					break;
+			}
+			if (!fits(limits, size, count))
+			{
+				ul.unlock();
+				++rejected_messages;
+				logger->warn("{}: package of {} bytes rejected, window holds {} bytes in {} packages", id, size,
+					queued_bytes + pending_bytes, queued_messages + pending_messages);
+				return false;
+			}
+		}
+		queued_bytes += size;
+		queued_messages += count;
+		return true;
+	}
+	queued_bytes += size;
+	queued_messages += count;
+	return true;
 }
 
 bool ByteBufferAsyncProcessor::reprocess()
@@ -88,23 +473,40 @@ bool ByteBufferAsyncProcessor::reprocess()
 
 		logger->debug("{}: reprocessing waited for main processing", id);
 
-		while (current_seqn <= acknowledged_seqn)
+		trim_acknowledged();
+		for (size_t i = 0; i < pending_queue.size();)
 		{
-			pending_queue.pop_front();
-			++current_seqn;
-		}
-		for (int i = 0; i < pending_queue.size(); ++i)
-		{
-			auto const& item = pending_queue[i];
-			if (!processor(item, current_seqn + i))
+			const size_t count = fill_batch(pending_queue, i);
+			if (!processor(batch, current_seqn + static_cast<sequence_number_t>(i)))
 			{
 				return false;
 			}
+			i += count;
 		}
 	}
 	return true;
 }
 
+void ByteBufferAsyncProcessor::reprocess_async()
+{
+	// unlike [resume] it doesn't hold [lock] while sending, so acknowledges and producers don't wait for it
+	try
+	{
+		reprocess();
+	}
+	catch (std::exception const& e)
+	{
+		logger->error("Exception while reprocessing byte queue | {}", e.what());
+	}
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+
+		--interrupt_balance;
+
+		logger->debug("{} resumed", id);
+	}
+}
+
 void ByteBufferAsyncProcessor::process()
 {
 	{
@@ -114,12 +516,37 @@ void ByteBufferAsyncProcessor::process()
 
 		logger->debug("{}: processing started", id);
 
-		while (!queue.empty() && processor(queue.front(), max_sent_seqn + 1))
+		trim_acknowledged();
+		// packages left after a pause are processed after the pending ones are reprocessed on resume
+		while (interrupt_balance == 0 && has_queued())
+		{
+			fill_lanes_batch();
+			if (batch.empty() || !processor(batch, max_sent_seqn + 1))
+			{
+				// an empty batch means the queued packages were dropped
+				break;
+			}
+			max_sent_seqn += static_cast<sequence_number_t>(batch.size());
+			{
+				std::lock_guard<decltype(lanes_lock)> lanes_guard(lanes_lock);
+				// packages of a slot are a prefix of it, so they are moved in order
+				for (size_t slot : batch_slots)
+				{
+					move_to_pending(slot);
+				}
+			}
+			if (has_queued())
+			{
+				// packages put meanwhile are scheduled along with the rest
+				drain_incoming0();
+			}
+		}
+		if (interrupt_balance != 0 && has_queued())
 		{
-			++max_sent_seqn;
-			pending_queue.push_back(std::move(queue.front()));
-			queue.pop_front();
+			drained_while_paused = true;
 		}
+		batch.clear();
+		trim_acknowledged();
 	}
 	processing_cv.notify_all();
 
@@ -133,6 +560,7 @@ void ByteBufferAsyncProcessor::ThreadProc()
 
 	while (true)
 	{
+		bool resuming = false;
 		{
 			std::lock_guard<decltype(lock)> guard(lock);
 
@@ -141,10 +569,24 @@ void ByteBufferAsyncProcessor::ThreadProc()
 				return;
 			}
 
-			while (data.empty() || interrupt_balance != 0)
+			// producers check [parked] after publishing, so either the check below sees their data or they notify
+			parked = true;
+			while (resume_requests == 0 && ((incoming.empty() && !drained_while_paused) || interrupt_balance != 0))
 			{
+				if (trim_requested)
+				{
+					std::lock_guard<decltype(queue_lock)> queue_guard(queue_lock);
+					trim_acknowledged();
+				}
+				if (interrupt_balance != 0 && !incoming.empty())
+				{
+					// keep packages accepted while paused in [lanes], where they can be dropped under backpressure
+					drain_incoming();
+					drained_while_paused = true;
+				}
 				if (state >= StateKind::Stopping)
 				{
+					parked = false;
 					return;
 				}
 				cv.wait(lock);
@@ -153,12 +595,27 @@ void ByteBufferAsyncProcessor::ThreadProc()
 
 				if (state >= StateKind::Terminating)
 				{
+					parked = false;
 					return;
 				}
 			}
-			add_data(std::move(data));
-			data.clear();
+			parked = false;
+			if (resume_requests != 0)
+			{
+				--resume_requests;
+				resuming = true;
+			}
+			else
+			{
+				drained_while_paused = false;
+			}
 		}
+		if (resuming)
+		{
+			reprocess_async();
+			continue;
+		}
+		drain_incoming();
 
 		try
 		{
@@ -178,7 +635,7 @@ void ByteBufferAsyncProcessor::start()
 
 		if (state != StateKind::Initialized)
 		{
-			logger->debug("Trying to START async processor {} but it's in state {}", id, to_string(state));
+			logger->debug("Trying to START async processor {} but it's in state {}", id, to_string(state.load()));
 			return;
 		}
 
@@ -198,18 +655,57 @@ bool ByteBufferAsyncProcessor::terminate(time_t timeout)
 	return terminate0(timeout, StateKind::Terminating, "TERMINATE");
 }
 
-void ByteBufferAsyncProcessor::put(Buffer::ByteArray new_data)
+bool ByteBufferAsyncProcessor::put(Buffer::ByteArray new_data, int64_t key, int64_t lane_key)
 {
+	if (state >= StateKind::Stopping)
 	{
-		std::lock_guard<decltype(lock)> guard(lock);
+		return true;
+	}
+	if (!reserve_space(new_data.size(), 1, &new_data))
+	{
+		return false;
+	}
+	incoming.push(Entry{std::move(new_data), key, lane_key, false});
+	if (parked)
+	{
+		// taking the lock guarantees the async thread is either waiting already or will see the new data
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+		}
+		cv.notify_all();
+	}
+	return true;
+}
 
-		if (state >= StateKind::Stopping)
+bool ByteBufferAsyncProcessor::put_fragments(std::vector<Buffer::ByteArray> fragments, int64_t key, int64_t lane_key)
+{
+	if (state >= StateKind::Stopping || fragments.empty())
+	{
+		return true;
+	}
+	size_t size = 0;
+	for (auto const& fragment : fragments)
+	{
+		size += fragment.size();
+	}
+	if (!reserve_space(size, fragments.size(), nullptr))
+	{
+		return false;
+	}
+	bool first = true;
+	for (auto& fragment : fragments)
+	{
+		incoming.push(Entry{std::move(fragment), key, lane_key, true, first});
+		first = false;
+	}
+	if (parked)
+	{
 		{
-			return;
+			std::lock_guard<decltype(lock)> guard(lock);
 		}
-		data.emplace_back(std::move(new_data));
+		cv.notify_all();
 	}
-	cv.notify_all();
+	return true;
 }
 
 void ByteBufferAsyncProcessor::pause(const std::string& reason)
@@ -218,7 +714,7 @@ void ByteBufferAsyncProcessor::pause(const std::string& reason)
 
 	++interrupt_balance;
 
-	logger->debug("{} paused with reason={},state={}", id, reason, to_string(state));
+	logger->debug("{} paused with reason={},state={}", id, reason, to_string(state.load()));
 
 	auto current_thread_id = std::this_thread::get_id();
 	if (current_thread_id != async_thread_id)
@@ -245,6 +741,26 @@ void ByteBufferAsyncProcessor::resume()
 	cv.notify_all();
 }
 
+void ByteBufferAsyncProcessor::pause_async(const std::string& reason)
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+
+	++interrupt_balance;
+
+	logger->debug("{} paused with reason={},state={}", id, reason, to_string(state.load()));
+}
+
+void ByteBufferAsyncProcessor::resume_async()
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+
+		++resume_requests;
+	}
+
+	cv.notify_all();
+}
+
 void ByteBufferAsyncProcessor::acknowledge(sequence_number_t seqn)
 {
 	std::lock_guard<decltype(lock)> guard(lock);
@@ -256,8 +772,87 @@ void ByteBufferAsyncProcessor::acknowledge(sequence_number_t seqn)
 	}
 	else
 	{
-		logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn);
+		logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn.load());
+	}
+
+	// the async thread trims after every processing round, don't wait for it while it's sending
+	std::unique_lock<decltype(queue_lock)> ul(queue_lock, std::try_to_lock);
+	if (ul.owns_lock())
+	{
+		trim_acknowledged();
+	}
+	else
+	{
+		// the holder may have trimmed before this ack already, so the async thread trims before it waits
+		trim_requested = true;
+		cv.notify_all();
+	}
+}
+
+void ByteBufferAsyncProcessor::set_max_batch_size(size_t value)
+{
+	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
+
+	max_batch_size = (std::max)(value, static_cast<size_t>(1));
+	batch.reserve(max_batch_size);
+	batch_slots.reserve(max_batch_size);
+}
+
+void ByteBufferAsyncProcessor::set_limits(Limits value)
+{
+	{
+		std::lock_guard<decltype(space_lock)> guard(space_lock);
+		bounded = value.max_bytes != 0 || value.max_messages != 0;
+		limits = value;
+	}
+	space_cv.notify_all();
+}
+
+void ByteBufferAsyncProcessor::set_droppable_key(droppable_key_t value)
+{
+	std::lock_guard<decltype(lanes_lock)> guard(lanes_lock);
+
+	droppable_key = std::move(value);
+}
+
+void ByteBufferAsyncProcessor::set_priority(int64_t key, Priority priority)
+{
+	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
+
+	RD_ASSERT_MSG(priority == Priority::Normal || ordered_keys.count(key) == 0,
+		"packages of an ordered key are kept in order with every lane, they can't be moved to another one");
+	if (priority == Priority::Normal)
+	{
+		priorities.erase(key);
+	}
+	else
+	{
+		priorities[key] = priority;
+	}
+}
+
+void ByteBufferAsyncProcessor::set_weights(Weights value)
+{
+	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
+
+	for (auto& weight : value)
+	{
+		weight = (std::max)(weight, static_cast<uint32_t>(1));
 	}
+	weights = value;
+}
+
+void ByteBufferAsyncProcessor::set_ordered(int64_t key)
+{
+	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
+
+	RD_ASSERT_MSG(priorities.count(key) == 0, "a key moved to another lane can't be ordered, see [set_priority]");
+	ordered_keys.insert(key);
+}
+
+ByteBufferAsyncProcessor::Stats ByteBufferAsyncProcessor::get_stats() const
+{
+	return Stats{queued_bytes, queued_messages, pending_bytes, pending_messages, dropped_messages, rejected_messages};
 }
 
 std::string to_string(ByteBufferAsyncProcessor::StateKind state)
@@ -7,8 +7,12 @@
 #endif
 
 #include "protocol/Buffer.h"
+#include "util/mpsc_queue.h"
+#include "std/unordered_map.h"
+#include "std/unordered_set.h"
 #include "spdlog/spdlog.h"
 
+#include <array>
 #include <chrono>
 #include <string>
 #include <mutex>
@@ -34,34 +38,235 @@ public:
 		Terminated
 	};
 
+	/**
+	 * \brief Consecutive packages handed to the processor at once. First package gets [first_seqn], the rest follow it.
+	 */
+	using batch_t = std::vector<Buffer::ByteArray const*>;
+
+	using batch_processor_t = std::function<bool(batch_t const& batch, sequence_number_t first_seqn)>;
+
+	static constexpr size_t DEFAULT_MAX_BATCH_SIZE = 64;
+
+	/**
+	 * \brief What [put] does when accepting a package would exceed [Limits].
+	 */
+	enum class OverflowPolicy
+	{
+		/**
+		 * \brief Wait until acknowledges free enough space, reject after [Limits::block_timeout].
+		 */
+		Block,
+		/**
+		 * \brief Drop the oldest unsent packages superseded by a later package with the same droppable key, reject if
+		 * that isn't enough.
+		 */
+		DropOldest,
+		/**
+		 * \brief Reject the package immediately.
+		 */
+		Fail
+	};
+
+	/**
+	 * \brief Bounds of the window of accepted but not yet acknowledged packages, zero means unlimited.
+	 */
+	struct Limits
+	{
+		size_t max_bytes = 0;
+		size_t max_messages = 0;
+		OverflowPolicy policy = OverflowPolicy::Block;
+		std::chrono::milliseconds block_timeout = std::chrono::milliseconds(5000);
+	};
+
+	struct Stats
+	{
+		/**
+		 * \brief Accepted packages which haven't been sent yet.
+		 */
+		size_t queued_bytes;
+		size_t queued_messages;
+
+		/**
+		 * \brief Sent packages which haven't been acknowledged yet.
+		 */
+		size_t pending_bytes;
+		size_t pending_messages;
+
+		uint64_t dropped_messages;
+		uint64_t rejected_messages;
+	};
+
+	/**
+	 * \brief Returns a key for packages which may be dropped in favour of a later one with the same key, 0 otherwise.
+	 */
+	using droppable_key_t = std::function<int64_t(Buffer::ByteArray const&)>;
+
+	/**
+	 * \brief Class of packages of a key, each class is queued in a lane of its own. Lanes are processed by deficit round
+	 * robin, a lane gets the share of its weight when they are all busy, so packages put behind a long queue of a
+	 * lower class don't wait for it. Packages of a key are processed in order, but packages of different classes may
+	 * overtake one another, unless one of them is of an ordered key, see [set_ordered].
+	 */
+	enum class Priority : uint8_t
+	{
+		High,
+		Normal,
+		Low
+	};
+
+	static constexpr size_t PRIORITY_COUNT = 3;
+
+	/**
+	 * \brief Weights of lanes by [Priority], a lane may process [WEIGHT_QUANTUM] bytes per unit of its weight in a round.
+	 */
+	using Weights = std::array<uint32_t, PRIORITY_COUNT>;
+
+	static constexpr size_t WEIGHT_QUANTUM = 4096;
+
 private:
 	using time_t = std::chrono::milliseconds;
 
-	static size_t INITIAL_CAPACITY;
-
 	std::recursive_mutex lock;
 	std::condition_variable_any cv;
 
 	std::string id;
 
-	std::function<bool(Buffer::ByteArray const&, sequence_number_t seqn)> processor;
+	batch_processor_t processor;
 
-	StateKind state{StateKind::Initialized};
+	size_t max_batch_size = DEFAULT_MAX_BATCH_SIZE;
+	batch_t batch;
+
+	std::atomic<StateKind> state{StateKind::Initialized};
 	static std::shared_ptr<spdlog::logger> logger;
 
 	std::thread::id async_thread_id;
 	std::future<void> async_future;
 
-	std::vector<Buffer::ByteArray> data;
+	struct Entry
+	{
+		Buffer::ByteArray data;
+		int64_t key = 0;
+		// key selecting the lane instead of [key] if it isn't 0
+		int64_t lane_key = 0;
+		bool fragment = false;
+		// kept in order with packages of all keys like the ones of [ordered_keys]
+		bool ordered = false;
+	};
+
+	/**
+	 * \brief Filled by producers without locking, drained into [lanes] by the async thread only.
+	 */
+	util::mpsc_queue<Entry> incoming;
+
+	/**
+	 * \brief Set while the async thread waits on [cv], producers notify it only then.
+	 */
+	std::atomic<bool> parked{false};
+
 	std::mutex queue_lock;
-	std::deque<Buffer::ByteArray> queue{};
 	std::deque<Buffer::ByteArray> pending_queue{};
 
+	struct BulkEntry
+	{
+		Buffer::ByteArray data;
+		int64_t key;
+		/**
+		 * \brief Value of [Lane::queue_in] when the entry was drained, it waits for packages queued before it.
+		 */
+		uint64_t barrier;
+		// value of [drained] when the entry was drained
+		uint64_t order;
+		bool ordered;
+	};
+
+	struct QueueEntry
+	{
+		Buffer::ByteArray data;
+		/**
+		 * \brief Set by a producer which dropped the package, the async thread discards it before the next batch.
+		 */
+		bool dropped = false;
+		uint64_t order = 0;
+		bool ordered = false;
+	};
+
+	struct Lane
+	{
+		std::deque<QueueEntry> queue{};
+		size_t dropped = 0;
+
+		/**
+		 * \brief Fragments of large packages, and packages following them with the same key. They are scheduled apart
+		 * from [queue], so the rest of packages are interleaved with them instead of waiting for the whole large package.
+		 */
+		std::deque<BulkEntry> bulk{};
+		rd::unordered_map<int64_t, int32_t> bulk_keys{};
+
+		// packages which entered and left [queue]
+		uint64_t queue_in = 0;
+		uint64_t queue_out = 0;
+
+		// packages of [queue] and [bulk] in the batch being filled
+		size_t taken = 0;
+		size_t bulk_taken = 0;
+	};
+
+	/**
+	 * \brief Guards [lanes] against producers dropping packages of them, it's never held while the batch is processed.
+	 * Producers only mark packages past the batch, so the batch stays valid without it.
+	 */
+	std::mutex lanes_lock;
+	std::array<Lane, PRIORITY_COUNT> lanes{};
+	rd::unordered_map<int64_t, Priority> priorities{};
+	Weights weights{{8, 4, 1}};
+
+	/**
+	 * \brief Keys of packages which are processed in the order they were put with respect to packages of any lane.
+	 */
+	rd::unordered_set<int64_t> ordered_keys{};
+	// packages drained into [lanes] so far
+	uint64_t drained = 0;
+	// [QueueEntry::order] of packages of [ordered_keys] in [lanes], and how many of them are in the batch being filled
+	std::deque<uint64_t> ordered_queued{};
+	size_t ordered_taken = 0;
+
+	/**
+	 * \brief Deficit round robin state, the queue and the bulk of each lane are slots of their own.
+	 */
+	std::array<size_t, 2 * PRIORITY_COUNT> deficits{};
+	size_t current_slot = 0;
+	bool slot_visited = false;
+
+	// slot of each package of [batch]
+	std::vector<size_t> batch_slots;
+
 	sequence_number_t max_sent_seqn = 0;
 	sequence_number_t current_seqn = 1;
-	sequence_number_t acknowledged_seqn = 0;
-
-	int32_t interrupt_balance = 0;
+	std::atomic<sequence_number_t> acknowledged_seqn{0};
+	// set by [acknowledge] when it couldn't trim, the async thread trims before it waits
+	std::atomic<bool> trim_requested{false};
+
+	std::atomic<bool> bounded{false};
+	Limits limits;
+	droppable_key_t droppable_key;
+	std::mutex space_lock;
+	std::condition_variable space_cv;
+	std::atomic<int32_t> blocked_producers{0};
+
+	std::atomic<size_t> queued_bytes{0};
+	std::atomic<size_t> queued_messages{0};
+	std::atomic<size_t> pending_bytes{0};
+	std::atomic<size_t> pending_messages{0};
+	std::atomic<uint64_t> dropped_messages{0};
+	std::atomic<uint64_t> rejected_messages{0};
+
+	// set when packages are left in [lanes] while paused, so they are processed after resume, used by the async thread only
+	bool drained_while_paused = false;
+
+	// changed under [lock], [process] reads it to stop sending once paused
+	std::atomic<int32_t> interrupt_balance{0};
+	// resumes requested by [resume_async] which the async thread hasn't done yet
+	int32_t resume_requests = 0;
 	bool in_processing = false;
 	std::mutex processing_lock;
 	std::condition_variable processing_cv;
@@ -71,16 +276,68 @@ public:
 
 	explicit ByteBufferAsyncProcessor(std::string id, std::function<bool(Buffer::ByteArray const&, sequence_number_t)> processor);
 
+	ByteBufferAsyncProcessor(std::string id, batch_processor_t processor);
+
 	// endregion
 private:
 	void cleanup0();
 
 	bool terminate0(time_t timeout, StateKind state_to_set, string_view action);
 
-	void add_data(std::vector<Buffer::ByteArray>&& new_data);
+	void drain_incoming();
+
+	// requires [queue_lock]
+	void drain_incoming0();
+
+	size_t fill_batch(std::deque<Buffer::ByteArray> const& source, size_t from);
+
+	// requires [queue_lock]
+	bool has_queued() const;
+
+	/**
+	 * \brief Next package of [slot] for the batch being filled, nullptr if there is none or it has to wait.
+	 */
+	Buffer::ByteArray const* slot_head(size_t slot) const;
+
+	/**
+	 * \brief Whether the package drained as [order] may join the batch being filled, packages of ordered keys wait for
+	 * the ones drained before them and the rest wait for the ordered ones drained before them.
+	 */
+	bool in_order(uint64_t order, bool ordered) const;
+
+	// requires [lanes_lock]
+	void discard_dropped();
+
+	/**
+	 * \brief Fills [batch] with packages of lanes by their weights.
+	 */
+	void fill_lanes_batch();
+
+	/**
+	 * \brief Moves the first package of [slot] to [pending_queue] once it's processed, requires [lanes_lock].
+	 */
+	void move_to_pending(size_t slot);
+
+	// requires [queue_lock]
+	void trim_acknowledged();
+
+	void notify_space();
+
+	bool fits(Limits const& l, size_t size, size_t count) const;
+
+	// requires [space_lock]
+	void drop_superseded(Limits const& l, Buffer::ByteArray const& new_data);
+
+	/**
+	 * \brief Accounts [count] packages of [size] bytes in total, [new_data] is the package unless they are fragments.
+	 */
+	bool reserve_space(size_t size, size_t count, Buffer::ByteArray const* new_data);
 
 	bool reprocess();
 
+	// reprocesses packages on the async thread for [resume_async]
+	void reprocess_async();
+
 	void process();
 
 	void ThreadProc();
@@ -92,13 +349,66 @@ public:
 
 	bool terminate(time_t timeout = time_t(0) /*InfiniteDuration*/);
 
-	void put(Buffer::ByteArray new_data);
+	/**
+	 * \brief Queues [new_data] for processing. A non-zero [key] orders it after fragments of the same key. A non-zero
+	 * [lane_key] puts it in the lane of packages of [lane_key] instead of the lane of [key], e.g. for a response to them.
+	 * \return false if the package was rejected because of [Limits].
+	 */
+	bool put(Buffer::ByteArray new_data, int64_t key = 0, int64_t lane_key = 0);
+
+	/**
+	 * \brief Queues [fragments] of a package which is too large to be processed at once. They are processed in order
+	 * after packages put before, but packages put later only wait for the first of them, so the receiver knows of the
+	 * package before it gets later ones which may depend on it, and for the rest only if they have the same [key].
+	 * \return false if the fragments were rejected because of [Limits], they are accepted or rejected together.
+	 */
+	bool put_fragments(std::vector<Buffer::ByteArray> fragments, int64_t key, int64_t lane_key = 0);
 
 	void pause(const std::string& reason);
 
 	void resume();
 
+	/**
+	 * \brief Like [pause], but doesn't wait for the processing in progress, so it may be called on a thread which the
+	 * processing waits for. The package being processed when it's called may still be processed.
+	 */
+	void pause_async(const std::string& reason);
+
+	/**
+	 * \brief Like [resume], but the pending packages are reprocessed on the async thread instead of the calling one.
+	 */
+	void resume_async();
+
 	void acknowledge(int64_t seqn);
+
+	/**
+	 * \brief Limits how many queued packages are drained into a single processor call. 1 means package-by-package.
+	 */
+	void set_max_batch_size(size_t value);
+
+	void set_limits(Limits value);
+
+	void set_droppable_key(droppable_key_t value);
+
+	/**
+	 * \brief Sets the class of packages of [key], packages are [Priority::Normal] by default. It applies to packages
+	 * put from now on, so to keep packages of the key in order it's set before any of them are put. Packages of other
+	 * lanes may overtake them and be overtaken by them, so it's only for keys none of the rest depend on, and keys
+	 * which are ordered, see [set_ordered], keep their lane.
+	 */
+	void set_priority(int64_t key, Priority priority);
+
+	void set_weights(Weights value);
+
+	/**
+	 * \brief Keeps packages of [key] in the order they are put with respect to packages of all keys and lanes: they
+	 * neither overtake packages put before them nor are overtaken by packages put after them. It's for packages which
+	 * the rest depend on, e.g. ones announcing ids later packages refer to. Like [set_priority], it's set before any
+	 * package of the key is put.
+	 */
+	void set_ordered(int64_t key);
+
+	Stats get_stats() const;
 };
 
 std::string to_string(ByteBufferAsyncProcessor::StateKind state);
@@ -0,0 +1,245 @@
+#include "PackageCompression.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace rd
+{
+constexpr int32_t PackageCompression::COMPRESSED_FLAG;
+
+void PackageCompression::set_settings(Settings value)
+{
+	threshold = value.threshold;
+	codec = value.codec;
+}
+
+bool PackageCompression::compress(Buffer::word_t const* src, size_t size, Buffer::ByteArray& dst)
+{
+	if (codec.load() == Codec::NONE || size < threshold.load())
+	{
+		return false;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const int32_t raw_size = static_cast<int32_t>(size);
+	dst.resize(sizeof(raw_size) + lz4::compress_bound(size));
+	std::memcpy(dst.data(), &raw_size, sizeof(raw_size));
+	const size_t compressed = sizeof(raw_size) + lz4::compress(src, size, dst.data() + sizeof(raw_size));
+	dst.resize(compressed);
+	compress_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	if (compressed >= size)
+	{
+		return false;
+	}
+	++compressed_packages;
+	bytes_before += size;
+	bytes_after += compressed;
+	return true;
+}
+
+int32_t PackageCompression::uncompressed_size(Buffer::word_t const* src, size_t size)
+{
+	int32_t raw_size = -1;
+	if (size >= sizeof(raw_size))
+	{
+		std::memcpy(&raw_size, src, sizeof(raw_size));
+	}
+	return raw_size >= 0 ? raw_size : -1;
+}
+
+bool PackageCompression::decompress(Buffer::word_t const* src, size_t size, Buffer::word_t* dst)
+{
+	const int32_t raw_size = uncompressed_size(src, size);
+	if (raw_size < 0)
+	{
+		return false;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const bool result = lz4::decompress(src + sizeof(raw_size), size - sizeof(raw_size), dst, static_cast<size_t>(raw_size));
+	decompress_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	++decompressed_packages;
+	return result;
+}
+
+PackageCompression::Stats PackageCompression::get_stats() const
+{
+	return Stats{compressed_packages, bytes_before, bytes_after, decompressed_packages,
+		std::chrono::microseconds(compress_time.load()), std::chrono::microseconds(decompress_time.load())};
+}
+
+namespace lz4
+{
+namespace
+{
+constexpr size_t MIN_MATCH = 4;
+// the last match has to start this far from the end of the block and the last 5 bytes are always literals
+constexpr size_t MATCH_FIND_LIMIT = 12;
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MAX_OFFSET = 0xffff;
+constexpr int HASH_LOG = 12;
+
+uint32_t read32(uint8_t const* p)
+{
+	uint32_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+uint32_t hash(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+uint8_t* write_length(uint8_t* out, size_t length)
+{
+	for (; length >= 255; length -= 255)
+	{
+		*out++ = 255;
+	}
+	*out++ = static_cast<uint8_t>(length);
+	return out;
+}
+
+uint8_t* write_literals(uint8_t* out, uint8_t* token, uint8_t const* literals, size_t count)
+{
+	*token = static_cast<uint8_t>((std::min)(count, size_t{15}) << 4);
+	if (count >= 15)
+	{
+		out = write_length(out, count - 15);
+	}
+	std::memcpy(out, literals, count);
+	return out + count;
+}
+
+bool read_length(uint8_t const* src, size_t size, size_t& ip, size_t& length)
+{
+	uint8_t byte;
+	do
+	{
+		if (ip >= size)
+		{
+			return false;
+		}
+		byte = src[ip++];
+		length += byte;
+	} while (byte == 255);
+	return true;
+}
+}	 // namespace
+
+size_t compress_bound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t compress(uint8_t const* src, size_t size, uint8_t* dst)
+{
+	uint8_t* out = dst;
+	size_t anchor = 0;
+	if (size > MATCH_FIND_LIMIT)
+	{
+		uint32_t table[1u << HASH_LOG] = {};
+		const size_t match_find_end = size - MATCH_FIND_LIMIT;
+		const size_t match_end = size - LAST_LITERALS;
+		size_t i = 1;
+		while (i < match_find_end)
+		{
+			const uint32_t sequence = read32(src + i);
+			const uint32_t h = hash(sequence);
+			const size_t candidate = table[h];
+			table[h] = static_cast<uint32_t>(i);
+			if (i - candidate > MAX_OFFSET || read32(src + candidate) != sequence)
+			{
+				// skip faster through data which doesn't compress
+				i += 1 + ((i - anchor) >> 6);
+				continue;
+			}
+
+			size_t length = MIN_MATCH;
+			while (i + length < match_end && src[candidate + length] == src[i + length])
+			{
+				++length;
+			}
+
+			uint8_t* token = out++;
+			out = write_literals(out, token, src + anchor, i - anchor);
+			const uint16_t offset = static_cast<uint16_t>(i - candidate);
+			*out++ = static_cast<uint8_t>(offset);
+			*out++ = static_cast<uint8_t>(offset >> 8);
+			const size_t match = length - MIN_MATCH;
+			*token |= static_cast<uint8_t>((std::min)(match, size_t{15}));
+			if (match >= 15)
+			{
+				out = write_length(out, match - 15);
+			}
+
+			i += length;
+			anchor = i;
+		}
+	}
+	uint8_t* token = out++;
+	out = write_literals(out, token, src + anchor, size - anchor);
+	return static_cast<size_t>(out - dst);
+}
+
+bool decompress(uint8_t const* src, size_t size, uint8_t* dst, size_t decompressed_size)
+{
+	size_t ip = 0;
+	size_t op = 0;
+	while (ip < size)
+	{
+		const uint8_t token = src[ip++];
+
+		size_t literals = token >> 4;
+		if (literals == 15 && !read_length(src, size, ip, literals))
+		{
+			return false;
+		}
+		if (literals > size - ip || literals > decompressed_size - op)
+		{
+			return false;
+		}
+		std::memcpy(dst + op, src + ip, literals);
+		ip += literals;
+		op += literals;
+		if (ip == size)
+		{
+			break;	  // the last sequence has literals only
+		}
+
+		if (size - ip < 2)
+		{
+			return false;
+		}
+		const size_t offset = src[ip] | (static_cast<size_t>(src[ip + 1]) << 8);
+		ip += 2;
+		size_t length = token & 15;
+		if (length == 15 && !read_length(src, size, ip, length))
+		{
+			return false;
+		}
+		length += MIN_MATCH;
+		if (offset == 0 || offset > op || length > decompressed_size - op)
+		{
+			return false;
+		}
+		if (offset >= length)
+		{
+			std::memcpy(dst + op, dst + op - offset, length);
+			op += length;
+		}
+		else
+		{
+			// overlapping match repeats the last [offset] bytes
+			for (size_t k = 0; k < length; ++k, ++op)
+			{
+				dst[op] = dst[op - offset];
+			}
+		}
+	}
+	return op == decompressed_size;
+}
+}	 // namespace lz4
+}	 // namespace rd
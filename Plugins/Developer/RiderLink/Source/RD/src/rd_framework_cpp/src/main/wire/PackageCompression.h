@@ -0,0 +1,122 @@
+#ifndef RD_CPP_PACKAGECOMPRESSION_H
+#define RD_CPP_PACKAGECOMPRESSION_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "protocol/Buffer.h"
+
+#include <atomic>
+#include <chrono>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Optional compression of packages sent by [SocketWire]. A compressed package is marked by [COMPRESSED_FLAG]
+ * in the length of its header, its payload is the int32_t uncompressed size followed by the compressed block.
+ * Marked packages are always accepted, [Settings] only control what's sent.
+ */
+class RD_FRAMEWORK_API PackageCompression
+{
+public:
+	enum class Codec : uint8_t
+	{
+		NONE,
+		/**
+		 * \brief LZ4 block format.
+		 */
+		LZ4
+	};
+
+	struct Settings
+	{
+		Codec codec = Codec::NONE;
+
+		/**
+		 * \brief Packages smaller than this are sent as is.
+		 */
+		size_t threshold = 512;
+	};
+
+	struct Stats
+	{
+		uint64_t compressed_packages;
+
+		/**
+		 * \brief Size of compressed packages before and after compression, packages sent as is aren't counted.
+		 */
+		uint64_t bytes_before;
+		uint64_t bytes_after;
+
+		uint64_t decompressed_packages;
+
+		std::chrono::microseconds compress_time;
+		std::chrono::microseconds decompress_time;
+	};
+
+	static constexpr int32_t COMPRESSED_FLAG = 1 << 30;
+
+private:
+	std::atomic<Codec> codec{Codec::NONE};
+	std::atomic<size_t> threshold{Settings{}.threshold};
+
+	std::atomic<uint64_t> compressed_packages{0};
+	std::atomic<uint64_t> bytes_before{0};
+	std::atomic<uint64_t> bytes_after{0};
+	std::atomic<uint64_t> decompressed_packages{0};
+	std::atomic<int64_t> compress_time{0};
+	std::atomic<int64_t> decompress_time{0};
+
+public:
+	void set_settings(Settings value);
+
+	/**
+	 * \brief Compresses [size] bytes of [src] into [dst] unless compression is off, the package is below the threshold
+	 * or doesn't get smaller.
+	 * \return true if [dst] holds the compressed payload to send instead of [src]
+	 */
+	bool compress(Buffer::word_t const* src, size_t size, Buffer::ByteArray& dst);
+
+	/**
+	 * \return uncompressed size stored in a compressed payload, -1 if it's malformed
+	 */
+	static int32_t uncompressed_size(Buffer::word_t const* src, size_t size);
+
+	/**
+	 * \brief Decompresses a payload of [size] bytes into [dst] of [uncompressed_size] bytes.
+	 * \return false if the payload is malformed
+	 */
+	bool decompress(Buffer::word_t const* src, size_t size, Buffer::word_t* dst);
+
+	Stats get_stats() const;
+};
+
+namespace lz4
+{
+/**
+ * \return max size of a block compressed from [size] bytes
+ */
+size_t compress_bound(size_t size);
+
+/**
+ * \brief Compresses [size] bytes of [src] into [dst] of at least [compress_bound] bytes.
+ * \return size of the compressed block
+ */
+size_t compress(uint8_t const* src, size_t size, uint8_t* dst);
+
+/**
+ * \brief Decompresses a block of [size] bytes into exactly [decompressed_size] bytes of [dst].
+ * \return false if the block is malformed or doesn't decompress to [decompressed_size] bytes
+ */
+bool decompress(uint8_t const* src, size_t size, uint8_t* dst, size_t decompressed_size);
+}	 // namespace lz4
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_PACKAGECOMPRESSION_H
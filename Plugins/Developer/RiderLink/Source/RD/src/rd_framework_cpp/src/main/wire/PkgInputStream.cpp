@@ -3,54 +3,131 @@
 #include "PkgInputStream.h"
 
 #include <algorithm>
+#include <mutex>
+#include <vector>
 
 namespace rd
 {
-void PkgInputStream::rewind()
+/**
+ * \brief Keeps slabs released by dispatched messages to receive following packages into. Slabs grown by a large
+ * package beyond [MAX_SLAB_SIZE] are freed instead of being kept, so a burst of large messages doesn't pin memory.
+ */
+class PkgInputStream::SlabPool
 {
-	buffer.rewind();
-}
+	static constexpr size_t MAX_FREE_SLABS = 16;
+
+	std::mutex lock;
+
+	std::vector<std::unique_ptr<Buffer::ByteArray>> free;
+
+public:
+	std::unique_ptr<Buffer::ByteArray> take()
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (free.empty())
+		{
+			return std::make_unique<Buffer::ByteArray>();
+		}
+		auto res = std::move(free.back());
+		free.pop_back();
+		return res;
+	}
+
+	void give(std::unique_ptr<Buffer::ByteArray> slab)
+	{
+		if (slab->capacity() > MAX_SLAB_SIZE)
+		{
+			return;
+		}
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (free.size() < MAX_FREE_SLABS)
+		{
+			free.push_back(std::move(slab));
+		}
+	}
+};
 
-void PkgInputStream::require_available(int size)
+constexpr size_t PkgInputStream::SlabPool::MAX_FREE_SLABS;
+constexpr size_t PkgInputStream::MAX_SLAB_SIZE;
+
+std::shared_ptr<PkgInputStream::SlabPool> PkgInputStream::make_pool()
 {
-	buffer.require_available(size);
+	return std::make_shared<SlabPool>();
 }
 
-size_t PkgInputStream::get_position() const
+Buffer::word_t* PkgInputStream::acquire(size_t size)
 {
-	return buffer.get_position();
+	if (package != nullptr && package->capacity() > MAX_SLAB_SIZE && size <= MAX_SLAB_SIZE)
+	{
+		// the slab of a large package isn't kept for the small ones following it
+		package.reset();
+	}
+	if (package == nullptr || package.use_count() > 1)
+	{
+		std::weak_ptr<SlabPool> weak_pool = pool;
+		package = std::shared_ptr<Buffer::ByteArray>(pool->take().release(), [weak_pool](Buffer::ByteArray* slab) {
+			std::unique_ptr<Buffer::ByteArray> holder(slab);
+			if (auto p = weak_pool.lock())
+			{
+				p->give(std::move(holder));
+			}
+		});
+	}
+	if (package->size() < size)
+	{
+		package->resize(size);
+	}
+	position = 0;
+	return package->data();
 }
 
-Buffer::word_t* PkgInputStream::data()
+void PkgInputStream::push(int32_t size)
 {
-	return buffer.data();
+	memory = size;
+	position = 0;
 }
 
-Buffer& PkgInputStream::get_buffer()
+size_t PkgInputStream::available() const
 {
-	return buffer;
+	return memory - position;
 }
 
-int32_t PkgInputStream::try_read(Buffer::word_t* res, size_t size)
+bool PkgInputStream::next_package()
 {
-	if (memory == -1 || buffer.get_position() == memory)
+	do
 	{
 		memory = request_data();
 		if (memory == -1)
 		{
-			return -1;
+			return false;
 		}
+		position = 0;
+	} while (memory == 0);
+	return true;
+}
+
+bool PkgInputStream::exhausted() const
+{
+	// -1 is left by a connection which ended, the next read requests a package of the following one
+	return memory == -1 || position == static_cast<size_t>(memory);
+}
+
+int32_t PkgInputStream::try_read(Buffer::word_t* res, size_t size)
+{
+	if (exhausted() && !next_package())
+	{
+		return -1;
 	}
-	const int32_t n = static_cast<int32_t>((std::min)(size, memory - buffer.get_position()));
-	Buffer::word_t* start = buffer.current_pointer();
+	const int32_t n = static_cast<int32_t>((std::min)(size, memory - position));
+	Buffer::word_t const* start = package->data() + position;
 	std::copy(start, start + n, res);
-	buffer.set_position(buffer.get_position() + n);
+	position += n;
 	return n;
 }
 
 bool PkgInputStream::read(Buffer::word_t* res, size_t size)
 {
-	//		spdlog::trace("PkgInputStream call: size={}, pos={}, memory={}", size, buffer.get_position(), memory);
+	//		spdlog::trace("PkgInputStream call: size={}, pos={}, memory={}", size, position, memory);
 
 	int32_t summary_size = 0;
 	while (summary_size < size)
@@ -64,4 +141,21 @@ bool PkgInputStream::read(Buffer::word_t* res, size_t size)
 	}
 	return true;
 }
+
+bool PkgInputStream::read_message(Buffer& message, size_t size)
+{
+	if (size > 0 && exhausted() && !next_package())
+	{
+		return false;
+	}
+	if (memory != -1 && static_cast<size_t>(memory) - position >= size)
+	{
+		message = Buffer(package, position, size);
+		position += size;
+		return true;
+	}
+	// message is split between packages, it has to be assembled
+	message = Buffer(size);
+	return read(message.data(), size);
+}
 }	 // namespace rd
@@ -8,39 +8,73 @@
 
 #include "protocol/Buffer.h"
 
+#include <memory>
+
 #include <rd_framework_export.h>
 
 namespace rd
 {
+/**
+ * \brief Reads messages out of a sequence of packages. Every package is received into a refcounted slab, messages
+ * which fit into a single package are handed out as views of that slab without copying.
+ */
 class RD_FRAMEWORK_API PkgInputStream
 {
 private:
-	Buffer buffer;
+	class SlabPool;
+
+	std::shared_ptr<SlabPool> pool;
+
+	std::shared_ptr<Buffer::ByteArray> package;
+
+	size_t position = 0;
+
+	int32_t memory = 0;
 
 	std::function<int32_t()> request_data;
 
-	size_t memory = 0;
+	static std::shared_ptr<SlabPool> make_pool();
+
+	bool next_package();
+
+	bool exhausted() const;
 
 public:
+	/**
+	 * \brief Slabs grown beyond this by a large package are freed once it's no longer referenced, rather than reused.
+	 */
+	static constexpr size_t MAX_SLAB_SIZE = 64 * 1024;
+
 	template <typename F>
-	explicit PkgInputStream(F&& f) : request_data(std::forward<F>(f))
+	explicit PkgInputStream(F&& f) : pool(make_pool()), request_data(std::forward<F>(f))
 	{
 	}
 
-	void rewind();
-
-	void require_available(int size);
+	/**
+	 * \brief Prepares a slab for the next package, slabs still referenced by dispatched messages are not reused.
+	 * \param size of the package
+	 * \return pointer to write package data to
+	 */
+	Buffer::word_t* acquire(size_t size);
 
-	size_t get_position() const;
+	/**
+	 * \brief Makes the package of [size] bytes written to the last acquired slab current without requesting it, for
+	 * wires which receive packages as the socket becomes readable. Reads must not go beyond [available] then.
+	 */
+	void push(int32_t size);
 
-	Buffer::word_t* data();
-
-	Buffer& get_buffer();
+	size_t available() const;
 
 	int32_t try_read(Buffer::word_t* res, size_t size);
 
 	bool read(Buffer::word_t* res, size_t size);
 
+	/**
+	 * \brief Reads next [size] bytes into [message]. If they lie in the current package [message] becomes a view of
+	 * it, otherwise they are copied into a buffer owned by [message].
+	 */
+	bool read_message(Buffer& message, size_t size);
+
 	template <typename T>
 	T read_integral()
 	{
@@ -0,0 +1,618 @@
+#include "wire/SharedMemoryWire.h"
+
+#ifdef RD_SHARED_MEMORY_WIRE_SUPPORTED
+
+#include <util/thread_util.h>
+#include "std/unordered_map.h"
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace rd
+{
+struct SharedMemoryWire::Ring
+{
+	// bytes written and read so far, the ring holds [head - tail] of them
+	alignas(64) std::atomic<uint64_t> head{0};
+	alignas(64) std::atomic<uint64_t> tail{0};
+	// futex words bumped to wake the reader waiting for data and the writer waiting for space
+	alignas(64) std::atomic<uint32_t> readable{0};
+	std::atomic<uint32_t> reader_waiting{0};
+	std::atomic<uint32_t> writable{0};
+	std::atomic<uint32_t> writer_waiting{0};
+};
+
+struct SharedMemoryWire::Segment
+{
+	static constexpr uint32_t MAGIC = 0x52445348;	 // "RDSH"
+	static constexpr uint32_t VERSION = 1;
+
+	const uint32_t magic = MAGIC;
+	const uint32_t version = VERSION;
+	const uint64_t capacity;
+	// processes of the server and the client, 0 until the client attaches
+	std::atomic<int32_t> pids[2];
+	// futex word bumped when the client attaches
+	std::atomic<uint32_t> attached{0};
+	std::atomic<uint32_t> closed{0};
+	// the server writes to the first ring, data of both follows the segment
+	Ring rings[2];
+
+	explicit Segment(uint64_t capacity) : capacity(capacity)
+	{
+		pids[0] = static_cast<int32_t>(getpid());
+		pids[1] = 0;
+	}
+};
+
+constexpr uint32_t SharedMemoryWire::Segment::MAGIC;
+constexpr uint32_t SharedMemoryWire::Segment::VERSION;
+constexpr size_t SharedMemoryWire::DEFAULT_CAPACITY;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+	"futex words have to be plain 32-bit integers");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring positions are shared between processes");
+
+namespace
+{
+constexpr long WAIT_TIMEOUT_NS = 100 * 1000 * 1000;
+constexpr std::chrono::milliseconds FLUSH_TIMEOUT{500};
+
+uint32_t* futex_address(std::atomic<uint32_t>& word)
+{
+	return reinterpret_cast<uint32_t*>(&word);
+}
+
+// not FUTEX_PRIVATE_FLAG: the word is in memory shared with another process
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected)
+{
+	timespec timeout{0, WAIT_TIMEOUT_NS};
+	syscall(SYS_futex, futex_address(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t>& word)
+{
+	syscall(SYS_futex, futex_address(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+void notify(std::atomic<uint32_t>& word)
+{
+	++word;
+	futex_wake(word);
+}
+
+bool is_process_alive(int32_t pid)
+{
+	return pid == 0 || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+// messages start with their length followed by the recipient id
+RdId message_id(Buffer::ByteArray const& message)
+{
+	RdId::hash_t hash = 0;
+	if (message.size() >= sizeof(int32_t) + sizeof(hash))
+	{
+		memcpy(&hash, message.data() + sizeof(int32_t), sizeof(hash));
+	}
+	return RdId(hash);
+}
+
+size_t round_capacity(size_t capacity)
+{
+	size_t result = 4096;
+	while (result < capacity)
+	{
+		result <<= 1;
+	}
+	return result;
+}
+}	 // namespace
+
+std::shared_ptr<spdlog::logger> SharedMemoryWire::Base::logger =
+	spdlog::stderr_color_mt<spdlog::synchronous_factory>("sharedMemoryWireLog", spdlog::color_mode::automatic);
+
+SharedMemoryWire::Base::Base(std::string id, Lifetime parentLifetime, IScheduler* scheduler)
+	: WireBase(scheduler), id(std::move(id)), lifetimeDef(parentLifetime)
+{
+	lifetimeDef.lifetime->add_action([this] {
+		logger->info("{}: start terminating lifetime", this->id);
+		close();
+		unmap();
+		logger->info("{}: termination finished", this->id);
+	});
+}
+
+SharedMemoryWire::Base::~Base()
+{
+	if (!lifetimeDef.is_terminated())
+	{
+		lifetimeDef.terminate();
+	}
+}
+
+bool SharedMemoryWire::Base::wait(std::atomic<uint32_t>& word, uint32_t expected) const
+{
+	if (stopped || segment->closed.load() != 0)
+	{
+		return false;
+	}
+	futex_wait(word, expected);
+	return !stopped && segment->closed.load() == 0 && is_process_alive(segment->pids[1 - side].load());
+}
+
+bool SharedMemoryWire::Base::try_write(Buffer::word_t const* data, size_t size) const
+{
+	Ring& ring = *out_ring;
+	const uint64_t head = ring.head.load(std::memory_order_relaxed);
+	if (capacity - (head - ring.tail.load()) < size)
+	{
+		return false;
+	}
+	const size_t offset = static_cast<size_t>(head) & (capacity - 1);
+	const size_t first = (std::min)(size, capacity - offset);
+	memcpy(out_data + offset, data, first);
+	memcpy(out_data, data + first, size - first);
+	ring.head.store(head + size);
+	if (ring.reader_waiting.load() != 0)
+	{
+		notify(ring.readable);
+	}
+	return true;
+}
+
+bool SharedMemoryWire::Base::write(Buffer::word_t const* data, size_t size) const
+{
+	Ring& ring = *out_ring;
+	while (size > 0)
+	{
+		const uint64_t head = ring.head.load(std::memory_order_relaxed);
+		size_t space = static_cast<size_t>(capacity - (head - ring.tail.load()));
+		if (space == 0)
+		{
+			// announce waiting before checking again, so the reader either sees it or is seen freeing space
+			const uint32_t expected = ring.writable.load();
+			ring.writer_waiting = 1;
+			const bool alive = capacity - (head - ring.tail.load()) != 0 || wait(ring.writable, expected);
+			ring.writer_waiting = 0;
+			if (!alive)
+			{
+				return false;
+			}
+			continue;
+		}
+		const size_t chunk = (std::min)(size, space);
+		try_write(data, chunk);
+		data += chunk;
+		size -= chunk;
+	}
+	return true;
+}
+
+bool SharedMemoryWire::Base::read(Buffer::word_t* data, size_t size) const
+{
+	Ring& ring = *in_ring;
+	while (size > 0)
+	{
+		const uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+		const size_t available = static_cast<size_t>(ring.head.load() - tail);
+		if (available == 0)
+		{
+			const uint32_t expected = ring.readable.load();
+			ring.reader_waiting = 1;
+			const bool alive = ring.head.load() != tail || wait(ring.readable, expected);
+			ring.reader_waiting = 0;
+			// data written before the other side closed is still read
+			if (!alive && (stopped || ring.head.load() == tail))
+			{
+				return false;
+			}
+			continue;
+		}
+		const size_t chunk = (std::min)(size, available);
+		const size_t offset = static_cast<size_t>(tail) & (capacity - 1);
+		const size_t first = (std::min)(chunk, capacity - offset);
+		memcpy(data, in_data + offset, first);
+		memcpy(data + first, in_data, chunk - first);
+		ring.tail.store(tail + chunk);
+		if (ring.writer_waiting.load() != 0)
+		{
+			notify(ring.writable);
+		}
+		data += chunk;
+		size -= chunk;
+	}
+	return true;
+}
+
+bool SharedMemoryWire::Base::read_and_dispatch_message() const
+{
+	int32_t sz;
+	RdId::hash_t rd_id;
+	if (!read(reinterpret_cast<Buffer::word_t*>(&sz), sizeof(sz)) ||
+		!read(reinterpret_cast<Buffer::word_t*>(&rd_id), sizeof(rd_id)))
+	{
+		return false;
+	}
+	RD_ASSERT_THROW_MSG(sz >= static_cast<int32_t>(sizeof(rd_id)), fmt::format("{}: broken message, sz={}", this->id, sz));
+	const int32_t max_size = max_message_size;
+	RD_ASSERT_THROW_MSG(sz <= max_size,
+		fmt::format("{}: message of {} bytes exceeds the maximum message size of {} bytes", this->id, sz, max_size));
+
+	Buffer message(static_cast<size_t>(sz) - sizeof(rd_id));
+	if (!read(message.data(), static_cast<size_t>(sz) - sizeof(rd_id)))
+	{
+		return false;
+	}
+	message.set_encoding(encoding);
+	message_broker.dispatch(RdId(rd_id), std::move(message));
+	return true;
+}
+
+void SharedMemoryWire::Base::start(int value)
+{
+	side = value;
+	capacity = static_cast<size_t>(segment->capacity);
+	auto* data = reinterpret_cast<Buffer::word_t*>(segment + 1);
+	out_ring = &segment->rings[side];
+	in_ring = &segment->rings[1 - side];
+	out_data = data + capacity * side;
+	in_data = data + capacity * (1 - side);
+
+	receiver = std::thread([this] {
+		rd::util::set_thread_name(this->id.empty() ? "SharedMemoryWire Thread" : this->id.c_str());
+		receive();
+	});
+	sender = std::thread([this] {
+		rd::util::set_thread_name(this->id.empty() ? "SharedMemoryWire Send Thread" : (this->id + "-Send").c_str());
+		send_pending();
+	});
+}
+
+void SharedMemoryWire::Base::receive()
+{
+	while (segment->pids[1].load() == 0)
+	{
+		const uint32_t expected = segment->attached.load();
+		if (segment->pids[1].load() == 0 && !wait(segment->attached, expected))
+		{
+			return;
+		}
+	}
+
+	logger->info("{}: connected, process {}", this->id, segment->pids[1 - side].load());
+	connected.set(true);
+	heartbeatAlive.set(true);
+	try
+	{
+		while (read_and_dispatch_message())
+		{
+		}
+	}
+	catch (std::exception const& e)
+	{
+		logger->error("{}: receiving failed: {}", this->id, e.what());
+		// the rest of the ring can't be framed after a broken message, so the other side is disconnected as well
+		close_segment();
+	}
+	heartbeatAlive.set(false);
+	connected.set(false);
+	logger->info("{}: disconnected", this->id);
+}
+
+void SharedMemoryWire::Base::send_pending()
+{
+	std::unique_lock<decltype(send_lock)> guard(send_lock);
+	while (true)
+	{
+		send_cv.wait(guard, [this] { return stopped || !pending.empty(); });
+		if (stopped)
+		{
+			return;
+		}
+		Buffer::ByteArray message = std::move(pending.front());
+		pending.pop_front();
+		pending_bytes -= message.size();
+		streaming = true;
+		guard.unlock();
+		const bool sent = write(message.data(), message.size());
+		guard.lock();
+		streaming = false;
+		send_cv.notify_all();
+		if (!sent)
+		{
+			logger->debug("{}: closed, {} messages dropped", this->id, pending.size() + 1);
+			pending.clear();
+			pending_bytes = 0;
+			send_cv.notify_all();
+			return;
+		}
+	}
+}
+
+void SharedMemoryWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
+{
+	send(rd_id, 0, std::move(writer));
+}
+
+void SharedMemoryWire::Base::send(RdId const& rd_id, size_t size, std::function<void(Buffer& buffer)> writer) const
+{
+	RD_ASSERT_MSG(!rd_id.isNull(), "{}: id mustn't be null");
+	const SendScope scope(*this);
+
+	// same layout as messages of SocketWire: length, id and context precede the data
+	Buffer local_send_buffer(sizeof(int32_t) + sizeof(RdId::hash_t) + sizeof(int16_t) + size);
+	local_send_buffer.set_encoding(encoding);
+	local_send_buffer.write_integral<int32_t>(0);	 // placeholder for length
+	rd_id.write(local_send_buffer);					 // write id
+	local_send_buffer.write_integral<int16_t>(0);	 // placeholder for context
+	writer(local_send_buffer);						 // write rest
+
+	const size_t len = local_send_buffer.get_position();
+	local_send_buffer.rewind();
+	local_send_buffer.write_integral<int32_t>(static_cast<int32_t>(len - sizeof(int32_t)));
+	local_send_buffer.set_position(len);
+
+	std::unique_lock<decltype(send_lock)> guard(send_lock);
+	if (stopped || segment == nullptr)
+	{
+		logger->trace("{}: closed, message for id {} dropped", this->id, to_string(rd_id));
+		return;
+	}
+	// the fast path writes from the sending thread, unless it would overtake messages left to [sender]
+	if (pending.empty() && !streaming && try_write(local_send_buffer.data(), len))
+	{
+		return;
+	}
+	Buffer::ByteArray message = std::move(local_send_buffer).getRealArray();
+	RD_ASSERT_THROW_MSG(reserve_space(guard, message),
+		fmt::format("{}: message for id {} rejected, send window is full", this->id, to_string(rd_id)));
+	if (stopped)
+	{
+		return;
+	}
+	pending_bytes += message.size();
+	pending.push_back(std::move(message));
+	send_cv.notify_all();
+}
+
+bool SharedMemoryWire::Base::fits(size_t size) const
+{
+	if (pending.empty())
+	{
+		// a message larger than the whole window still goes through an empty one
+		return true;
+	}
+	return (limits.max_bytes == 0 || pending_bytes + size <= limits.max_bytes) &&
+		   (limits.max_messages == 0 || pending.size() + 1 <= limits.max_messages);
+}
+
+void SharedMemoryWire::Base::drop_superseded(Buffer::ByteArray const& new_data) const
+{
+	if (droppable_ids.empty())
+	{
+		return;
+	}
+	rd::unordered_map<RdId, int32_t> later;
+	for (auto const& message : pending)
+	{
+		const RdId rd_id = message_id(message);
+		if (droppable_ids.count(rd_id) > 0)
+		{
+			++later[rd_id];
+		}
+	}
+	const RdId new_id = message_id(new_data);
+	if (droppable_ids.count(new_id) > 0)
+	{
+		++later[new_id];
+	}
+	for (auto it = pending.begin(); it != pending.end() && !fits(new_data.size());)
+	{
+		auto count = later.find(message_id(*it));
+		if (count != later.end() && count->second-- > 1)
+		{
+			pending_bytes -= it->size();
+			++dropped_messages;
+			it = pending.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+bool SharedMemoryWire::Base::reserve_space(std::unique_lock<std::mutex>& guard, Buffer::ByteArray const& new_data) const
+{
+	if (fits(new_data.size()))
+	{
+		return true;
+	}
+	switch (limits.policy)
+	{
+		case ByteBufferAsyncProcessor::OverflowPolicy::Block:
+			// [sender] notifies after each streamed message
+			send_cv.wait_for(guard, limits.block_timeout, [this, &new_data] { return stopped || fits(new_data.size()); });
+			break;
+		case ByteBufferAsyncProcessor::OverflowPolicy::DropOldest:
+			drop_superseded(new_data);
+			break;
+		case ByteBufferAsyncProcessor::OverflowPolicy::Fail:
+			break;
+	}
+	if (stopped || fits(new_data.size()))
+	{
+		return true;
+	}
+	++rejected_messages;
+	logger->warn("{}: message of {} bytes rejected, {} bytes in {} messages wait to be sent", this->id, new_data.size(),
+		pending_bytes, pending.size());
+	return false;
+}
+
+void SharedMemoryWire::Base::set_max_message_size(int32_t size)
+{
+	max_message_size = size;
+}
+
+void SharedMemoryWire::Base::set_send_limits(ByteBufferAsyncProcessor::Limits value)
+{
+	{
+		std::lock_guard<decltype(send_lock)> guard(send_lock);
+		limits = value;
+	}
+	send_cv.notify_all();
+}
+
+void SharedMemoryWire::Base::mark_droppable(RdId const& rd_id)
+{
+	std::lock_guard<decltype(send_lock)> guard(send_lock);
+	droppable_ids.insert(rd_id);
+}
+
+ByteBufferAsyncProcessor::Stats SharedMemoryWire::Base::get_send_stats() const
+{
+	std::lock_guard<decltype(send_lock)> guard(send_lock);
+	return ByteBufferAsyncProcessor::Stats{pending_bytes, pending.size(), 0, 0, dropped_messages, rejected_messages};
+}
+
+void SharedMemoryWire::Base::close_segment() const
+{
+	segment->closed = 1;
+	notify(segment->attached);
+	for (Ring& ring : segment->rings)
+	{
+		notify(ring.readable);
+		notify(ring.writable);
+	}
+}
+
+void SharedMemoryWire::Base::close()
+{
+	{
+		// like SocketWire, messages sent before termination are flushed for a while
+		std::unique_lock<decltype(send_lock)> guard(send_lock);
+		send_cv.wait_for(guard, FLUSH_TIMEOUT, [this] { return !sender.joinable() || (pending.empty() && !streaming); });
+		stopped = true;
+		send_cv.notify_all();
+	}
+	if (segment != nullptr)
+	{
+		close_segment();
+	}
+	if (receiver.joinable())
+	{
+		receiver.join();
+	}
+	if (sender.joinable())
+	{
+		sender.join();
+	}
+}
+
+void SharedMemoryWire::Base::unmap()
+{
+	std::lock_guard<decltype(send_lock)> guard(send_lock);
+	if (mapping != nullptr)
+	{
+		munmap(mapping, mapping_size);
+		mapping = nullptr;
+		segment = nullptr;
+	}
+	if (fd != -1)
+	{
+		::close(fd);
+		fd = -1;
+	}
+}
+
+SharedMemoryWire::Server::Server(Lifetime lifetime, IScheduler* scheduler, size_t capacity, const std::string& id)
+	: Base(id, lifetime, scheduler)
+{
+	const size_t ring_capacity = round_capacity(capacity);
+	mapping_size = sizeof(Segment) + 2 * ring_capacity;
+	fd = memfd_create(this->id.c_str(), MFD_CLOEXEC);
+	if (fd == -1 || ftruncate(fd, static_cast<off_t>(mapping_size)) != 0)
+	{
+		logger->error("{}: creating shared memory failed: {}", this->id, strerror(errno));
+		unmap();
+		return;
+	}
+	mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED)
+	{
+		logger->error("{}: mapping shared memory failed: {}", this->id, strerror(errno));
+		mapping = nullptr;
+		unmap();
+		return;
+	}
+	segment = new (mapping) Segment(ring_capacity);
+	handle = fmt::format("{}:{}", getpid(), fd);
+	start(0);
+	logger->info("{}: started, handle: {}, capacity: {}", this->id, handle, ring_capacity);
+}
+
+SharedMemoryWire::Client::Client(Lifetime lifetime, IScheduler* scheduler, const std::string& handle, const std::string& id)
+	: Base(id, lifetime, scheduler)
+{
+	int32_t pid = 0;
+	int server_fd = -1;
+	if (sscanf(handle.c_str(), "%d:%d", &pid, &server_fd) != 2)
+	{
+		logger->warn("{}: malformed handle '{}'", this->id, handle);
+		return;
+	}
+	// the segment has no name, it's opened through the descriptor of the server process
+	const std::string path = fmt::format("/proc/{}/fd/{}", pid, server_fd);
+	fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+	struct stat status{};
+	if (fd == -1 || fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(Segment))
+	{
+		logger->warn("{}: opening shared memory {} failed: {}", this->id, path, strerror(errno));
+		unmap();
+		return;
+	}
+	mapping_size = static_cast<size_t>(status.st_size);
+	mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED)
+	{
+		logger->warn("{}: mapping shared memory failed: {}", this->id, strerror(errno));
+		mapping = nullptr;
+		unmap();
+		return;
+	}
+	segment = static_cast<Segment*>(mapping);
+	// offsets in rings are masked by the capacity, so it has to be a power of two, and both rings fill the mapping
+	const uint64_t ring_capacity = segment->capacity;
+	const bool valid_capacity = ring_capacity != 0 && (ring_capacity & (ring_capacity - 1)) == 0 &&
+								ring_capacity <= mapping_size / 2 && sizeof(Segment) + 2 * ring_capacity == mapping_size;
+	int32_t expected = 0;
+	if (segment->magic != Segment::MAGIC || segment->version != Segment::VERSION || !valid_capacity || segment->pids[0].load() != pid ||
+		!segment->pids[1].compare_exchange_strong(expected, static_cast<int32_t>(getpid())))
+	{
+		logger->warn("{}: shared memory {} is incompatible or already attached", this->id, path);
+		unmap();
+		return;
+	}
+	notify(segment->attached);
+	attached = true;
+	start(1);
+}
+}	 // namespace rd
+
+#endif	  // RD_SHARED_MEMORY_WIRE_SUPPORTED
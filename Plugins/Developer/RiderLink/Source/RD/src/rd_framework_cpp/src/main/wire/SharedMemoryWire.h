@@ -0,0 +1,235 @@
+#ifndef RD_CPP_SHAREDMEMORYWIRE_H
+#define RD_CPP_SHAREDMEMORYWIRE_H
+
+#if defined(__linux__)
+#define RD_SHARED_MEMORY_WIRE_SUPPORTED 1
+#endif
+
+#ifdef RD_SHARED_MEMORY_WIRE_SUPPORTED
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "scheduler/base/IScheduler.h"
+#include "base/WireBase.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "ByteBufferAsyncProcessor.h"
+#include "SocketWire.h"
+#include "std/unordered_set.h"
+
+#include "spdlog/spdlog.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Wire between two processes of the same host. Messages are copied into a pair of single producer single
+ * consumer byte rings in a shared memory segment, one per direction, and the side waiting for data or space sleeps on a
+ * futex in the segment. So a message takes no syscalls unless the other side sleeps, and no acks, pings or package
+ * headers are needed.
+ *
+ * [Server] creates the segment and publishes [Server::handle] the way [SocketWire::Server] publishes its port. [Client]
+ * opens the segment by the handle, if it can't (the handle is of another host or user, or of an incompatible version)
+ * [Client::is_attached] is false and the connection falls back to [SocketWire]. Messages use the same format as ones of
+ * [SocketWire], a wire connects once and stays disconnected after the other side terminates.
+ */
+class RD_FRAMEWORK_API SharedMemoryWire
+{
+	struct Segment;
+
+	struct Ring;
+
+public:
+	/**
+	 * \brief Bytes of each ring, messages larger than it are streamed through it.
+	 */
+	static constexpr size_t DEFAULT_CAPACITY = 1u << 20;
+
+	class RD_FRAMEWORK_API Base : public WireBase
+	{
+	protected:
+		static std::shared_ptr<spdlog::logger> logger;
+
+		std::string id;
+		LifetimeDefinition lifetimeDef;
+
+		int fd = -1;
+		void* mapping = nullptr;
+		size_t mapping_size = 0;
+		Segment* segment = nullptr;
+		// 0 for the server, 1 for the client, the side writes to the ring of its index
+		int side = 0;
+		size_t capacity = 0;
+		Ring* out_ring = nullptr;
+		Ring* in_ring = nullptr;
+		Buffer::word_t* out_data = nullptr;
+		Buffer::word_t* in_data = nullptr;
+
+		std::thread receiver;
+		std::thread sender;
+
+		mutable std::mutex send_lock;
+		mutable std::condition_variable send_cv;
+		// messages which didn't fit into the ring at once, [sender] streams them in order
+		mutable std::deque<Buffer::ByteArray> pending;
+		mutable size_t pending_bytes = 0;
+		mutable bool streaming = false;
+		// bound [pending] like the send window of SocketWire, guarded by [send_lock]
+		ByteBufferAsyncProcessor::Limits limits;
+		rd::unordered_set<RdId> droppable_ids;
+		mutable uint64_t dropped_messages = 0;
+		mutable uint64_t rejected_messages = 0;
+		std::atomic<bool> stopped{false};
+
+		/**
+		 * \brief Sizes of received messages come from the other side, ones above this are rejected before anything is
+		 * allocated for them and the connection is dropped, see [SocketWire::Base::max_message_size].
+		 */
+		std::atomic<int32_t> max_message_size{SocketWire::Base::DEFAULT_MAX_MESSAGE_SIZE};
+
+		/**
+		 * \brief Sleeps until [word] isn't [expected] or for a while.
+		 * \return false if the wire is closed or the other side is gone
+		 */
+		bool wait(std::atomic<uint32_t>& word, uint32_t expected) const;
+
+		/**
+		 * \brief Copies [size] bytes into the outgoing ring if they fit entirely.
+		 */
+		bool try_write(Buffer::word_t const* data, size_t size) const;
+
+		/**
+		 * \brief Copies [size] bytes into the outgoing ring, waiting for the other side to free space.
+		 * \return false if the wire is closed meanwhile
+		 */
+		bool write(Buffer::word_t const* data, size_t size) const;
+
+		/**
+		 * \brief Reads [size] bytes from the incoming ring, waiting for the other side to write them.
+		 * \return false if the wire is closed meanwhile
+		 */
+		bool read(Buffer::word_t* data, size_t size) const;
+
+		bool read_and_dispatch_message() const;
+
+		// requires [send_lock]
+		bool fits(size_t size) const;
+
+		/**
+		 * \brief Drops pending messages superseded by a later one of a droppable entity until [size] bytes fit, requires
+		 * [send_lock]. [new_data] is the message being sent.
+		 */
+		void drop_superseded(Buffer::ByteArray const& new_data) const;
+
+		/**
+		 * \brief Waits for, or makes, space in [pending] for [new_data] as [limits] say, requires [send_lock].
+		 * \return false if the message is rejected
+		 */
+		bool reserve_space(std::unique_lock<std::mutex>& guard, Buffer::ByteArray const& new_data) const;
+
+		/**
+		 * \brief Starts threads of the mapped segment as [side].
+		 */
+		void start(int side);
+
+		void receive();
+
+		void send_pending();
+
+		/**
+		 * \brief Marks the segment closed and wakes both sides, so neither of them waits for the other anymore.
+		 */
+		void close_segment() const;
+
+		void close();
+
+		void unmap();
+
+	public:
+		// region ctor/dtor
+
+		Base(std::string id, Lifetime parentLifetime, IScheduler* scheduler);
+
+		virtual ~Base();
+		// endregion
+
+		void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const override;
+
+		void send(RdId const& rd_id, size_t size, std::function<void(Buffer& buffer)> writer) const override;
+
+		/**
+		 * \brief Bounds memory held by messages which didn't fit into the ring and wait to be streamed, see
+		 * [ByteBufferAsyncProcessor::Limits]. Messages rejected by the limits make [send] throw.
+		 */
+		void set_send_limits(ByteBufferAsyncProcessor::Limits value);
+
+		/**
+		 * \brief Allows to drop waiting messages of entity [rd_id] under [ByteBufferAsyncProcessor::OverflowPolicy::DropOldest]
+		 * when a later message of the same entity is sent.
+		 */
+		void mark_droppable(RdId const& rd_id);
+
+		/**
+		 * \brief Largest message accepted from the other side, see [max_message_size].
+		 */
+		void set_max_message_size(int32_t size);
+
+		/**
+		 * \brief Messages waiting to be streamed are reported as queued, there are no pending ones since nothing is acknowledged.
+		 */
+		ByteBufferAsyncProcessor::Stats get_send_stats() const;
+	};
+
+	class RD_FRAMEWORK_API Server : public Base
+	{
+	public:
+		/**
+		 * \brief Identifies the segment for [Client], empty if it couldn't be created.
+		 */
+		std::string handle;
+
+		// region ctor/dtor
+
+		Server(Lifetime lifetime, IScheduler* scheduler, size_t capacity = DEFAULT_CAPACITY,
+			const std::string& id = "ServerSharedMemory");
+		// endregion
+	};
+
+	class RD_FRAMEWORK_API Client : public Base
+	{
+		bool attached = false;
+
+	public:
+		// region ctor/dtor
+
+		Client(Lifetime lifetime, IScheduler* scheduler, const std::string& handle, const std::string& id = "ClientSharedMemory");
+		// endregion
+
+		/**
+		 * \return true if the segment of the handle is opened and this is its only client
+		 */
+		bool is_attached() const
+		{
+			return attached;
+		}
+	};
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_SHARED_MEMORY_WIRE_SUPPORTED
+
+#endif	  // RD_CPP_SHAREDMEMORYWIRE_H
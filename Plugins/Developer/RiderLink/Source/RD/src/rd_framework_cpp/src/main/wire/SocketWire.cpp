@@ -1,4 +1,5 @@
 #include "wire/SocketWire.h"
+#include "protocol/Protocol.h"
 
 #include <util/thread_util.h>
 
@@ -11,6 +12,8 @@
 #include <utility>
 #include <thread>
 #include <csignal>
+#include <cstdio>
+#include <algorithm>
 
 namespace rd
 {
@@ -19,13 +22,35 @@ std::shared_ptr<spdlog::logger> SocketWire::Base::logger =
 
 std::chrono::milliseconds SocketWire::timeout = std::chrono::milliseconds(500);
 
+namespace
+{
+std::string address(uint16_t port, std::string const& path)
+{
+	return path.empty() ? fmt::format("127.0.0.1:{}", port) : path;
+}
+}	 // namespace
+
 constexpr int32_t SocketWire::Base::ACK_MESSAGE_LENGTH;
 constexpr int32_t SocketWire::Base::PING_MESSAGE_LENGTH;
 constexpr int32_t SocketWire::Base::PACKAGE_HEADER_LENGTH;
-
-SocketWire::Base::Base(std::string id, Lifetime parentLifetime, IScheduler* scheduler)
-	: WireBase(scheduler), id(std::move(id)), scheduler(scheduler), lifetimeDef(parentLifetime)
+constexpr int32_t SocketWire::Base::FRAGMENT_FLAG;
+constexpr int32_t SocketWire::Base::FRAGMENT_HEADER_LENGTH;
+constexpr int32_t SocketWire::Base::DEFAULT_MAX_MESSAGE_SIZE;
+constexpr int32_t SocketWire::Base::MAX_PACKAGES_PER_SEND;
+constexpr int32_t SocketWire::Base::DIRECT_RECEIVE_THRESHOLD;
+
+SocketWire::Base::Base(std::string id, Lifetime parentLifetime, IScheduler* scheduler, WireReactor* reactor)
+	: WireBase(scheduler), id(std::move(id)), scheduler(scheduler), reactor(reactor), lifetimeDef(parentLifetime)
 {
+#ifndef RD_WIRE_REACTOR_SUPPORTED
+	if (this->reactor != nullptr)
+	{
+		logger->warn("{}: wire reactor isn't supported on this platform, using own threads", this->id);
+		this->reactor = nullptr;
+	}
+#endif
+	// messages of other entities refer to ids the intern root announces, so lanes don't reorder it
+	async_send_buffer.set_ordered(RdId::Null().mix(Protocol::InternRootName).get_hash());
 	async_send_buffer.pause("initial");
 	async_send_buffer.start();
 	ping_pkg_header.write_integral(PING_MESSAGE_LENGTH);
@@ -68,30 +93,107 @@ void SocketWire::Base::receiverProc() const
 	}
 }
 
-bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seqn) const
+bool SocketWire::Base::send_vector(iovec* vec, int32_t count) const
+{
+#ifdef _WIN32
+	// clsocket emulates writev with a send per buffer and a Nagle toggling flush, so the batch is handed to WSASend
+	std::array<WSABUF, 2 * MAX_PACKAGES_PER_SEND + 1> buffers;
+	RD_ASSERT_MSG(count <= static_cast<int32_t>(buffers.size()), "too many buffers for a single send");
+#endif
+	while (count > 0)
+	{
+#ifdef _WIN32
+		for (int32_t i = 0; i < count; ++i)
+		{
+			buffers[i].buf = static_cast<CHAR*>(vec[i].iov_base);
+			buffers[i].len = static_cast<ULONG>(vec[i].iov_len);
+		}
+		DWORD bytes = 0;
+		const SOCKET descriptor = socket_provider->GetSocketDescriptor();
+		if (WSASend(descriptor, buffers.data(), static_cast<DWORD>(count), &bytes, 0, nullptr, nullptr) == SOCKET_ERROR)
+		{
+			socket_provider->TranslateSocketError();
+			return false;
+		}
+		int32_t sent = static_cast<int32_t>(bytes);
+#else
+		int32_t sent = socket_provider->Send(vec, count);
+#endif
+		if (sent <= 0)
+		{
+			return false;
+		}
+		// writev may stop in the middle of any buffer, skip what was written and retry with the rest
+		while (count > 0 && static_cast<size_t>(sent) >= vec->iov_len)
+		{
+			sent -= static_cast<int32_t>(vec->iov_len);
+			++vec;
+			--count;
+		}
+		if (count > 0)
+		{
+			vec->iov_base = static_cast<Buffer::word_t*>(vec->iov_base) + sent;
+			vec->iov_len -= sent;
+		}
+	}
+	return true;
+}
+
+bool SocketWire::Base::send0(ByteBufferAsyncProcessor::batch_t const& batch, sequence_number_t first_seqn) const
 {
 	try
 	{
 		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
 
-		int32_t msglen = static_cast<int32_t>(msg.size());
-
-		send_package_header.rewind();
-		send_package_header.write_integral(msglen);
-		send_package_header.write_integral(seqn);
+		// one more slot for the ack carried by the first packages
+		std::array<iovec, 2 * MAX_PACKAGES_PER_SEND + 1> vec{};
+		size_t total = 0;
+		for (size_t from = 0; from < batch.size(); from += MAX_PACKAGES_PER_SEND)
+		{
+			const size_t to = (std::min)(batch.size(), from + MAX_PACKAGES_PER_SEND);
 
-		RD_ASSERT_THROW_MSG(
-			socket_provider->Send(send_package_header.data(), send_package_header.get_position()) == PACKAGE_HEADER_LENGTH,
-			this->id +
-				": failed to send header over the network"
-				", reason: " +
-				socket_provider->DescribeError())
+			send_package_header.rewind();
+			int32_t count = 0;
+			if (from == 0 && write_ack())
+			{
+				vec[count].iov_base = ack_buffer.data();
+				vec[count].iov_len = PACKAGE_HEADER_LENGTH;
+				++count;
+			}
+			for (size_t i = from; i < to; ++i)
+			{
+				Buffer::ByteArray const* payload = batch[i];
+				// queued messages start with their length, fragments with the negated number of their message
+				int32_t first = 0;
+				std::copy(payload->data(), payload->data() + sizeof(first), reinterpret_cast<Buffer::word_t*>(&first));
+				int32_t len = static_cast<int32_t>(payload->size());
+				if (compression.compress(payload->data(), payload->size(), compressed_packages[i - from]))
+				{
+					payload = &compressed_packages[i - from];
+					len = static_cast<int32_t>(payload->size()) | PackageCompression::COMPRESSED_FLAG;
+				}
+				if (first < 0)
+				{
+					len |= FRAGMENT_FLAG;
+				}
+				send_package_header.write_integral(len);
+				send_package_header.write_integral(first_seqn + static_cast<sequence_number_t>(i));
+
+				vec[count].iov_base = send_package_header.data() + (i - from) * PACKAGE_HEADER_LENGTH;
+				vec[count].iov_len = PACKAGE_HEADER_LENGTH;
+				++count;
+				vec[count].iov_base = const_cast<Buffer::word_t*>(payload->data());
+				vec[count].iov_len = payload->size();
+				++count;
+				total += payload->size();
+			}
 
-		RD_ASSERT_THROW_MSG(socket_provider->Send(msg.data(), msglen) == msglen, this->id +
-																					 ": failed to send package over the network"
-																					 ", reason: " +
-																					 socket_provider->DescribeError());
-		logger->info("{}: were sent {} bytes", this->id, msglen);
+			RD_ASSERT_THROW_MSG(send_vector(vec.data(), count), this->id +
+																	": failed to send packages over the network"
+																	", reason: " +
+																	socket_provider->DescribeError());
+		}
+		logger->info("{}: were sent {} bytes in {} packages", this->id, total, batch.size());
 		//        RD_ASSERT_MSG(socketProvider->Flush(), "{}: failed to flush");
 		return true;
 	}
@@ -104,10 +206,28 @@ bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seq
 }
 
 void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
+{
+	send(rd_id, 0, std::move(writer));
+}
+
+void SocketWire::Base::send(RdId const& rd_id, size_t size, std::function<void(Buffer& buffer)> writer) const
+{
+	send0(RdId::Null(), rd_id, size, std::move(writer));
+}
+
+void SocketWire::Base::send_reply(RdId const& origin, RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
+{
+	send0(origin, rd_id, 0, std::move(writer));
+}
+
+void SocketWire::Base::send0(RdId const& lane_id, RdId const& rd_id, size_t size, std::function<void(Buffer& buffer)> writer) const
 {
 	RD_ASSERT_MSG(!rd_id.isNull(), "{}: id mustn't be null");
+	const SendScope scope(*this);
 
-	Buffer local_send_buffer;
+	// length, id and context precede the data
+	Buffer local_send_buffer(sizeof(int32_t) + sizeof(RdId::hash_t) + sizeof(int16_t) + size);
+	local_send_buffer.set_encoding(encoding);
 	local_send_buffer.write_integral<int32_t>(0);	 // placeholder for length
 	rd_id.write(local_send_buffer);					 // write id
 	local_send_buffer.write_integral<int16_t>(0);	 // placeholder for context
@@ -118,7 +238,31 @@ void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer
 	local_send_buffer.rewind();
 	local_send_buffer.write_integral<int32_t>(len - 4);
 	local_send_buffer.set_position(len);
-	async_send_buffer.put(std::move(local_send_buffer).getRealArray());
+
+	const size_t max_fragment_size = fragment_size;
+	if (max_fragment_size != 0 && static_cast<size_t>(len) > max_fragment_size)
+	{
+		const int32_t number = static_cast<int32_t>(fragmented_messages_sent++ % INT32_MAX) + 1;
+		std::vector<Buffer::ByteArray> fragments;
+		fragments.reserve((len + max_fragment_size - 1) / max_fragment_size);
+		const int32_t header[] = {-number, len};
+		Buffer::word_t const* data = local_send_buffer.data();
+		for (size_t offset = 0; offset < static_cast<size_t>(len); offset += max_fragment_size)
+		{
+			const size_t size = (std::min)(max_fragment_size, len - offset);
+			Buffer::ByteArray fragment(FRAGMENT_HEADER_LENGTH + size);
+			std::copy(reinterpret_cast<Buffer::word_t const*>(header), reinterpret_cast<Buffer::word_t const*>(header) + FRAGMENT_HEADER_LENGTH,
+				fragment.data());
+			std::copy(data + offset, data + offset + size, fragment.data() + FRAGMENT_HEADER_LENGTH);
+			fragments.push_back(std::move(fragment));
+		}
+		logger->trace("{}: message for id {} of {} bytes is sent in {} fragments", this->id, to_string(rd_id), len, fragments.size());
+		RD_ASSERT_THROW_MSG(async_send_buffer.put_fragments(std::move(fragments), rd_id.get_hash(), lane_id.get_hash()),
+			fmt::format("{}: message for id {} rejected, send window is full", this->id, to_string(rd_id)));
+		return;
+	}
+	RD_ASSERT_THROW_MSG(async_send_buffer.put(std::move(local_send_buffer).getRealArray(), rd_id.get_hash(), lane_id.get_hash()),
+		fmt::format("{}: message for id {} rejected, send window is full", this->id, to_string(rd_id)));
 }
 
 void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_socket)
@@ -126,6 +270,9 @@ void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_so
 	{
 		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
 		socket_provider = std::move(new_socket);
+		// packages which weren't acknowledged over the previous connection are resent and acknowledged then
+		sent_ack_seqn = 0;
+		ack_pending = false;
 		socket_send_var.notify_all();
 	}
 	{
@@ -199,12 +346,27 @@ bool SocketWire::Base::read_from_socket(Buffer::word_t* res, int32_t msglen) con
 			lo += copylen;
 			ptr += copylen;
 		}
+		else if (rest >= DIRECT_RECEIVE_THRESHOLD)
+		{
+			// everything received is processed, acknowledge it before waiting for more
+			flush_ack();
+			// large payloads are received straight into the destination, bypassing [receiver_buffer]
+			int32_t read = socket_provider->Receive(rest, res + ptr);
+			if (read <= 0)
+			{
+				logger->info("{}: socket was shut down for receiving", this->id);
+				return false;
+			}
+			ptr += read;
+			logger->info("{}: direct receive finished: {} bytes read", this->id, read);
+		}
 		else
 		{
 			if (hi == receiver_buffer.end())
 			{
 				hi = lo = receiver_buffer.begin();
 			}
+			flush_ack();
 			logger->info("{}: receive started", this->id);
 			int32_t read = socket_provider->Receive(static_cast<int32_t>(receiver_buffer.end() - hi), &*hi);
 			if (read == -1)
@@ -262,26 +424,7 @@ std::pair<int, sequence_number_t> SocketWire::Base::read_header() const
 			{
 				return INVALID_HEADER;
 			}
-
-			counterpart_timestamp = received_timestamp;
-			counterpart_acknowledge_timestamp = received_counterpart_timestamp;
-
-			if ((connection_established(current_timestamp, counterpart_acknowledge_timestamp)))
-			{
-				if (!heartbeatAlive.get())
-				{	 // only on change
-					logger->trace(
-						"Connection is alive after receiving PING {}: "
-						"received_timestamp: {}, "
-						"received_counterpart_timestamp: {}, "
-						"current_timestamp: {}, "
-						"counterpart_timestamp: {}, "
-						"counterpart_acknowledge_timestamp: {}, ",
-						id, received_timestamp, received_counterpart_timestamp, current_timestamp, counterpart_timestamp,
-						counterpart_acknowledge_timestamp);
-				}
-				heartbeatAlive.set(true);
-			}
+			on_ping(received_timestamp, received_counterpart_timestamp);
 			continue;
 		}
 		if (!read_integral_from_socket(seqn))
@@ -298,38 +441,174 @@ std::pair<int, sequence_number_t> SocketWire::Base::read_header() const
 	}
 }
 
-int32_t SocketWire::Base::read_package() const
+void SocketWire::Base::on_ping(int32_t received_timestamp, int32_t received_counterpart_timestamp) const
 {
-	receive_pkg.rewind();
+	counterpart_timestamp = received_timestamp;
+	counterpart_acknowledge_timestamp = received_counterpart_timestamp;
+
+	if ((connection_established(current_timestamp, counterpart_acknowledge_timestamp)))
+	{
+		if (!heartbeatAlive.get())
+		{	 // only on change
+			logger->trace(
+				"Connection is alive after receiving PING {}: "
+				"received_timestamp: {}, "
+				"received_counterpart_timestamp: {}, "
+				"current_timestamp: {}, "
+				"counterpart_timestamp: {}, "
+				"counterpart_acknowledge_timestamp: {}, ",
+				id, received_timestamp, received_counterpart_timestamp, current_timestamp, counterpart_timestamp,
+				counterpart_acknowledge_timestamp);
+		}
+		heartbeatAlive.set(true);
+	}
+}
 
+int32_t SocketWire::Base::read_package() const
+{
 	const auto pair = read_header();
 	if (pair == INVALID_HEADER)
 	{
 		logger->debug("{}: failed to read header", this->id);
 		return -1;
 	}
-	const auto len = pair.first;
+	auto len = pair.first;
 	const auto seqn = pair.second;
 
 	logger->debug("{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
 
-	receive_pkg.require_available(len);
-	if (!read_data_from_socket(receive_pkg.data(), len))
+	const bool fragment = (len & FRAGMENT_FLAG) != 0;
+	len &= ~FRAGMENT_FLAG;
+	Buffer::word_t* package = nullptr;
+	if ((len & PackageCompression::COMPRESSED_FLAG) != 0)
 	{
-		logger->debug("{}: failed to read package", this->id);
-		return -1;
+		len &= ~PackageCompression::COMPRESSED_FLAG;
+		check_message_size(len, "package");
+		compressed_package.resize(len);
+		if (!read_data_from_socket(compressed_package.data(), len))
+		{
+			logger->debug("{}: failed to read package", this->id);
+			return -1;
+		}
+		const int32_t raw_size = PackageCompression::uncompressed_size(compressed_package.data(), len);
+		check_message_size(raw_size, "decompressed package");
+		RD_ASSERT_THROW_MSG(compression.decompress(compressed_package.data(), len, package = receive_pkg.acquire(raw_size)),
+			fmt::format("{}: malformed compressed package, seqn={}", this->id, seqn));
+		len = raw_size;
+	}
+	else
+	{
+		check_message_size(len, "package");
+		if (!read_data_from_socket(package = receive_pkg.acquire(len), len))
+		{
+			logger->debug("{}: failed to read package", this->id);
+			return -1;
+		}
 	}
-	send_ack(seqn);
+	// duplicates are acknowledged again, acks of the previous connection could be lost
+	ack_seqn = seqn;
+	ack_pending = true;
 	if (seqn <= max_received_seqn && seqn != 1)
 	{
-		return true;
+		// duplicate after reconnection, skip it
+		return 0;
+	}
+	if (seqn == 1)
+	{
+		// the counterpart has started over
+		fragmented_messages.clear();
+		release_held_messages(true);
 	}
 	max_received_seqn = seqn;
+	if (fragment)
+	{
+		receive_fragment(package, len);
+		return 0;
+	}
 
 	logger->info("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
 	return len;
 }
 
+void SocketWire::Base::receive_fragment(Buffer::word_t const* data, int32_t size) const
+{
+	RD_ASSERT_THROW_MSG(size >= FRAGMENT_HEADER_LENGTH, fmt::format("{}: malformed fragment of {} bytes", this->id, size));
+	int32_t number = 0;
+	int32_t total = 0;
+	std::copy(data, data + sizeof(number), reinterpret_cast<Buffer::word_t*>(&number));
+	std::copy(data + sizeof(number), data + FRAGMENT_HEADER_LENGTH, reinterpret_cast<Buffer::word_t*>(&total));
+	number = -number;
+
+	check_message_size(total, "fragmented message");
+
+	auto it = fragmented_messages.find(number);
+	if (it == fragmented_messages.end())
+	{
+		it = fragmented_messages.emplace(number, Reassembly{{}, ++reassemblies_started}).first;
+	}
+	auto& message = it->second.bytes;
+	const int32_t chunk = size - FRAGMENT_HEADER_LENGTH;
+	RD_ASSERT_THROW_MSG(total >= static_cast<int32_t>(sizeof(int32_t) + sizeof(RdId::hash_t)) &&
+							static_cast<int32_t>(message.size()) + chunk <= total,
+		fmt::format("{}: malformed fragment of message {}, size={}, total={}", this->id, number, size, total));
+	if (message.empty())
+	{
+		message.reserve(total);
+	}
+	message.insert(message.end(), data + FRAGMENT_HEADER_LENGTH, data + size);
+	if (static_cast<int32_t>(message.size()) < total)
+	{
+		return;
+	}
+
+	const auto slab = std::make_shared<Buffer::ByteArray>(std::move(message));
+	const uint64_t started = it->second.started;
+	fragmented_messages.erase(it);
+	RdId::hash_t hash = 0;
+	std::copy(slab->data() + sizeof(int32_t), slab->data() + sizeof(int32_t) + sizeof(hash), reinterpret_cast<Buffer::word_t*>(&hash));
+	logger->trace("{}: message info: sz={}, id={}, reassembled from fragments", this->id, total, hash);
+	constexpr size_t header = sizeof(int32_t) + sizeof(RdId::hash_t);
+	Buffer buffer(slab, header, total - header);
+	buffer.set_encoding(encoding);
+	// it only waits for the fragmented messages started before it
+	dispatch_message(RdId(hash), std::move(buffer), started - 1);
+	release_held_messages(false);
+}
+
+uint64_t SocketWire::Base::first_incomplete_reassembly() const
+{
+	uint64_t first = UINT64_MAX;
+	for (auto const& reassembly : fragmented_messages)
+	{
+		first = (std::min)(first, reassembly.second.started);
+	}
+	return first;
+}
+
+void SocketWire::Base::dispatch_message(RdId id, Buffer message, uint64_t started) const
+{
+	// a handler of a fragmented message received earlier may bind this id, it mustn't be dropped before
+	if (first_incomplete_reassembly() <= started && (!held_messages.empty() || !message_broker.is_subscribed(id)))
+	{
+		logger->trace("{}: message for id {} is held until {} fragmented messages are reassembled", this->id,
+			to_string(id), fragmented_messages.size());
+		held_messages.push_back(HeldMessage{id, std::move(message), started});
+		return;
+	}
+	message_broker.dispatch(id, std::move(message));
+}
+
+void SocketWire::Base::release_held_messages(bool all) const
+{
+	const uint64_t first_incomplete = all ? UINT64_MAX : first_incomplete_reassembly();
+	while (!held_messages.empty() && held_messages.front().started < first_incomplete)
+	{
+		auto held = std::move(held_messages.front());
+		held_messages.pop_front();
+		message_broker.dispatch(held.id, std::move(held.message));
+	}
+}
+
 bool SocketWire::Base::read_and_dispatch_message() const
 {
 	sz = (sz == -1 ? receive_pkg.read_integral<int32_t>() : sz);
@@ -347,21 +626,21 @@ bool SocketWire::Base::read_and_dispatch_message() const
 	logger->trace("{}: message info: sz={}, id={}", this->id, sz, id_);
 	const RdId rd_id{id_};
 	sz -= 8;	// RdId
-	message.require_available(sz);
 
-	if (!receive_pkg.read(message.data() + message.get_position(), sz - message.get_position()))
+	Buffer message;
+	if (!receive_pkg.read_message(message, sz))
 	{
 		logger->error("{}: constructing message failed", this->id);
 		return false;
 	}
 
 	logger->debug("{}: message received", this->id);
-	message_broker.dispatch(rd_id, std::move(message));
+	message.set_encoding(encoding);
+	dispatch_message(rd_id, std::move(message), reassemblies_started);
 	logger->debug("{}: message dispatched", this->id);
 
 	sz = -1;
 	id_ = -1;
-	message.rewind();
 	return true;
 	//		RD_ASSERT_MSG(summary_size == sz, "Broken message, read:%d bytes, expected:%d bytes", summary_size, sz)
 }
@@ -392,7 +671,12 @@ void SocketWire::Base::ping() const
 		ping_pkg_header.write_integral(current_timestamp);
 		ping_pkg_header.write_integral(counterpart_timestamp);
 		{
-			std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
+			const auto guard = lock_for_control();
+			if (!guard.owns_lock())
+			{
+				logger->trace("{}: PING skipped, the socket is busy sending", this->id);
+				return;
+			}
 			int32_t sent = socket_provider->Send(ping_pkg_header.data(), ping_pkg_header.get_position());
 			if (sent == 0 && !socket_provider->IsSocketValid())
 			{
@@ -411,16 +695,47 @@ void SocketWire::Base::ping() const
 	}
 }
 
-bool SocketWire::Base::send_ack(sequence_number_t seqn) const
+std::unique_lock<std::mutex> SocketWire::Base::lock_for_control() const
+{
+	if (reactor == nullptr)
+	{
+		return std::unique_lock<std::mutex>(socket_send_lock);
+	}
+	return std::unique_lock<std::mutex>(socket_send_lock, std::try_to_lock);
+}
+
+bool SocketWire::Base::write_ack() const
 {
+	if (!ack_pending.exchange(false))
+	{
+		return false;
+	}
+	// a package received meanwhile sets [ack_pending] again, its seqn may be the one acknowledged now
+	const sequence_number_t seqn = ack_seqn;
+	if (seqn == sent_ack_seqn)
+	{
+		return false;
+	}
 	logger->trace("{} send ack {}", id, seqn);
+	ack_buffer.rewind();
+	ack_buffer.write_integral(ACK_MESSAGE_LENGTH);
+	ack_buffer.write_integral(seqn);
+	sent_ack_seqn = seqn;
+	return true;
+}
+
+bool SocketWire::Base::flush_ack() const
+{
+	if (!ack_pending)
+	{
+		return true;
+	}
 	try
 	{
-		ack_buffer.rewind();
-		ack_buffer.write_integral(ACK_MESSAGE_LENGTH);
-		ack_buffer.write_integral(seqn);
+		const auto guard = lock_for_control();
+		// otherwise the ack stays pending for the next flush or batch of sent packages
+		if (guard.owns_lock() && write_ack())
 		{
-			std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
 			RD_ASSERT_THROW_MSG(socket_provider->Send(ack_buffer.data(), ack_buffer.get_position()) == PACKAGE_HEADER_LENGTH,
 				this->id +
 					": failed to send ack over the network"
@@ -431,11 +746,83 @@ bool SocketWire::Base::send_ack(sequence_number_t seqn) const
 	}
 	catch (std::exception const& e)
 	{
-		logger->warn("{}: exception raised during ACK, seqn = {} | {}", id, seqn, e.what());
+		logger->warn("{}: exception raised during ACK, seqn = {} | {}", id, ack_seqn.load(), e.what());
 		return false;
 	}
 }
 
+void SocketWire::Base::set_max_send_batch_size(size_t value)
+{
+	async_send_buffer.set_max_batch_size(value);
+}
+
+void SocketWire::Base::set_send_limits(ByteBufferAsyncProcessor::Limits limits)
+{
+	async_send_buffer.set_limits(limits);
+}
+
+void SocketWire::Base::mark_droppable(RdId const& rd_id)
+{
+	{
+		std::lock_guard<decltype(droppable_lock)> guard(droppable_lock);
+		droppable_ids.insert(rd_id);
+	}
+	async_send_buffer.set_droppable_key([this](Buffer::ByteArray const& package) -> int64_t {
+		// package starts with the message length followed by the recipient id
+		RdId::hash_t hash = 0;
+		if (package.size() < sizeof(int32_t) + sizeof(hash))
+		{
+			return 0;
+		}
+		std::copy(package.data() + sizeof(int32_t), package.data() + sizeof(int32_t) + sizeof(hash),
+			reinterpret_cast<Buffer::word_t*>(&hash));
+		std::lock_guard<decltype(droppable_lock)> guard(droppable_lock);
+		return droppable_ids.count(RdId(hash)) > 0 ? hash : 0;
+	});
+}
+
+void SocketWire::Base::set_priority(RdId const& rd_id, ByteBufferAsyncProcessor::Priority priority)
+{
+	async_send_buffer.set_priority(rd_id.get_hash(), priority);
+}
+
+void SocketWire::Base::set_priority_weights(ByteBufferAsyncProcessor::Weights weights)
+{
+	async_send_buffer.set_weights(weights);
+}
+
+ByteBufferAsyncProcessor::Stats SocketWire::Base::get_send_stats() const
+{
+	return async_send_buffer.get_stats();
+}
+
+void SocketWire::Base::set_compression(PackageCompression::Settings settings)
+{
+	compression.set_settings(settings);
+}
+
+PackageCompression::Stats SocketWire::Base::get_compression_stats() const
+{
+	return compression.get_stats();
+}
+
+void SocketWire::Base::set_fragment_size(size_t size)
+{
+	fragment_size = size;
+}
+
+void SocketWire::Base::set_max_message_size(int32_t size)
+{
+	max_message_size = size;
+}
+
+void SocketWire::Base::check_message_size(int32_t size, char const* what) const
+{
+	const int32_t max_size = max_message_size;
+	RD_ASSERT_THROW_MSG(size >= 0 && size <= max_size,
+		fmt::format("{}: {} of {} bytes exceeds the maximum message size of {} bytes", this->id, what, size, max_size));
+}
+
 bool SocketWire::Base::try_shutdown_connection() const
 {
 	auto s = get_socket_provider();
@@ -445,36 +832,352 @@ bool SocketWire::Base::try_shutdown_connection() const
 	return s->Shutdown(CSimpleSocket::Both);
 }
 
-SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, const std::string& id)
-	: Base(id, parentLifetime, scheduler), port(port), clientLifetimeDefinition(parentLifetime)
+#ifdef RD_WIRE_REACTOR_SUPPORTED
+void SocketWire::Base::attach(Lifetime const& lifetime, std::shared_ptr<CActiveSocket> new_socket)
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (lifetime->is_terminated())
+		{
+			if (!new_socket->Close())
+			{
+				logger->error("{}: failed to close socket", this->id);
+			}
+			return;
+		}
+		socket = new_socket;
+		{
+			std::lock_guard<decltype(socket_send_lock)> send_guard(socket_send_lock);
+			socket_provider = new_socket;
+			sent_ack_seqn = 0;
+			ack_pending = false;
+			socket_send_var.notify_all();
+		}
+
+		pending_header_size = 0;
+		pending_package = nullptr;
+		pending_message_header_size = 0;
+
+		attached_fd = new_socket->GetSocketDescriptor();
+		heartbeat_timer = reactor->schedule(heartBeatInterval, heartBeatInterval, [this] {
+			ping();
+			// an ack skipped while the socket was busy isn't left pending for long
+			flush_ack();
+		});
+		reactor->add_socket(attached_fd, [this] {
+			if (!receive_available() && detach())
+			{
+				on_disconnected();
+			}
+		});
+	}
+
+	// the pending packages are resent on the send thread, the reactor mustn't wait for the socket
+	async_send_buffer.resume_async();
+
+	connected.set(true);
+}
+
+bool SocketWire::Base::detach()
+{
+	int fd;
+	WireReactor::timer_id timer;
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (attached_fd == -1)
+		{
+			return false;
+		}
+		fd = attached_fd;
+		timer = heartbeat_timer;
+		attached_fd = -1;
+		heartbeat_timer = 0;
+	}
+	reactor->remove_socket(fd);
+	reactor->cancel(timer);
+
+	connected.set(false);
+
+	// a send in progress may wait for the socket, it fails once the socket is shut down below
+	async_send_buffer.pause_async("Disconnected");
+
+	if (!socket_provider->IsSocketValid())
+	{
+		logger->debug("{}: socket was already shut down", this->id);
+	}
+	else if (!socket_provider->Shutdown(CSimpleSocket::Both))
+	{
+		logger->warn("{}: possibly double close after disconnect", this->id);
+	}
+	return true;
+}
+
+void SocketWire::Base::on_disconnected()
+{
+}
+
+bool SocketWire::Base::receive_available()
+{
+	try
+	{
+		int32_t read;
+		const int32_t rest = pending_package_length - pending_package_size;
+		if (pending_package != nullptr && rest >= DIRECT_RECEIVE_THRESHOLD)
+		{
+			// large payloads are received straight into the package slab, bypassing [receiver_buffer]
+			read = socket_provider->Receive(rest, pending_package + pending_package_size);
+			if (read > 0)
+			{
+				pending_package_size += read;
+				if (pending_package_size == pending_package_length)
+				{
+					feed_package();
+				}
+				flush_ack();
+				return true;
+			}
+		}
+		else
+		{
+			read = socket_provider->Receive(RECEIVE_BUFFER_SIZE, receiver_buffer.data());
+			if (read > 0)
+			{
+				feed(receiver_buffer.data(), read);
+				flush_ack();
+				return true;
+			}
+		}
+		logger->info("{}: socket was shut down for receiving", this->id);
+		return false;
+	}
+	catch (std::exception const& ex)
+	{
+		logger->error("{} caught processing | {}", this->id, ex.what());
+		return false;
+	}
+}
+
+void SocketWire::Base::feed(Buffer::word_t const* data, size_t size)
+{
+	while (size > 0)
+	{
+		if (pending_package == nullptr)
+		{
+			const size_t n = (std::min)(size, PACKAGE_HEADER_LENGTH - pending_header_size);
+			std::copy(data, data + n, pending_header.data() + pending_header_size);
+			pending_header_size += n;
+			data += n;
+			size -= n;
+			if (pending_header_size < PACKAGE_HEADER_LENGTH)
+			{
+				return;
+			}
+			pending_header_size = 0;
+
+			int32_t len = 0;
+			std::copy(pending_header.data(), pending_header.data() + sizeof(len), reinterpret_cast<Buffer::word_t*>(&len));
+			if (len == PING_MESSAGE_LENGTH)
+			{
+				int32_t received_timestamp = 0;
+				int32_t received_counterpart_timestamp = 0;
+				auto const* timestamps = pending_header.data() + sizeof(len);
+				std::copy(timestamps, timestamps + sizeof(received_timestamp),
+					reinterpret_cast<Buffer::word_t*>(&received_timestamp));
+				std::copy(timestamps + sizeof(received_timestamp), timestamps + 2 * sizeof(received_timestamp),
+					reinterpret_cast<Buffer::word_t*>(&received_counterpart_timestamp));
+				on_ping(received_timestamp, received_counterpart_timestamp);
+				continue;
+			}
+			sequence_number_t seqn = 0;
+			std::copy(pending_header.data() + sizeof(len), pending_header.data() + PACKAGE_HEADER_LENGTH,
+				reinterpret_cast<Buffer::word_t*>(&seqn));
+			if (len == ACK_MESSAGE_LENGTH)
+			{
+				async_send_buffer.acknowledge(seqn);
+				continue;
+			}
+			RD_ASSERT_THROW_MSG(len >= 0, fmt::format("{}: invalid package length: {}", this->id, len));
+
+			logger->debug("{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
+			pending_package_fragment = (len & FRAGMENT_FLAG) != 0;
+			len &= ~FRAGMENT_FLAG;
+			pending_package_compressed = (len & PackageCompression::COMPRESSED_FLAG) != 0;
+			len &= ~PackageCompression::COMPRESSED_FLAG;
+			check_message_size(len, "package");
+			pending_package_length = len;
+			pending_package_size = 0;
+			pending_package_seqn = seqn;
+			if (pending_package_compressed)
+			{
+				compressed_package.resize(len);
+				pending_package = compressed_package.data();
+			}
+			else
+			{
+				pending_package = receive_pkg.acquire(len);
+			}
+		}
+		const size_t n = (std::min)(size, static_cast<size_t>(pending_package_length - pending_package_size));
+		std::copy(data, data + n, pending_package + pending_package_size);
+		pending_package_size += static_cast<int32_t>(n);
+		data += n;
+		size -= n;
+		if (pending_package_size == pending_package_length)
+		{
+			feed_package();
+		}
+	}
+}
+
+void SocketWire::Base::feed_package()
+{
+	Buffer::word_t* package = pending_package;
+	pending_package = nullptr;
+	const auto seqn = pending_package_seqn;
+	ack_seqn = seqn;
+	ack_pending = true;
+	if (seqn <= max_received_seqn && seqn != 1)
+	{
+		// duplicate after reconnection, skip it
+		return;
+	}
+	if (seqn == 1)
+	{
+		// the counterpart has started over
+		fragmented_messages.clear();
+		release_held_messages(true);
+	}
+	max_received_seqn = seqn;
+	logger->info("{}: was received package, bytes={}, seqn={}", this->id, pending_package_length, seqn);
+
+	if (pending_package_compressed)
+	{
+		const int32_t raw_size = PackageCompression::uncompressed_size(compressed_package.data(), pending_package_length);
+		check_message_size(raw_size, "decompressed package");
+		RD_ASSERT_THROW_MSG(compression.decompress(compressed_package.data(), pending_package_length,
+												 package = receive_pkg.acquire(raw_size)),
+			fmt::format("{}: malformed compressed package, seqn={}", this->id, seqn));
+		pending_package_length = raw_size;
+	}
+	if (pending_package_fragment)
+	{
+		receive_fragment(package, pending_package_length);
+		return;
+	}
+	receive_pkg.push(pending_package_length);
+	while (receive_pkg.available() > 0)
+	{
+		if (pending_message_header_size < pending_message_header.size())
+		{
+			pending_message_header_size += receive_pkg.try_read(pending_message_header.data() + pending_message_header_size,
+				pending_message_header.size() - pending_message_header_size);
+			if (pending_message_header_size < pending_message_header.size())
+			{
+				return;
+			}
+			int32_t message_size = 0;
+			auto const* header = pending_message_header.data();
+			std::copy(header, header + sizeof(message_size), reinterpret_cast<Buffer::word_t*>(&message_size));
+			std::copy(header + sizeof(message_size), header + pending_message_header.size(),
+				reinterpret_cast<Buffer::word_t*>(&pending_message_id));
+			logger->trace("{}: message info: sz={}, id={}", this->id, message_size, pending_message_id);
+			pending_message_size = message_size - sizeof(RdId::hash_t);
+			pending_message_read = 0;
+
+			if (receive_pkg.available() >= pending_message_size)
+			{
+				Buffer message;
+				receive_pkg.read_message(message, pending_message_size);
+				message.set_encoding(encoding);
+				pending_message_header_size = 0;
+				dispatch_message(RdId(pending_message_id), std::move(message), reassemblies_started);
+				continue;
+			}
+			// message is split between packages, it has to be assembled
+			pending_message = Buffer(pending_message_size);
+		}
+		pending_message_read += receive_pkg.try_read(
+			pending_message.data() + pending_message_read, pending_message_size - pending_message_read);
+		if (pending_message_read == pending_message_size)
+		{
+			pending_message_header_size = 0;
+			pending_message.set_encoding(encoding);
+			dispatch_message(RdId(pending_message_id), std::move(pending_message), reassemblies_started);
+		}
+	}
+}
+#endif
+
+SocketWire::Client::Client(
+	Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, const std::string& id, WireReactor* reactor)
+	: Client(parentLifetime, scheduler, port, std::string(), id, reactor)
+{
+}
+
+SocketWire::Client::Client(
+	Lifetime parentLifetime, IScheduler* scheduler, std::string path, const std::string& id, WireReactor* reactor)
+	: Client(parentLifetime, scheduler, 0, std::move(path), id, reactor)
+{
+}
+
+SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, std::string path,
+	const std::string& id, WireReactor* reactor)
+	: Base(id, parentLifetime, scheduler, reactor)
+	, port(port)
+	, path(std::move(path))
+	, clientLifetimeDefinition(parentLifetime)
 {
 	Lifetime lifetime = clientLifetimeDefinition.lifetime;
+#ifdef RD_WIRE_REACTOR_SUPPORTED
+	if (this->reactor != nullptr)
+	{
+		logger->info("{}: started on reactor, address: {}.", this->id, address(this->port, this->path));
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			connect_timer =
+				this->reactor->schedule(std::chrono::milliseconds(0), std::chrono::milliseconds(0), [this] { try_connect(); });
+		}
+
+		lifetime->add_action([this]() {
+			logger->info("{}: starts terminating lifetime", this->id);
+
+			const bool send_buffer_stopped = async_send_buffer.stop(timeout);
+			logger->debug("{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
+
+			detach();
+			this->reactor->synchronize();
+
+			WireReactor::timer_id timer;
+			{
+				std::lock_guard<decltype(lock)> guard(lock);
+				timer = connect_timer;
+				logger->debug("{}: closing socket", this->id);
+				if (socket != nullptr)
+				{
+					if (!socket->Close())
+					{
+						logger->error("{}: failed to close socket", this->id);
+					}
+				}
+			}
+			this->reactor->cancel(timer);
+			logger->info("{}: termination finished", this->id);
+		});
+		return;
+	}
+#endif
 	thread = std::thread([this, lifetime]() mutable {
 		rd::util::set_thread_name(this->id.empty() ? "SocketWire::Client Thread" : this->id.c_str());
 
 		try
 		{
-			logger->info("{}: started, port: {}.", this->id, this->port);
+			logger->info("{}: started, address: {}.", this->id, address(this->port, this->path));
 
 			while (!lifetime->is_terminated())
 			{
 				try
 				{
-					socket = std::make_shared<CActiveSocket>();
-					RD_ASSERT_THROW_MSG(socket->Initialize(),
-						fmt::format("{}: failed to init ActiveSocket, reason: {}", this->id, socket->DescribeError()));
-					RD_ASSERT_THROW_MSG(socket->DisableNagleAlgoritm(),
-						fmt::format("{}: failed to DisableNagleAlgoritm, reason: {}", this->id, socket->DescribeError()));
-
-					// On windows connect will try to send SYN 3 times with interval of 500ms (total time is 1second)
-					// Connect timeout doesn't work if it's more than 1 second. But we don't need it because we can close socket any
-					// moment.
-
-					// https://stackoverflow.com/questions/22417228/prevent-tcp-socket-connection-retries
-					// HKLM\SYSTEM\CurrentControlSet\Services\Tcpip\Parameters\TcpMaxConnectRetransmissions
-					logger->info("{}: connecting 127.0.0.1: {}", this->id, this->port);
-					RD_ASSERT_THROW_MSG(socket->Open("127.0.0.1", this->port),
-						fmt::format("{}: failed to open ActiveSocket, reason: {}", this->id, socket->DescribeError()));
+					socket = open_socket();
 					{
 						std::lock_guard<decltype(lock)> guard(lock);
 						if (lifetime->is_terminated())
@@ -491,7 +1194,7 @@ SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint1
 				}
 				catch (std::exception const& e)
 				{
-					logger->debug("{}: connection error for port {} ({}).", this->id, this->port, e.what());
+					logger->debug("{}: connection error for {} ({}).", this->id, address(this->port, this->path), e.what());
 
 					std::lock_guard<decltype(lock)> guard(lock);
 					bool should_reconnect = false;
@@ -512,7 +1215,7 @@ SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint1
 		{
 			logger->info("{}: closed with exception: {}", this->id, e.what());
 		}
-		logger->info("{}: terminated, port: {}.", this->id, this->port);
+		logger->info("{}: terminated, address: {}.", this->id, address(this->port, this->path));
 	});
 
 	lifetime->add_action([this]() {
@@ -550,26 +1253,147 @@ SocketWire::Client::~Client()
 	}
 }
 
-SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, const std::string& id)
-	: Base(id, parentLifetime, scheduler), ss(std::make_unique<CPassiveSocket>()), serverLifetimeDefinition(parentLifetime)
+std::shared_ptr<CActiveSocket> SocketWire::Client::open_socket() const
+{
+	auto new_socket =
+		std::make_shared<CActiveSocket>(path.empty() ? CSimpleSocket::SocketTypeTcp : CSimpleSocket::SocketTypeUnix);
+	RD_ASSERT_THROW_MSG(new_socket->Initialize(),
+		fmt::format("{}: failed to init ActiveSocket, reason: {}", this->id, new_socket->DescribeError()));
+	RD_ASSERT_THROW_MSG(new_socket->DisableNagleAlgoritm(),
+		fmt::format("{}: failed to DisableNagleAlgoritm, reason: {}", this->id, new_socket->DescribeError()));
+
+	// On windows connect will try to send SYN 3 times with interval of 500ms (total time is 1second)
+	// Connect timeout doesn't work if it's more than 1 second. But we don't need it because we can close socket any
+	// moment.
+
+	// https://stackoverflow.com/questions/22417228/prevent-tcp-socket-connection-retries
+	// HKLM\SYSTEM\CurrentControlSet\Services\Tcpip\Parameters\TcpMaxConnectRetransmissions
+	logger->info("{}: connecting {}", this->id, address(port, path));
+	RD_ASSERT_THROW_MSG(new_socket->Open(path.empty() ? "127.0.0.1" : path.c_str(), port),
+		fmt::format("{}: failed to open ActiveSocket, reason: {}", this->id, new_socket->DescribeError()));
+	return new_socket;
+}
+
+#ifdef RD_WIRE_REACTOR_SUPPORTED
+void SocketWire::Client::try_connect()
+{
+	Lifetime lifetime = clientLifetimeDefinition.lifetime;
+	try
+	{
+		attach(lifetime, open_socket());
+	}
+	catch (std::exception const& e)
+	{
+		logger->debug("{}: connection error for {} ({}).", this->id, address(this->port, this->path), e.what());
+		on_disconnected();
+	}
+}
+
+void SocketWire::Client::on_disconnected()
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	if (!clientLifetimeDefinition.lifetime->is_terminated())
+	{
+		connect_timer = reactor->schedule(timeout, std::chrono::milliseconds(0), [this] { try_connect(); });
+	}
+}
+#endif
+
+SocketWire::Server::Server(
+	Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, const std::string& id, WireReactor* reactor)
+	: Server(parentLifetime, scheduler, port, std::string(), id, reactor)
+{
+}
+
+SocketWire::Server::Server(
+	Lifetime parentLifetime, IScheduler* scheduler, std::string path, const std::string& id, WireReactor* reactor)
+	: Server(parentLifetime, scheduler, 0, std::move(path), id, reactor)
+{
+}
+
+SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, std::string path,
+	const std::string& id, WireReactor* reactor)
+	: Base(id, parentLifetime, scheduler, reactor)
+	, path(std::move(path))
+	, ss(std::make_unique<CPassiveSocket>(this->path.empty() ? CSimpleSocket::SocketTypeTcp : CSimpleSocket::SocketTypeUnix))
+	, serverLifetimeDefinition(parentLifetime)
 {
 #ifdef SIGPIPE
 	signal(SIGPIPE, SIG_IGN);
 #endif
-	RD_ASSERT_MSG(ss->Initialize(), fmt::format("{}: failed to initialize socket, reason: {}", this->id, socket->DescribeError()));
-	RD_ASSERT_MSG(ss->Listen("127.0.0.1", port),
-		fmt::format("{}: failed to listen socket on port: {}, reason: {}", this->id, std::to_string(port), ss->DescribeError()));
+	RD_ASSERT_MSG(ss->Initialize(), fmt::format("{}: failed to initialize socket, reason: {}", this->id, ss->DescribeError()));
+	if (this->path.empty())
+	{
+		RD_ASSERT_MSG(ss->Listen("127.0.0.1", port),
+			fmt::format("{}: failed to listen socket on port: {}, reason: {}", this->id, std::to_string(port), ss->DescribeError()));
 
-	this->port = ss->GetServerPort();
-	RD_ASSERT_MSG(this->port != 0, fmt::format("{}: port wasn't chosen", this->id));
+		this->port = ss->GetServerPort();
+		RD_ASSERT_MSG(this->port != 0, fmt::format("{}: port wasn't chosen", this->id));
+	}
+	else
+	{
+		RD_ASSERT_MSG(ss->Listen(this->path.c_str(), 0),
+			fmt::format("{}: failed to listen socket at: {}, reason: {}", this->id, this->path, ss->DescribeError()));
+	}
 
-	logger->info("{}: listening 127.0.0.1/{}", this->id, this->port);
+	logger->info("{}: listening {}", this->id, address(this->port, this->path));
 	Lifetime lifetime = serverLifetimeDefinition.lifetime;
+#ifdef RD_WIRE_REACTOR_SUPPORTED
+	if (this->reactor != nullptr)
+	{
+		logger->info("{}: started on reactor, address: {}.", this->id, address(this->port, this->path));
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			listen();
+		}
+
+		lifetime->add_action([this] {
+			logger->info("{}: start terminating lifetime", this->id);
+
+			const bool send_buffer_stopped = async_send_buffer.stop(timeout);
+			logger->debug("{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
+
+			bool was_listening;
+			{
+				std::lock_guard<decltype(lock)> guard(lock);
+				was_listening = listening;
+				listening = false;
+			}
+			if (was_listening)
+			{
+				this->reactor->remove_socket(static_cast<int>(ss->GetSocketDescriptor()));
+			}
+			detach();
+			this->reactor->synchronize();
+
+			logger->debug("{}: closing server socket", this->id);
+			if (!ss->Close())
+			{
+				logger->error("{}: failed to close server socket", this->id);
+			}
+			remove_socket_file();
+
+			{
+				std::lock_guard<decltype(lock)> guard(lock);
+				logger->debug("{}: closing socket", this->id);
+				if (socket != nullptr)
+				{
+					if (!socket->Close())
+					{
+						logger->error("{}: failed to close socket", this->id);
+					}
+				}
+			}
+			logger->info("{}: termination finished", this->id);
+		});
+		return;
+	}
+#endif
 
 	thread = std::thread([this, lifetime]() mutable {
 		rd::util::set_thread_name(this->id.empty() ? "SocketWire::Server Thread" : this->id.c_str());
 
-		logger->info("{}: started, port: {}.", this->id, this->port);
+		logger->info("{}: started, address: {}.", this->id, address(this->port, this->path));
 
 		try
 		{
@@ -620,7 +1444,7 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 			logger->error("{}: terminal socket error ({}).", this->id, e.what());
 		}
 
-		logger->info("{}: terminated, port: {}.", this->id, this->port);
+		logger->info("{}: terminated, address: {}.", this->id, address(this->port, this->path));
 	});
 
 	lifetime->add_action([this] {
@@ -634,6 +1458,7 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 		{
 			logger->error("{}: failed to close server socket", this->id);
 		}
+		remove_socket_file();
 
 		{
 			std::lock_guard<decltype(lock)> guard(lock);
@@ -662,4 +1487,59 @@ SocketWire::Server::~Server()
 	}
 }
 
+void SocketWire::Server::remove_socket_file() const
+{
+	if (!path.empty() && std::remove(path.c_str()) != 0)
+	{
+		logger->warn("{}: failed to remove socket file {}", this->id, path);
+	}
+}
+
+#ifdef RD_WIRE_REACTOR_SUPPORTED
+void SocketWire::Server::listen()
+{
+	if (!serverLifetimeDefinition.lifetime->is_terminated() && !listening)
+	{
+		listening = true;
+		reactor->add_socket(static_cast<int>(ss->GetSocketDescriptor()), [this] { try_accept(); });
+	}
+}
+
+void SocketWire::Server::try_accept()
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (!listening)
+		{
+			return;
+		}
+		listening = false;
+	}
+	// a single connection is served at a time, the next one is accepted after it's gone
+	reactor->remove_socket(static_cast<int>(ss->GetSocketDescriptor()));
+	try
+	{
+		CActiveSocket* accepted = ss->Accept();
+		RD_ASSERT_THROW_MSG(accepted != nullptr, fmt::format("{}: accepting failed, reason: {}", this->id, ss->DescribeError()));
+		std::shared_ptr<CActiveSocket> new_socket(accepted);
+		logger->info("{}: accepted passive socket {}/{}", this->id, new_socket->GetClientAddr(), new_socket->GetClientPort());
+		RD_ASSERT_THROW_MSG(new_socket->DisableNagleAlgoritm(),
+			fmt::format("{}: tcpNoDelay failed, reason: {}", this->id, new_socket->DescribeError()));
+
+		attach(serverLifetimeDefinition.lifetime, std::move(new_socket));
+	}
+	catch (std::exception const& e)
+	{
+		logger->info("{}: closed with exception: {}", this->id, e.what());
+		on_disconnected();
+	}
+}
+
+void SocketWire::Server::on_disconnected()
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	listen();
+}
+#endif
+
 }	 // namespace rd
@@ -10,19 +10,28 @@
 #include "base/WireBase.h"
 #include "ByteBufferAsyncProcessor.h"
 #include "PkgInputStream.h"
+#include "PackageCompression.h"
+#include "WireReactor.h"
+#include "std/unordered_map.h"
+#include "std/unordered_set.h"
 
 #include <string>
 #include <array>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 
 #include <rd_framework_export.h>
 
 class CSimpleSocket;
 class CActiveSocket;
 class CPassiveSocket;
+struct iovec;
 
 namespace rd
 {
+class WireReactor;
+
 class RD_FRAMEWORK_API SocketWire
 {
 	static std::chrono::milliseconds timeout;
@@ -45,9 +54,14 @@ public:
 
 		std::shared_ptr<CActiveSocket> socket;
 
+		mutable std::mutex droppable_lock;
+		rd::unordered_set<RdId> droppable_ids;
+
 		mutable std::condition_variable socket_send_var;
 		mutable ByteBufferAsyncProcessor async_send_buffer{id + "-AsyncSendProcessor",
-			[this](Buffer::ByteArray const& it, sequence_number_t seqn) -> bool { return this->send0(it, seqn); }};
+			[this](ByteBufferAsyncProcessor::batch_t const& batch, sequence_number_t first_seqn) -> bool {
+				return this->send0(batch, first_seqn);
+			}};
 
 		static constexpr size_t RECEIVE_BUFFER_SIZE = 1u << 16;
 		mutable std::array<Buffer::word_t, RECEIVE_BUFFER_SIZE> receiver_buffer{};
@@ -56,8 +70,51 @@ public:
 		static constexpr int32_t ACK_MESSAGE_LENGTH = -1;
 		static constexpr int32_t PING_MESSAGE_LENGTH = -2;
 		static constexpr int32_t PACKAGE_HEADER_LENGTH = sizeof(ACK_MESSAGE_LENGTH) + sizeof(sequence_number_t);
+
+		/**
+		 * \brief Marks a package which holds a fragment of a message in the length of its header. Its payload is the
+		 * negated int32_t number of the fragmented message, the int32_t size of the whole message and the bytes of the
+		 * fragment. Fragments of a message are sent in order, interleaved with other packages.
+		 */
+		static constexpr int32_t FRAGMENT_FLAG = 1 << 29;
+		static constexpr int32_t FRAGMENT_HEADER_LENGTH = 2 * sizeof(int32_t);
+
+		/**
+		 * \brief Sizes of received packages, decompressed packages and reassembled messages come from the counterpart,
+		 * ones above this are rejected before anything is allocated for them and the connection is dropped.
+		 */
+		std::atomic<int32_t> max_message_size{DEFAULT_MAX_MESSAGE_SIZE};
+
+		/**
+		 * \brief Throws if [size] declared by the counterpart is negative or above [max_message_size].
+		 */
+		void check_message_size(int32_t size, char const* what) const;
 		mutable Buffer ack_buffer{PACKAGE_HEADER_LENGTH};
 
+		/**
+		 * \brief The latest received seqn. Acks are cumulative, so instead of acknowledging each package it's written in
+		 * front of the next batch of sent packages, or sent alone by [flush_ack] once the received data is processed.
+		 */
+		mutable std::atomic<sequence_number_t> ack_seqn{0};
+		mutable std::atomic<bool> ack_pending{false};
+
+		/**
+		 * \brief The latest seqn acknowledged over the current connection, under [socket_send_lock].
+		 */
+		mutable sequence_number_t sent_ack_seqn = 0;
+
+		/**
+		 * \brief Locks [socket_send_lock] to send a ping or an ack. On the reactor thread it only tries to: a sender blocked
+		 * on a full socket may wait for the reactor to read from the other side, then the package is skipped.
+		 */
+		std::unique_lock<std::mutex> lock_for_control() const;
+
+		/**
+		 * \brief Writes the pending ack into [ack_buffer], under [socket_send_lock].
+		 * \return false if there is nothing to acknowledge
+		 */
+		bool write_ack() const;
+
 		/**
 		 * \brief Timestamp of this wire which increases at intervals of [heartBeatInterval].
 		 */
@@ -76,15 +133,93 @@ public:
 		mutable Buffer ping_pkg_header{PACKAGE_HEADER_LENGTH};
 
 		mutable sequence_number_t max_received_seqn = 0;
-		mutable Buffer send_package_header{PACKAGE_HEADER_LENGTH};
+
+		/**
+		 * \brief Packages written by a single vectored send, each one takes a header and a payload slot.
+		 */
+		static constexpr int32_t MAX_PACKAGES_PER_SEND = 64;
+		mutable Buffer send_package_header{PACKAGE_HEADER_LENGTH * MAX_PACKAGES_PER_SEND};
+
+		mutable PackageCompression compression;
+
+		/**
+		 * \brief Compressed payloads of packages written by a single vectored send.
+		 */
+		mutable std::array<Buffer::ByteArray, MAX_PACKAGES_PER_SEND> compressed_packages;
+
+		/**
+		 * \brief Compressed payload of the package being received, it's decompressed into [receive_pkg].
+		 */
+		mutable Buffer::ByteArray compressed_package;
+
+		/**
+		 * \brief Messages larger than this are sent in fragments, 0 if they aren't.
+		 */
+		std::atomic<size_t> fragment_size{0};
+		mutable std::atomic<uint32_t> fragmented_messages_sent{0};
+
+		struct Reassembly
+		{
+			Buffer::ByteArray bytes;
+			/**
+			 * \brief Number of reassemblies started before this one, including it.
+			 */
+			uint64_t started;
+		};
+
+		/**
+		 * \brief Messages being reassembled by their numbers.
+		 */
+		mutable rd::unordered_map<int32_t, Reassembly> fragmented_messages;
+		mutable uint64_t reassemblies_started = 0;
+
+		struct HeldMessage
+		{
+			RdId id;
+			Buffer message;
+			/**
+			 * \brief The message is held until the reassemblies started before it are complete.
+			 */
+			uint64_t started;
+		};
+
+		/**
+		 * \brief Messages received while earlier fragmented messages are being reassembled, in order of receiving.
+		 * Their ids may be bound by the handlers of the fragmented messages, so they are dispatched after them.
+		 */
+		mutable std::deque<HeldMessage> held_messages;
+
+		/**
+		 * \brief Appends a received fragment to its message and dispatches the message once it's complete.
+		 */
+		void receive_fragment(Buffer::word_t const* data, int32_t size) const;
+
+		/**
+		 * \brief Number of the earliest started reassembly which is incomplete, UINT64_MAX if there's none.
+		 */
+		uint64_t first_incomplete_reassembly() const;
+
+		/**
+		 * \brief Dispatches a complete message, or holds it back if it's for an unbound id (or others are held) while
+		 * any of the first [started] reassemblies is incomplete.
+		 */
+		void dispatch_message(RdId id, Buffer message, uint64_t started) const;
+
+		/**
+		 * \brief Dispatches held messages which no longer wait for a reassembly, or all of them if [all].
+		 */
+		void release_held_messages(bool all) const;
 
 		static constexpr int32_t CHUNK_SIZE = 16370;
+
+		/**
+		 * \brief Reads of at least this size skip [receiver_buffer] when it's empty.
+		 */
+		static constexpr int32_t DIRECT_RECEIVE_THRESHOLD = CHUNK_SIZE;
 		mutable int32_t sz = -1;
 		mutable RdId::hash_t id_ = -1;
 		mutable PkgInputStream receive_pkg{[this]() -> int32_t { return this->read_package(); }};
 
-		mutable Buffer message{CHUNK_SIZE};
-
 		bool read_from_socket(Buffer::word_t* res, int32_t msglen) const;
 
 		template <typename T>
@@ -98,8 +233,67 @@ public:
 			return read_from_socket(reinterpret_cast<Buffer::word_t*>(data), static_cast<int32_t>(len));
 		}
 
+		/**
+		 * \brief Writes the [count] buffers of [vec] whole, with a single gathering call when the socket accepts them at
+		 * once: writev on POSIX and WSASend on Windows.
+		 */
+		bool send_vector(iovec* vec, int32_t count) const;
+
 		void set_socket_provider(std::shared_ptr<CActiveSocket> new_socket);
 
+		void on_ping(int32_t received_timestamp, int32_t received_counterpart_timestamp) const;
+
+		/**
+		 * \brief Shared event loop receiving and pinging for this wire instead of its own threads, see [WireReactor].
+		 */
+		WireReactor* reactor = nullptr;
+
+#ifdef RD_WIRE_REACTOR_SUPPORTED
+		// region reactor
+
+		int attached_fd = -1;
+		WireReactor::timer_id heartbeat_timer = 0;
+
+		std::array<Buffer::word_t, PACKAGE_HEADER_LENGTH> pending_header{};
+		size_t pending_header_size = 0;
+		int32_t pending_package_length = 0;
+		int32_t pending_package_size = 0;
+		sequence_number_t pending_package_seqn = 0;
+		bool pending_package_compressed = false;
+		bool pending_package_fragment = false;
+		Buffer::word_t* pending_package = nullptr;
+
+		std::array<Buffer::word_t, sizeof(int32_t) + sizeof(RdId::hash_t)> pending_message_header{};
+		size_t pending_message_header_size = 0;
+		Buffer pending_message;
+		size_t pending_message_size = 0;
+		size_t pending_message_read = 0;
+		RdId::hash_t pending_message_id = 0;
+
+		/**
+		 * \brief Starts receiving from [new_socket] and pinging on the reactor thread unless [lifetime] is terminated.
+		 */
+		void attach(Lifetime const& lifetime, std::shared_ptr<CActiveSocket> new_socket);
+
+		/**
+		 * \brief Stops receiving and pinging, returns false if the wire was not attached.
+		 */
+		bool detach();
+
+		/**
+		 * \brief Called on the reactor thread once the attached socket got disconnected.
+		 */
+		virtual void on_disconnected();
+
+		bool receive_available();
+
+		void feed(Buffer::word_t const* data, size_t size);
+
+		void feed_package();
+
+		// endregion
+#endif
+
 		CSimpleSocket* get_socket_provider() const;
 
 	public:
@@ -108,7 +302,7 @@ public:
 
 		// region ctor/dtor
 
-		Base(std::string id, Lifetime lifetime, IScheduler* scheduler);
+		Base(std::string id, Lifetime lifetime, IScheduler* scheduler, WireReactor* reactor = nullptr);
 
 		virtual ~Base() override;
 
@@ -122,19 +316,86 @@ public:
 
 		void receiverProc() const;
 
-		bool send0(Buffer::ByteArray const& msg, sequence_number_t seqn) const;
+		bool send0(ByteBufferAsyncProcessor::batch_t const& batch, sequence_number_t first_seqn) const;
 
 		void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const override;
 
+		void send(RdId const& rd_id, size_t size, std::function<void(Buffer& buffer)> writer) const override;
+
+		void send_reply(RdId const& origin, RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const override;
+
+		// queues the message in the lane of [lane_id] rather than of [rd_id]
+		void send0(RdId const& lane_id, RdId const& rd_id, size_t size, std::function<void(Buffer& buffer)> writer) const;
+
 		static bool connection_established(int32_t timestamp, int32_t acknowledged_timestamp);
 
 		std::future<void> start_heartbeat(Lifetime lifetime);
 
 		void ping() const;
 
-		bool send_ack(sequence_number_t seqn) const;
+		/**
+		 * \brief Sends the pending ack unless a sent batch has carried it already.
+		 */
+		bool flush_ack() const;
 
 		bool try_shutdown_connection() const;
+
+		/**
+		 * \brief Maximum number of queued packages coalesced into one send call, 1 sends them one by one.
+		 */
+		void set_max_send_batch_size(size_t value);
+
+		/**
+		 * \brief Bounds memory held by messages which were sent but not acknowledged yet, see
+		 * [ByteBufferAsyncProcessor::Limits]. Messages rejected by the limits make [send] throw.
+		 */
+		void set_send_limits(ByteBufferAsyncProcessor::Limits limits);
+
+		/**
+		 * \brief Allows to drop unsent messages of entity [rd_id] under [ByteBufferAsyncProcessor::OverflowPolicy::DropOldest]
+		 * when a later message of the same entity is queued, e.g. for properties only the latest value matters.
+		 */
+		void mark_droppable(RdId const& rd_id);
+
+		/**
+		 * \brief Queues messages of entity [rd_id] in the lane of [priority], see [ByteBufferAsyncProcessor::Priority].
+		 * Set it before the entity sends anything, messages queued before aren't moved.
+		 *
+		 * Messages of different lanes reach the peer in any order, so only entities whose messages create no entities
+		 * and depend on no other entity's state may be moved out of [ByteBufferAsyncProcessor::Priority::Normal], e.g.
+		 * signals, calls and replies of plain values. Otherwise the peer could get a message for an entity it hasn't
+		 * created yet and drop it, or handle it before the state it depends on arrives. Properties and collections of
+		 * bindable values, and anything the wire keeps ordered like the intern root, stay in the normal lane.
+		 */
+		void set_priority(RdId const& rd_id, ByteBufferAsyncProcessor::Priority priority);
+
+		void set_priority_weights(ByteBufferAsyncProcessor::Weights weights);
+
+		ByteBufferAsyncProcessor::Stats get_send_stats() const;
+
+		/**
+		 * \brief Compresses sent packages above the threshold. Compressed packages are understood regardless of settings,
+		 * but a counterpart which doesn't know about [PackageCompression] can't read them, so it's enabled explicitly.
+		 */
+		void set_compression(PackageCompression::Settings settings);
+
+		PackageCompression::Stats get_compression_stats() const;
+
+		/**
+		 * \brief Splits messages larger than [size] bytes into fragments of [size] bytes, which are sent interleaved
+		 * with other messages and reassembled on receive, so a large message doesn't hold the rest back until it's sent
+		 * whole. Messages of ids the receiver hasn't bound yet, e.g. of entities a fragmented message creates, are
+		 * dispatched after the fragmented messages received before them. 0 turns it off. Like compression, it's enabled
+		 * explicitly, since the counterpart has to understand fragments.
+		 */
+		void set_fragment_size(size_t size);
+
+		static constexpr int32_t DEFAULT_MAX_MESSAGE_SIZE = 256 << 20;
+
+		/**
+		 * \brief Largest package or message accepted from the counterpart, see [max_message_size].
+		 */
+		void set_max_message_size(int32_t size);
 		
 	private:		
 		LifetimeDefinition lifetimeDef;
@@ -145,9 +406,22 @@ public:
 	public:
 		uint16_t port = 0;
 
+		/**
+		 * \brief Unix domain socket to connect to instead of [port], empty for TCP.
+		 */
+		std::string path;
+
 		// region ctor/dtor
 
-		Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port = 0, const std::string& id = "ClientSocket");
+		Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port = 0, const std::string& id = "ClientSocket",
+			WireReactor* reactor = nullptr);
+
+		/**
+		 * \brief Connects to the Unix domain socket at [path], packages and acks are the same as over TCP. Not supported
+		 * on Windows.
+		 */
+		Client(Lifetime parentLifetime, IScheduler* scheduler, std::string path, const std::string& id = "ClientSocket",
+			WireReactor* reactor = nullptr);
 
 		virtual ~Client() override;
 		// endregion
@@ -155,6 +429,19 @@ public:
 		std::condition_variable_any cv;
 	private:		
 		LifetimeDefinition clientLifetimeDefinition;
+
+		Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, std::string path, const std::string& id,
+			WireReactor* reactor);
+
+		std::shared_ptr<CActiveSocket> open_socket() const;
+
+#ifdef RD_WIRE_REACTOR_SUPPORTED
+		WireReactor::timer_id connect_timer = 0;
+
+		void try_connect();
+
+		void on_disconnected() override;
+#endif
 	};
 
 	class RD_FRAMEWORK_API Server : public Base
@@ -162,16 +449,44 @@ public:
 	public:
 		uint16_t port = 0;
 
+		/**
+		 * \brief Unix domain socket listened on instead of [port], empty for TCP.
+		 */
+		std::string path;
+
 		std::unique_ptr<CPassiveSocket> ss;
 
 		// region ctor/dtor
 
-		Server(Lifetime lifetime, IScheduler* scheduler, uint16_t port = 0, const std::string& id = "ServerSocket");
+		Server(Lifetime lifetime, IScheduler* scheduler, uint16_t port = 0, const std::string& id = "ServerSocket",
+			WireReactor* reactor = nullptr);
+
+		/**
+		 * \brief Listens on the Unix domain socket at [path], the socket file is removed on termination. Not supported on
+		 * Windows.
+		 */
+		Server(Lifetime lifetime, IScheduler* scheduler, std::string path, const std::string& id = "ServerSocket",
+			WireReactor* reactor = nullptr);
 
 		virtual ~Server() override;
 		// endregion
 	private:
 		LifetimeDefinition serverLifetimeDefinition;
+
+		Server(Lifetime lifetime, IScheduler* scheduler, uint16_t port, std::string path, const std::string& id,
+			WireReactor* reactor);
+
+		void remove_socket_file() const;
+
+#ifdef RD_WIRE_REACTOR_SUPPORTED
+		bool listening = false;
+
+		void listen();
+
+		void try_accept();
+
+		void on_disconnected() override;
+#endif
 	};
 };
 }	 // namespace rd
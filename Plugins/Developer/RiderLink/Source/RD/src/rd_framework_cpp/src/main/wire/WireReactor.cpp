@@ -0,0 +1,256 @@
+#include "WireReactor.h"
+
+#ifdef RD_WIRE_REACTOR_SUPPORTED
+
+#include <util/thread_util.h>
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace rd
+{
+constexpr std::chrono::milliseconds WireReactor::TICK;
+constexpr size_t WireReactor::WHEEL_SIZE;
+
+std::shared_ptr<spdlog::logger> WireReactor::logger =
+	spdlog::stderr_color_mt<spdlog::synchronous_factory>("wireReactorLog", spdlog::color_mode::automatic);
+
+namespace
+{
+constexpr int MAX_EVENTS = 64;
+
+uint64_t to_ticks(std::chrono::milliseconds duration)
+{
+	auto const ticks = (duration.count() + WireReactor::TICK.count() - 1) / WireReactor::TICK.count();
+	return ticks > 0 ? static_cast<uint64_t>(ticks) : 1;
+}
+}	 // namespace
+
+WireReactor::WireReactor(std::string name) : name(std::move(name))
+{
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (epoll_fd < 0 || wake_fd < 0)
+	{
+		logger->error("{}: failed to create epoll instance: {}", this->name, strerror(errno));
+		throw std::runtime_error("Failed to create epoll instance");
+	}
+
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.fd = wake_fd;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+	thread = std::thread([this] {
+		rd::util::set_thread_name(this->name.c_str());
+		run();
+	});
+}
+
+WireReactor::~WireReactor()
+{
+	stopped = true;
+	wake();
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+	close(wake_fd);
+	close(epoll_fd);
+}
+
+void WireReactor::wake() const
+{
+	uint64_t one = 1;
+	// the counter only saturates when the loop is not draining it, the loop is going to wake up anyway then
+	ssize_t ignored = write(wake_fd, &one, sizeof(one));
+	(void) ignored;
+}
+
+void WireReactor::run()
+{
+	std::array<epoll_event, MAX_EVENTS> events{};
+	auto next_tick = std::chrono::steady_clock::now() + TICK;
+
+	while (!stopped)
+	{
+		auto const wait =
+			std::chrono::duration_cast<std::chrono::milliseconds>(next_tick - std::chrono::steady_clock::now()).count();
+		int const n = epoll_wait(epoll_fd, events.data(), MAX_EVENTS, static_cast<int>((std::max)(wait, int64_t{0})));
+		if (n < 0 && errno != EINTR)
+		{
+			logger->error("{}: epoll_wait failed: {}", name, strerror(errno));
+			break;
+		}
+
+		std::lock_guard<std::recursive_mutex> dispatch_guard(dispatch_lock);
+		for (int i = 0; i < n; ++i)
+		{
+			int const fd = events[i].data.fd;
+			if (fd == wake_fd)
+			{
+				uint64_t count;
+				ssize_t ignored = read(wake_fd, &count, sizeof(count));
+				(void) ignored;
+				continue;
+			}
+
+			std::shared_ptr<std::function<void()>> handler;
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				auto it = handlers.find(fd);
+				if (it == handlers.end())
+				{
+					// removed by a callback earlier in this batch
+					continue;
+				}
+				handler = it->second;
+			}
+			(*handler)();
+		}
+
+		std::vector<std::function<void()>> actions;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			actions.swap(posted);
+		}
+		for (auto const& action : actions)
+		{
+			action();
+		}
+
+		auto const now = std::chrono::steady_clock::now();
+		while (next_tick <= now)
+		{
+			tick();
+			next_tick += TICK;
+		}
+	}
+	logger->debug("{}: terminated", name);
+}
+
+void WireReactor::place(timer_id id, Timer& timer, uint64_t delay_ticks)
+{
+	timer.rounds = (delay_ticks - 1) / WHEEL_SIZE;
+	wheel[(current_slot + delay_ticks) % WHEEL_SIZE].push_back(id);
+}
+
+void WireReactor::tick()
+{
+	std::vector<std::shared_ptr<std::function<void()>>> due;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		current_slot = (current_slot + 1) % WHEEL_SIZE;
+		std::vector<timer_id> slot;
+		slot.swap(wheel[current_slot]);
+		for (timer_id id : slot)
+		{
+			auto it = timers.find(id);
+			if (it == timers.end())
+			{
+				// cancelled
+				continue;
+			}
+			Timer& timer = it->second;
+			if (timer.rounds > 0)
+			{
+				--timer.rounds;
+				wheel[current_slot].push_back(id);
+				continue;
+			}
+			due.push_back(timer.action);
+			if (timer.period_ticks > 0)
+			{
+				place(id, timer, timer.period_ticks);
+			}
+			else
+			{
+				timers.erase(it);
+			}
+		}
+	}
+	for (auto const& action : due)
+	{
+		(*action)();
+	}
+}
+
+void WireReactor::synchronize()
+{
+	if (!is_reactor_thread())
+	{
+		std::lock_guard<std::recursive_mutex> dispatch_guard(dispatch_lock);
+	}
+}
+
+void WireReactor::add_socket(int fd, std::function<void()> on_readable)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		handlers[fd] = std::make_shared<std::function<void()>>(std::move(on_readable));
+	}
+	epoll_event event{};
+	event.events = EPOLLIN | EPOLLRDHUP;
+	event.data.fd = fd;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+	{
+		logger->error("{}: failed to register socket {}: {}", name, fd, strerror(errno));
+		std::lock_guard<std::mutex> guard(lock);
+		handlers.erase(fd);
+	}
+}
+
+void WireReactor::remove_socket(int fd)
+{
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		handlers.erase(fd);
+	}
+	synchronize();
+}
+
+WireReactor::timer_id WireReactor::schedule(
+	std::chrono::milliseconds delay, std::chrono::milliseconds period, std::function<void()> action)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	timer_id const id = next_timer_id++;
+	Timer& timer = timers[id];
+	timer.period_ticks = period.count() > 0 ? to_ticks(period) : 0;
+	timer.action = std::make_shared<std::function<void()>>(std::move(action));
+	place(id, timer, to_ticks(delay));
+	return id;
+}
+
+void WireReactor::cancel(timer_id id)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		timers.erase(id);
+	}
+	synchronize();
+}
+
+void WireReactor::post(std::function<void()> action)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		posted.push_back(std::move(action));
+	}
+	wake();
+}
+
+bool WireReactor::is_reactor_thread() const
+{
+	return std::this_thread::get_id() == thread.get_id();
+}
+}	 // namespace rd
+
+#endif	  // RD_WIRE_REACTOR_SUPPORTED
@@ -0,0 +1,123 @@
+#ifndef RD_CPP_WIREREACTOR_H
+#define RD_CPP_WIREREACTOR_H
+
+#if defined(__linux__)
+#define RD_WIRE_REACTOR_SUPPORTED 1
+#endif
+
+#ifdef RD_WIRE_REACTOR_SUPPORTED
+
+#include "spdlog/spdlog.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Single event loop thread multiplexing sockets of many wires with epoll. Periodic work such as heartbeats
+ * is driven by a hashed timer wheel of the same loop, so a wire attached to the reactor needs no threads of its own
+ * for receiving and pinging.
+ */
+class RD_FRAMEWORK_API WireReactor
+{
+public:
+	using timer_id = uint64_t;
+
+	static constexpr std::chrono::milliseconds TICK = std::chrono::milliseconds(10);
+	static constexpr size_t WHEEL_SIZE = 512;
+
+private:
+	struct Timer
+	{
+		uint64_t period_ticks;
+		uint64_t rounds;
+		std::shared_ptr<std::function<void()>> action;
+	};
+
+	static std::shared_ptr<spdlog::logger> logger;
+
+	std::string name;
+
+	int epoll_fd = -1;
+	int wake_fd = -1;
+
+	std::atomic<bool> stopped{false};
+	std::thread thread;
+
+	std::mutex lock;
+	// held by the loop while it runs callbacks, so removal from other threads can wait for a running callback
+	std::recursive_mutex dispatch_lock;
+
+	std::unordered_map<int, std::shared_ptr<std::function<void()>>> handlers;
+	std::vector<std::function<void()>> posted;
+
+	std::array<std::vector<timer_id>, WHEEL_SIZE> wheel;
+	std::unordered_map<timer_id, Timer> timers;
+	size_t current_slot = 0;
+	timer_id next_timer_id = 1;
+
+	void run();
+
+	void wake() const;
+
+	void place(timer_id id, Timer& timer, uint64_t delay_ticks);
+
+	void tick();
+
+public:
+	// region ctor/dtor
+
+	explicit WireReactor(std::string name = "WireReactor");
+
+	WireReactor(WireReactor const&) = delete;
+
+	WireReactor& operator=(WireReactor const&) = delete;
+
+	virtual ~WireReactor();
+	// endregion
+
+	/**
+	 * \brief Calls [on_readable] on the reactor thread whenever [fd] has data to read.
+	 */
+	void add_socket(int fd, std::function<void()> on_readable);
+
+	/**
+	 * \brief Unregisters [fd]. Returns after a running callback of it has finished unless called on the reactor thread.
+	 */
+	void remove_socket(int fd);
+
+	/**
+	 * \brief Runs [action] on the reactor thread after [delay] and then every [period], unless [period] is zero.
+	 */
+	timer_id schedule(std::chrono::milliseconds delay, std::chrono::milliseconds period, std::function<void()> action);
+
+	void cancel(timer_id id);
+
+	/**
+	 * \brief Runs [action] on the reactor thread as soon as possible.
+	 */
+	void post(std::function<void()> action);
+
+	/**
+	 * \brief Returns once callbacks running on the reactor thread have finished, does nothing on the reactor thread.
+	 */
+	void synchronize();
+
+	bool is_reactor_thread() const;
+};
+}	 // namespace rd
+
+#endif	  // RD_WIRE_REACTOR_SUPPORTED
+
+#endif	  // RD_CPP_WIREREACTOR_H
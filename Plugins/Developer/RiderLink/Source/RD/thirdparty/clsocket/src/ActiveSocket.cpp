@@ -244,6 +244,42 @@ bool CActiveSocket::ConnectRAW(const char *pAddr, uint16_t nPort)
 }
 
 
+//------------------------------------------------------------------------------
+//
+// ConnectUnix() - Create a connection to a Unix domain socket at the path
+//
+//------------------------------------------------------------------------------
+bool CActiveSocket::ConnectUnix(const char *pPath)
+{
+    bool bRetVal = false;
+
+#if defined(__linux__) || defined(_DARWIN)
+    struct sockaddr_un stAddr;
+
+    memset(&stAddr, 0, sizeof(stAddr));
+    stAddr.sun_family = AF_UNIX;
+    if (strlen(pPath) >= sizeof(stAddr.sun_path))
+    {
+        SetSocketError(CSimpleSocket::SocketInvalidAddress);
+        return bRetVal;
+    }
+    strncpy(stAddr.sun_path, pPath, sizeof(stAddr.sun_path) - 1);
+
+    m_timer.Initialize();
+    m_timer.SetStartTime();
+
+    bRetVal = connect(m_socket, (struct sockaddr*)&stAddr, sizeof(stAddr)) != CSimpleSocket::SocketError;
+    TranslateSocketError();
+
+    m_timer.SetEndTime();
+#else
+    SetSocketError(CSimpleSocket::SocketProtocolError);
+#endif
+
+    return bRetVal;
+}
+
+
 //------------------------------------------------------------------------------
 //
 // Open() - Create a connection to a specified address on a specified port
@@ -265,6 +301,11 @@ bool CActiveSocket::Open(const char *pAddr, uint16_t nPort)
         return bRetVal;
     }
 
+    if (IsUnixDomain())
+    {
+        return ConnectUnix(pAddr);
+    }
+
     if (nPort == 0)
     {
         SetSocketError(CSimpleSocket::SocketInvalidPort);
@@ -73,6 +73,8 @@ public:
     ///  @param pAddr specifies the destination address to connect.
     ///  @param nPort specifies the destination port.
     ///  @return true if successful connection made, otherwise false.
+    /// <br>\b Note: For CSimpleSocket::SocketTypeUnix pAddr is the path of the
+    /// socket and nPort is ignored.
     virtual bool Open(const char *pAddr, uint16_t nPort);
 
 private:
@@ -88,6 +90,10 @@ private:
     ///  @return true if successful connection made, otherwise false.
     bool ConnectRAW(const char *pAddr, uint16_t nPort);
 
+    /// Utility function used to create a Unix domain connection, called from Open().
+    ///  @return true if successful connection made, otherwise false.
+    bool ConnectUnix(const char *pPath);
+
 private:
     struct hostent *m_pHE;
 };
@@ -112,6 +112,57 @@ bool CPassiveSocket::BindMulticast(const char *pInterface, const char *pGroup, u
 }
 
 
+//------------------------------------------------------------------------------
+//
+// ListenUnix() -
+//
+//------------------------------------------------------------------------------
+bool CPassiveSocket::ListenUnix(const char *pPath, int32_t nConnectionBacklog) {
+    bool bRetVal = false;
+
+#if defined(__linux__) || defined(_DARWIN)
+    struct sockaddr_un stAddr;
+    struct stat stFile;
+
+    memset(&stAddr, 0, sizeof(stAddr));
+    stAddr.sun_family = AF_UNIX;
+    if ((pPath == NULL) || (strlen(pPath) == 0) || (strlen(pPath) >= sizeof(stAddr.sun_path))) {
+        SetSocketError(CSimpleSocket::SocketInvalidAddress);
+        return bRetVal;
+    }
+    strncpy(stAddr.sun_path, pPath, sizeof(stAddr.sun_path) - 1);
+
+    // a socket left by a process which didn't close it blocks bind, other files are kept
+    if ((stat(pPath, &stFile) == 0) && S_ISSOCK(stFile.st_mode)) {
+        unlink(pPath);
+    }
+
+    m_timer.Initialize();
+    m_timer.SetStartTime();
+
+    if (bind(m_socket, (struct sockaddr *) &stAddr, sizeof(stAddr)) != CSimpleSocket::SocketError) {
+        if (listen(m_socket, nConnectionBacklog) != CSimpleSocket::SocketError) {
+            bRetVal = true;
+        }
+    }
+
+    m_timer.SetEndTime();
+
+    TranslateSocketError();
+
+    if (bRetVal == false) {
+        CSocketError err = GetSocketError();
+        Close();
+        SetSocketError(err);
+    }
+#else
+    SetSocketError(CSimpleSocket::SocketProtocolError);
+#endif
+
+    return bRetVal;
+}
+
+
 //------------------------------------------------------------------------------
 //
 // Listen() -
@@ -119,6 +170,10 @@ bool CPassiveSocket::BindMulticast(const char *pInterface, const char *pGroup, u
 //------------------------------------------------------------------------------
 bool CPassiveSocket::Listen(const char *pAddr, uint16_t nPort, int32_t nConnectionBacklog) {
     bool bRetVal = false;
+
+    if (IsUnixDomain()) {
+        return ListenUnix(pAddr, nConnectionBacklog);
+    }
 #ifdef _WIN32
     ULONG inAddr;
 #else
@@ -226,6 +281,7 @@ CActiveSocket *CPassiveSocket::Accept() {
 
             if (socket != static_cast<SOCKET>(-1)) {
                 pClientSocket->SetSocketHandle(socket);
+                pClientSocket->m_nSocketDomain = m_nSocketDomain;
                 pClientSocket->TranslateSocketError();
                 socketErrno = pClientSocket->GetSocketError();
                 socklen_t nSockLen = sizeof(struct sockaddr);
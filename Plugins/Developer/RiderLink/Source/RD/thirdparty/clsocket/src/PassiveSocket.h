@@ -95,6 +95,8 @@ public:
     ///      conditions will be set: CPassiveSocket::SocketAddressInUse, CPassiveSocket::SocketProtocolError,
     ///      CPassiveSocket::SocketInvalidSocket.  The following new_socket errors are for Linux/Unix
     ///      derived systems only: CPassiveSocket::SocketInvalidSocketBuffer
+    /// <br>\b Note: For CSimpleSocket::SocketTypeUnix pAddr is the path of the
+    /// socket and nPort is ignored. A socket left at the path is replaced.
     virtual bool Listen(const char *pAddr, uint16_t nPort, int32_t nConnectionBacklog = 30000);
 
     /// Attempts to send a block of data on an established connection.
@@ -112,6 +114,9 @@ public:
     virtual int32_t Send(const uint8_t *pBuf, size_t bytesToSend);
 
 private:
+    /// Utility function used to listen on a Unix domain socket, called from Listen().
+    bool ListenUnix(const char *pPath, int32_t nConnectionBacklog);
+
     struct ip_mreq  m_stMulticastRequest;   /// group address for multicast
 
 };
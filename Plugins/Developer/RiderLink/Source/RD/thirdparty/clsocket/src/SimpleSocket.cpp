@@ -98,6 +98,19 @@ CSimpleSocket::CSimpleSocket(CSocketType nType) :
 #endif
 #ifdef _WIN32
         m_nSocketType = CSimpleSocket::SocketTypeInvalid;
+#endif
+        break;
+    }
+    //----------------------------------------------------------------------
+    // Declare socket type stream - Unix domain
+    //----------------------------------------------------------------------
+    case CSimpleSocket::SocketTypeUnix:
+    {
+#if defined(__linux__) || defined(_DARWIN)
+        m_nSocketDomain = AF_UNIX;
+        m_nSocketType = CSimpleSocket::SocketTypeTcp;
+#else
+        m_nSocketType = CSimpleSocket::SocketTypeInvalid;
 #endif
         break;
     }
@@ -336,6 +349,11 @@ bool CSimpleSocket::DisableNagleAlgoritm()
     bool  bRetVal = false;
     int32_t nTcpNoDelay = 1;
 
+    if (IsUnixDomain())
+    {
+        return true;
+    }
+
     //----------------------------------------------------------------------
     // Set TCP NoDelay flag to true
     //----------------------------------------------------------------------
@@ -350,6 +368,21 @@ bool CSimpleSocket::DisableNagleAlgoritm()
 }
 
 
+//------------------------------------------------------------------------------
+//
+// IsUnixDomain()
+//
+//------------------------------------------------------------------------------
+bool CSimpleSocket::IsUnixDomain() const
+{
+#if defined(__linux__) || defined(_DARWIN)
+    return m_nSocketDomain == AF_UNIX;
+#else
+    return false;
+#endif
+}
+
+
 //------------------------------------------------------------------------------
 //
 // EnableNagleAlgorithm()
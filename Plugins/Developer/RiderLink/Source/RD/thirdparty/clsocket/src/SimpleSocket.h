@@ -56,6 +56,7 @@
 #include <netinet/tcp.h>
 #include <netinet/ip.h>
 #include <netdb.h>
+#include <sys/un.h>
 #endif
 #ifdef __linux__
 #include <linux/if_packet.h>
@@ -120,7 +121,9 @@ public:
         SocketTypeUdp,       ///< Defines socket as UDP socket.
         SocketTypeTcp6,      ///< Defines socket as IPv6 TCP socket.
         SocketTypeUdp6,      ///< Defines socket as IPv6 UDP socket.
-        SocketTypeRaw        ///< Provides raw network protocol access.
+        SocketTypeRaw,       ///< Provides raw network protocol access.
+        SocketTypeUnix       ///< Defines socket as Unix domain stream socket, it's handled as a TCP one
+                             ///< except for addressing. Not supported on Windows.
     } CSocketType;
 
     /// Defines all error codes handled by the CSimpleSocket class.
@@ -509,8 +512,13 @@ public:
 
     /// Disable the Nagle algorithm (Set TCP_NODELAY to true)
     /// @return false if failed to set socket option otherwise return true;
+    /// <br>\b Note: Unix domain sockets don't delay sends, so it does nothing for them.
     bool DisableNagleAlgoritm();
 
+    /// Is the socket created as CSimpleSocket::SocketTypeUnix.
+    ///  @return true if addresses of the socket are file system paths.
+    bool IsUnixDomain(void) const;
+
     /// Enable the Nagle algorithm (Set TCP_NODELAY to false)
     /// @return false if failed to set socket option otherwise return true;
     bool EnableNagleAlgoritm();
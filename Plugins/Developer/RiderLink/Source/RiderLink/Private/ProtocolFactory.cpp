@@ -94,9 +94,18 @@ void ProtocolFactory::InitRdLogging()
 
 std::shared_ptr<rd::SocketWire::Server> ProtocolFactory::CreateWire(rd::IScheduler* Scheduler, rd::Lifetime SocketLifetime)
 {
-    return std::make_shared<rd::SocketWire::Server>(SocketLifetime, Scheduler, 0,
-                                                         TCHAR_TO_UTF8(*FString::Printf(TEXT("UnrealEditorServer-%s"),
-                                                             *ProjectName)));
+    const std::string Id = TCHAR_TO_UTF8(*FString::Printf(TEXT("UnrealEditorServer-%s"), *ProjectName));
+#if defined(ENABLE_UNIX_SOCKET) && ENABLE_UNIX_SOCKET == 1 && !PLATFORM_WINDOWS
+    // The socket lives next to the port file, which then holds its path instead of the port
+    auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const FString PortFullDirectoryPath = GetPathToPortsFolder();
+    if (PlatformFile.CreateDirectoryTree(*PortFullDirectoryPath))
+    {
+        const FString SocketPath = FPaths::Combine(*PortFullDirectoryPath, ProjectName + TEXT(".sock"));
+        return std::make_shared<rd::SocketWire::Server>(SocketLifetime, Scheduler, std::string(TCHAR_TO_UTF8(*SocketPath)), Id);
+    }
+#endif
+    return std::make_shared<rd::SocketWire::Server>(SocketLifetime, Scheduler, 0, Id);
 }
 
 
@@ -111,7 +120,8 @@ TUniquePtr<rd::Protocol> ProtocolFactory::CreateProtocol(rd::IScheduler* Schedul
         const FString ProjectFileName = ProjectName + TEXT(".uproject");
         const FString TmpPortFile = TEXT("~") + ProjectFileName;
         const FString TmpPortFileFullPath = FPaths::Combine(*PortFullDirectoryPath, *TmpPortFile);
-        FFileHelper::SaveStringToFile(FString::FromInt(wire->port), *TmpPortFileFullPath);
+        const FString Address = wire->path.empty() ? FString::FromInt(wire->port) : FString(UTF8_TO_TCHAR(wire->path.c_str()));
+        FFileHelper::SaveStringToFile(Address, *TmpPortFileFullPath);
         const FString PortFileFullPath = FPaths::Combine(*PortFullDirectoryPath, *ProjectFileName);
         IFileManager::Get().Move(*PortFileFullPath, *TmpPortFileFullPath, true, true);
     }
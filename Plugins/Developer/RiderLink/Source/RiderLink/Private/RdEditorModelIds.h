@@ -0,0 +1,31 @@
+#pragma once
+
+#include "protocol/RdId.h"
+
+/**
+ * Ids RdEditorModel and its fields get once the model is connected, precomputed from the names which the generated
+ * RdEditorModel::connect and RdEditorModel::identify mix. They allow to set up the wire for the fields before the model
+ * is connected. The generated model isn't changed for them, so a renamed field has to be renamed here as well.
+ */
+namespace RdEditorModelIds
+{
+	constexpr rd::RdId Model = rd::RdId::Null().mix("RdEditorModel");
+
+	constexpr rd::RdId ConnectionInfo = Model.mix(".connectionInfo");
+	constexpr rd::RdId UnrealLog = Model.mix(".unrealLog");
+	constexpr rd::RdId OpenBlueprint = Model.mix(".openBlueprint");
+	constexpr rd::RdId OnBlueprintAdded = Model.mix(".onBlueprintAdded");
+	constexpr rd::RdId IsBlueprintPathName = Model.mix(".isBlueprintPathName");
+	constexpr rd::RdId GetPathNameByPath = Model.mix(".getPathNameByPath");
+	constexpr rd::RdId AllowSetForegroundWindow = Model.mix(".allowSetForegroundWindow");
+	constexpr rd::RdId IsGameControlModuleInitialized = Model.mix(".isGameControlModuleInitialized");
+	constexpr rd::RdId PlayStateFromEditor = Model.mix(".playStateFromEditor");
+	constexpr rd::RdId RequestPlayFromRider = Model.mix(".requestPlayFromRider");
+	constexpr rd::RdId RequestPauseFromRider = Model.mix(".requestPauseFromRider");
+	constexpr rd::RdId RequestResumeFromRider = Model.mix(".requestResumeFromRider");
+	constexpr rd::RdId RequestStopFromRider = Model.mix(".requestStopFromRider");
+	constexpr rd::RdId RequestFrameSkipFromRider = Model.mix(".requestFrameSkipFromRider");
+	constexpr rd::RdId NotificationReplyFromEditor = Model.mix(".notificationReplyFromEditor");
+	constexpr rd::RdId PlayModeFromEditor = Model.mix(".playModeFromEditor");
+	constexpr rd::RdId PlayModeFromRider = Model.mix(".playModeFromRider");
+}
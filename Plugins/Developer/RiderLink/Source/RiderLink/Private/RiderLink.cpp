@@ -1,6 +1,7 @@
 #include "RiderLink.hpp"
 
 #include "ProtocolFactory.h"
+#include "RdEditorModelIds.h"
 #include "UE4Library/UE4Library.Generated.h"
 
 #include "Misc/App.h"
@@ -46,6 +47,14 @@ void FRiderLinkModule::InitProtocol()
 	WireLifetimeDef = MakeUnique<rd::LifetimeDefinition>(ModuleLifetimeDef.lifetime);
 	rd::Lifetime WireLifetime = WireLifetimeDef->lifetime;
 	std::shared_ptr<rd::SocketWire::Server> Wire = ProtocolFactory->CreateWire(&Scheduler, WireLifetime);
+	// Interactive requests and replies to Rider's blueprint queries go ahead of the log stream, which is sent behind
+	// everything else. The ids are static, so lanes are set before anything of the model is sent. None of these fields
+	// carries bindable values or depends on the state of another one, so they may overtake the rest of the model.
+	Wire->set_priority(RdEditorModelIds::AllowSetForegroundWindow, rd::ByteBufferAsyncProcessor::Priority::High);
+	Wire->set_priority(RdEditorModelIds::IsBlueprintPathName, rd::ByteBufferAsyncProcessor::Priority::High);
+	Wire->set_priority(RdEditorModelIds::GetPathNameByPath, rd::ByteBufferAsyncProcessor::Priority::High);
+	Wire->set_priority(RdEditorModelIds::PlayStateFromEditor, rd::ByteBufferAsyncProcessor::Priority::High);
+	Wire->set_priority(RdEditorModelIds::UnrealLog, rd::ByteBufferAsyncProcessor::Priority::Low);
 	Protocol = ProtocolFactory->CreateProtocol(&Scheduler, WireLifetime.create_nested(), Wire);
 	// Exception fired for Server::Base::~Base() when trying to invoke it this way
 //	WireLifetime->add_action([this]()
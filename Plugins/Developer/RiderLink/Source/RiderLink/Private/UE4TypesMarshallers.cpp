@@ -1,5 +1,8 @@
 #include "UE4TypesMarshallers.h"
 
+#include "UE4Library/ConnectionInfo.Generated.h"
+#include "UE4Library/LogMessageInfo.Generated.h"
+
 #include "Containers/StringConv.h"
 #include "serialization/ArraySerializer.h"
 #include "Templates/UniquePtr.h"
@@ -9,10 +12,19 @@
 namespace rd {
 
     FString Polymorphic<FString, void>::read(SerializationCtx& ctx, Buffer& buffer) {
-        UCS2CHAR * str = buffer.read_char16_string();
-        FString tmp{str};
-        delete str;
-        return tmp;
+        FString result;
+        TArray<TCHAR>& chars = result.GetCharArray();
+        const size_t len = buffer.read_char16_string([&chars](size_t capacity) {
+            chars.SetNumUninitialized(static_cast<int32>(capacity) + 1);
+            return reinterpret_cast<uint16_t*>(chars.GetData());
+        });
+        if (len == 0) {
+            chars.Reset();
+        } else {
+            chars[static_cast<int32>(len)] = TEXT('\0');
+            chars.SetNumUninitialized(static_cast<int32>(len) + 1);
+        }
+        return result;
     }
 
     void Polymorphic<FString, void>::write(SerializationCtx& ctx, Buffer& buffer, FString const& value) {
@@ -33,3 +45,23 @@ template struct rd::hash<FString>;
 // template class rd::Polymorphic<TArray<FString>, void>;
 
 //endregion
+
+//region UE4Library
+
+namespace rd {
+
+    size_t SerializedSize<JetBrains::EditorPlugin::ConnectionInfo>::get(SerializationCtx& ctx,
+        JetBrains::EditorPlugin::ConnectionInfo const& value) {
+        return serialized_size(ctx, value.get_projectName()) + serialized_size(ctx, value.get_executableName()) +
+            serialized_size(ctx, value.get_processId());
+    }
+
+    size_t SerializedSize<JetBrains::EditorPlugin::LogMessageInfo>::get(SerializationCtx& ctx,
+        JetBrains::EditorPlugin::LogMessageInfo const& value) {
+        return serialized_size(ctx, value.get_type()) + serialized_size(ctx, value.get_category()) +
+            serialized_size(ctx, value.get_time());
+    }
+
+}
+
+//endregion
@@ -17,7 +17,7 @@ class Polymorphic<ELogVerbosity::Type> {
 
 public:
     static ELogVerbosity::Type read(SerializationCtx& ctx, Buffer& buffer) {
-        int32_t x = buffer.read_integral<int32_t>();
+        int32_t x = buffer.read_varint32();
         switch (x) {
         case 10:
            return ELogVerbosity::Type::VerbosityMask;
@@ -33,19 +33,19 @@ public:
     static void write(SerializationCtx& ctx, Buffer& buffer, ELogVerbosity::Type const& value) {
         switch (value) {
         case ELogVerbosity::Type::VerbosityMask: {
-           buffer.write_integral<int32_t>(10);
+           buffer.write_varint32(10);
            return;
         }
         case ELogVerbosity::Type::SetColor: {
-           buffer.write_integral<int32_t>(11);
+           buffer.write_varint32(11);
            return;
         }
         case ELogVerbosity::Type::BreakOnLog: {
-           buffer.write_integral<int32_t>(12);
+           buffer.write_varint32(12);
            return;
         }
         default:
-            buffer.write_integral<int32_t>(static_cast<int32_t>(value));
+            buffer.write_varint32(static_cast<int32_t>(value));
         }
     }
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "serialization/Polymorphic.h"
+#include "serialization/SerializedSize.h"
 #include "std/hash.h"
 
 #include "Containers/UnrealString.h"
@@ -8,6 +9,14 @@
 #include "Templates/UniquePtr.h"
 
 
+namespace JetBrains {
+namespace EditorPlugin {
+    class ConnectionInfo;
+    class LogMessageInfo;
+    class StringRange;
+}
+}
+
 //region FString
 
 inline std::string to_string(FString const& val) {
@@ -33,6 +42,13 @@ namespace rd {
         static void write(SerializationCtx& ctx, Buffer& buffer, FString const& value);
     };
 
+    template <>
+    struct SerializedSize<FString> {
+        static size_t get(SerializationCtx& ctx, FString const& value) {
+            return sizeof(int32_t) + sizeof(uint16_t) * value.Len();
+        }
+    };
+
     template <>
     class Polymorphic<Wrapper<FString>> {
     public:
@@ -66,3 +82,30 @@ extern template struct rd::hash<FString>;
 // extern template class rd::Polymorphic<TArray<FString>, void>;
 
 //endregion
+
+//region UE4Library
+
+// Sizes of generated classes which have a known layout, kept out of the generated code so they survive regeneration.
+// Declared before the classes are defined, since every generated header of UE4Library includes this one.
+namespace rd {
+    template <>
+    struct SerializedSize<JetBrains::EditorPlugin::ConnectionInfo> {
+        static size_t get(SerializationCtx& ctx, JetBrains::EditorPlugin::ConnectionInfo const& value);
+    };
+
+    template <>
+    struct SerializedSize<JetBrains::EditorPlugin::LogMessageInfo> {
+        static size_t get(SerializationCtx& ctx, JetBrains::EditorPlugin::LogMessageInfo const& value);
+    };
+
+    template <>
+    struct SerializedSize<JetBrains::EditorPlugin::StringRange> {
+        static constexpr size_t value = 2 * sizeof(int32_t);
+
+        static size_t get(SerializationCtx& /*ctx*/, JetBrains::EditorPlugin::StringRange const& /*value*/) {
+            return value;
+        }
+    };
+}
+
+//endregion
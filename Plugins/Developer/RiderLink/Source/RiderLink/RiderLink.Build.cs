@@ -23,6 +23,8 @@ public class RiderLink : ModuleRules
 		};
 		
 		PrivateDefinitions.Add("ENABLE_LOG_FILE=0");
+		// Serve the protocol on a Unix domain socket instead of TCP, the client has to read a path from the port file
+		PrivateDefinitions.Add("ENABLE_UNIX_SOCKET=0");
 
 		foreach(var Item in Paths)
 		{
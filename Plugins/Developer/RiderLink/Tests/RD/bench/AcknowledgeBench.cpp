@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include "wire/ByteBufferAsyncProcessor.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Sends range(0) packages of 64 bytes and times acknowledging them, either one by one as the receiver of
+ * SocketWire did before or by a single cumulative ack. Only the acks are timed.
+ */
+void acknowledge(benchmark::State& state, bool cumulative)
+{
+	spdlog::set_level(spdlog::level::off);
+	std::atomic<sequence_number_t> sent{0};
+	ByteBufferAsyncProcessor processor(
+		"bench-ack", [&sent](ByteBufferAsyncProcessor::batch_t const& batch, sequence_number_t first_seqn) {
+			sent = first_seqn + static_cast<sequence_number_t>(batch.size()) - 1;
+			return true;
+		});
+	processor.start();
+	const auto packages = static_cast<sequence_number_t>(state.range(0));
+	sequence_number_t acknowledged = 0;
+	for (auto _ : state)
+	{
+		for (sequence_number_t i = 0; i < packages; ++i)
+		{
+			processor.put(Buffer::ByteArray(64));
+		}
+		while (sent < acknowledged + packages)
+		{
+			std::this_thread::yield();
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		if (cumulative)
+		{
+			acknowledged += packages;
+			processor.acknowledge(acknowledged);
+		}
+		else
+		{
+			for (sequence_number_t i = 0; i < packages; ++i)
+			{
+				processor.acknowledge(++acknowledged);
+			}
+		}
+		state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
+	// waits for the async thread, which may still be sending, before the processor is destroyed
+	processor.terminate(std::chrono::seconds(10));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}	 // namespace
+
+// acknowledging 16 and 256 sent packages
+BENCHMARK_CAPTURE(acknowledge, each, false)->Arg(16)->Arg(256)->UseManualTime();
+BENCHMARK_CAPTURE(acknowledge, cumulative, true)->Arg(16)->Arg(256)->UseManualTime();
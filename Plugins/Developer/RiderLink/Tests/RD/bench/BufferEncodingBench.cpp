@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include "protocol/Buffer.h"
+
+#include <string>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Writes range(0) map updates the way RdMap does: an op tag, a version, an index and a short string value.
+ */
+void write_updates(Buffer& buffer, int64_t count, std::wstring const& value)
+{
+	for (int64_t i = 0; i < count; ++i)
+	{
+		buffer.write_varint32(static_cast<int32_t>(i % 3));
+		buffer.write_varint32(static_cast<int32_t>(i));
+		buffer.write_varint32(static_cast<int32_t>(i % 100));
+		buffer.write_wstring(value);
+	}
+}
+
+void write(benchmark::State& state, Buffer::Encoding encoding)
+{
+	const std::wstring value(8, L'a');
+	size_t size = 0;
+	for (auto _ : state)
+	{
+		Buffer buffer;
+		buffer.set_encoding(encoding);
+		write_updates(buffer, state.range(0), value);
+		size = buffer.get_position();
+		benchmark::DoNotOptimize(buffer.data());
+	}
+	state.counters["bytes"] = static_cast<double>(size);
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void read(benchmark::State& state, Buffer::Encoding encoding)
+{
+	Buffer written;
+	written.set_encoding(encoding);
+	write_updates(written, state.range(0), std::wstring(8, L'a'));
+	const size_t size = written.get_position();
+	for (auto _ : state)
+	{
+		written.rewind();
+		for (int64_t i = 0; i < state.range(0); ++i)
+		{
+			benchmark::DoNotOptimize(written.read_varint32());
+			benchmark::DoNotOptimize(written.read_varint32());
+			benchmark::DoNotOptimize(written.read_varint32());
+			benchmark::DoNotOptimize(written.read_wstring());
+		}
+	}
+	state.counters["bytes"] = static_cast<double>(size);
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}	 // namespace
+
+// tags, versions and lengths as fixed int32 against varints, bytes is the size of the written buffer
+BENCHMARK_CAPTURE(write, fixed, Buffer::Encoding::FIXED)->Arg(1)->Arg(64)->Arg(1024);
+BENCHMARK_CAPTURE(write, compact, Buffer::Encoding::COMPACT)->Arg(1)->Arg(64)->Arg(1024);
+BENCHMARK_CAPTURE(read, fixed, Buffer::Encoding::FIXED)->Arg(1)->Arg(64)->Arg(1024);
+BENCHMARK_CAPTURE(read, compact, Buffer::Encoding::COMPACT)->Arg(1)->Arg(64)->Arg(1024);
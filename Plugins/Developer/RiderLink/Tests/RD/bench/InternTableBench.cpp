@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#include "intern/InternTable.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+constexpr int32_t VALUES = 256;
+
+/**
+ * \brief Interned values as InternRoot kept them before: an ordered map under its recursive lock.
+ */
+class LockedInternMap
+{
+	mutable std::recursive_mutex lock;
+	ordered_map<InternedAny, int32_t, any::TransparentHash, any::TransparentKeyEqual> inverse_map;
+
+public:
+	int32_t intern(InternedAny const& value)
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		auto it = inverse_map.find(value);
+		if (it != inverse_map.end())
+		{
+			return it->second;
+		}
+		const int32_t id = static_cast<int32_t>(inverse_map.size()) * 2;
+		inverse_map.emplace(value, id);
+		return id;
+	}
+};
+
+/**
+ * \brief The lookup path of InternRoot::intern_value, inserting and publishing values it doesn't know yet.
+ */
+class LockFreeInternTable
+{
+	InternTable table;
+
+public:
+	int32_t intern(InternedAny const& value)
+	{
+		const size_t hash = InternTable::hash(value);
+		if (InternTable::Entry* entry = table.find(value, hash))
+		{
+			return entry->id;
+		}
+		bool inserted = false;
+		InternTable::Entry* entry = table.find_or_insert(value, hash, inserted);
+		if (table.claim(entry, inserted))
+		{
+			table.publish(entry);
+		}
+		return entry->id;
+	}
+};
+
+std::vector<InternedAny> make_values()
+{
+	std::vector<InternedAny> result;
+	for (int32_t i = 0; i < VALUES; ++i)
+	{
+		result.push_back(any::make_interned_any<std::wstring>(Wrapper<std::wstring>(L"value " + std::to_wstring(i))));
+	}
+	return result;
+}
+
+/**
+ * \brief Every thread interns values already known, as serializers of repeated strings do.
+ */
+template <typename Table>
+void intern_known(benchmark::State& state)
+{
+	static std::unique_ptr<Table> table;
+	static const std::vector<InternedAny> values = make_values();
+	if (state.thread_index() == 0)
+	{
+		table = std::make_unique<Table>();
+		for (auto const& value : values)
+		{
+			table->intern(value);
+		}
+	}
+	size_t i = static_cast<size_t>(state.thread_index());
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(table->intern(values[i++ % VALUES]));
+	}
+	if (state.thread_index() == 0)
+	{
+		table.reset();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+}	 // namespace
+
+// interning known strings from 1 to 4 threads
+BENCHMARK_TEMPLATE(intern_known, LockedInternMap)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK_TEMPLATE(intern_known, LockFreeInternTable)->ThreadRange(1, 4)->UseRealTime();
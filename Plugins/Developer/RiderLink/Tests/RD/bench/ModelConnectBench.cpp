@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+
+#include "base/IWire.h"
+#include "ext/RdExtBase.h"
+#include "impl/RdSignal.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SynchronousScheduler.h"
+
+#include <array>
+#include <memory>
+
+using namespace rd;
+
+namespace
+{
+class NullWire : public IWire
+{
+public:
+	void send(RdId const& /*id*/, std::function<void(Buffer& buffer)> /*writer*/) const override
+	{
+	}
+
+	void advise(Lifetime /*lifetime*/, IRdReactive const* /*entity*/) const override
+	{
+	}
+};
+
+constexpr size_t FIELD_COUNT = 17;
+
+// the fields of RdEditorModel, which can't be built without Unreal Engine
+constexpr std::array<string_view, FIELD_COUNT> FIELDS{"connectionInfo", "unrealLog", "openBlueprint", "onBlueprintAdded",
+	"isBlueprintPathName", "getPathNameByPath", "allowSetForegroundWindow", "isGameControlModuleInitialized",
+	"playStateFromEditor", "requestPlayFromRider", "requestPauseFromRider", "requestResumeFromRider", "requestStopFromRider",
+	"requestFrameSkipFromRider", "notificationReplyFromEditor", "playModeFromEditor", "playModeFromRider"};
+constexpr std::array<string_view, FIELD_COUNT> MIXED_FIELDS{".connectionInfo", ".unrealLog", ".openBlueprint",
+	".onBlueprintAdded", ".isBlueprintPathName", ".getPathNameByPath", ".allowSetForegroundWindow",
+	".isGameControlModuleInitialized", ".playStateFromEditor", ".requestPlayFromRider", ".requestPauseFromRider",
+	".requestResumeFromRider", ".requestStopFromRider", ".requestFrameSkipFromRider", ".notificationReplyFromEditor",
+	".playModeFromEditor", ".playModeFromRider"};
+
+constexpr RdId MODEL = RdId::Null().mix("RdEditorModel");
+constexpr std::array<RdId, FIELD_COUNT> FIELD_IDS{MODEL.mix(".connectionInfo"), MODEL.mix(".unrealLog"),
+	MODEL.mix(".openBlueprint"), MODEL.mix(".onBlueprintAdded"), MODEL.mix(".isBlueprintPathName"),
+	MODEL.mix(".getPathNameByPath"), MODEL.mix(".allowSetForegroundWindow"), MODEL.mix(".isGameControlModuleInitialized"),
+	MODEL.mix(".playStateFromEditor"), MODEL.mix(".requestPlayFromRider"), MODEL.mix(".requestPauseFromRider"),
+	MODEL.mix(".requestResumeFromRider"), MODEL.mix(".requestStopFromRider"), MODEL.mix(".requestFrameSkipFromRider"),
+	MODEL.mix(".notificationReplyFromEditor"), MODEL.mix(".playModeFromEditor"), MODEL.mix(".playModeFromRider")};
+
+/**
+ * \brief Connects like the generated RdEditorModel, identifying its fields either the generated way, by mixing their
+ * names, or with precomputed ids.
+ */
+class Model : public RdExtBase
+{
+	std::array<RdSignal<int32_t>, FIELD_COUNT> fields;
+	const bool precomputed;
+
+public:
+	explicit Model(bool precomputed) : precomputed(precomputed)
+	{
+	}
+
+	void connect(Lifetime lifetime, IProtocol const* protocol)
+	{
+		identify(*(protocol->get_identity()), precomputed ? MODEL : RdId::Null().mix("RdEditorModel"));
+		bind(lifetime, protocol, "RdEditorModel");
+	}
+
+	void init(Lifetime lifetime) const override
+	{
+		RdExtBase::init(lifetime);
+		for (size_t i = 0; i < FIELD_COUNT; ++i)
+		{
+			bindPolymorphic(fields[i], lifetime, this, FIELDS[i]);
+		}
+	}
+
+	void identify(Identities const& identities, RdId const& id) const override
+	{
+		RdBindableBase::identify(identities, id);
+		for (size_t i = 0; i < FIELD_COUNT; ++i)
+		{
+			identifyPolymorphic(fields[i], identities, precomputed ? FIELD_IDS[i] : id.mix(MIXED_FIELDS[i]));
+		}
+	}
+};
+
+void connect(benchmark::State& state, bool precomputed)
+{
+	spdlog::set_level(spdlog::level::off);
+	LifetimeDefinition definition(Lifetime::Eternal());
+	Protocol protocol(Identities::SERVER, &SynchronousScheduler::Instance(), std::make_shared<NullWire>(), definition.lifetime);
+	for (auto _ : state)
+	{
+		LifetimeDefinition connection(definition.lifetime);
+		Model model(precomputed);
+		model.connect(connection.lifetime, &protocol);
+		benchmark::DoNotOptimize(model.get_id());
+		connection.terminate();
+	}
+}
+
+void identify(benchmark::State& state, bool precomputed)
+{
+	Identities identities(Identities::SERVER);
+	Model model(precomputed);
+	for (auto _ : state)
+	{
+		model.identify(identities, precomputed ? MODEL : RdId::Null().mix("RdEditorModel"));
+		benchmark::DoNotOptimize(model.get_id());
+	}
+}
+}	 // namespace
+
+// a connect of the editor model: identify and bind of the model and its fields
+BENCHMARK_CAPTURE(connect, mixing_names, false);
+BENCHMARK_CAPTURE(connect, precomputed_ids, true);
+// the part precomputed ids save
+BENCHMARK_CAPTURE(identify, mixing_names, false);
+BENCHMARK_CAPTURE(identify, precomputed_ids, true);
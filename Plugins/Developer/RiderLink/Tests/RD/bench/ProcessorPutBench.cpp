@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include "util/mpsc_queue.h"
+#include "wire/ByteBufferAsyncProcessor.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief The queue the put path used before: a deque under a lock shared by the producers and the consumer.
+ */
+template <typename T>
+class LockedQueue
+{
+	std::mutex lock;
+	std::deque<T> queue;
+
+public:
+	void push(T value)
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		queue.push_back(std::move(value));
+	}
+
+	bool try_pop(T& result)
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (queue.empty())
+		{
+			return false;
+		}
+		result = std::move(queue.front());
+		queue.pop_front();
+		return true;
+	}
+};
+
+/**
+ * \brief Every thread puts a package per iteration, the first one also drains the queue as the async thread would.
+ */
+template <typename Queue>
+void queue_put(benchmark::State& state)
+{
+	static std::unique_ptr<Queue> queue;
+	if (state.thread_index() == 0)
+	{
+		queue = std::make_unique<Queue>();
+	}
+	for (auto _ : state)
+	{
+		queue->push(Buffer::ByteArray(64));
+		if (state.thread_index() == 0)
+		{
+			Buffer::ByteArray package;
+			while (queue->try_pop(package))
+			{
+				benchmark::DoNotOptimize(package.data());
+			}
+		}
+	}
+	if (state.thread_index() == 0)
+	{
+		queue.reset();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Puts of 64-byte packages into a running processor, the first thread acknowledges what is sent now and then,
+ * like the receiver of SocketWire does.
+ */
+void processor_put(benchmark::State& state)
+{
+	static std::unique_ptr<ByteBufferAsyncProcessor> processor;
+	static std::atomic<sequence_number_t> sent{0};
+	if (state.thread_index() == 0)
+	{
+		spdlog::set_level(spdlog::level::off);
+		sent = 0;
+		processor = std::make_unique<ByteBufferAsyncProcessor>(
+			"bench", [](ByteBufferAsyncProcessor::batch_t const& batch, sequence_number_t first_seqn) {
+				sent = first_seqn + static_cast<sequence_number_t>(batch.size()) - 1;
+				return true;
+			});
+		processor->start();
+	}
+	size_t count = 0;
+	for (auto _ : state)
+	{
+		processor->put(Buffer::ByteArray(64));
+		if (state.thread_index() == 0 && ++count % 256 == 0)
+		{
+			processor->acknowledge(sent);
+		}
+	}
+	if (state.thread_index() == 0)
+	{
+		// waits for the async thread, which may still be sending, before the processor is destroyed
+		processor->terminate(std::chrono::seconds(10));
+		processor.reset();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+}	 // namespace
+
+// the queue between producers and the async thread, contended by 1 to 4 producers
+BENCHMARK_TEMPLATE(queue_put, LockedQueue<Buffer::ByteArray>)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK_TEMPLATE(queue_put, util::mpsc_queue<Buffer::ByteArray>)->ThreadRange(1, 4)->UseRealTime();
+// the whole put path, with the async thread sending meanwhile
+BENCHMARK(processor_put)->ThreadRange(1, 4)->UseRealTime();
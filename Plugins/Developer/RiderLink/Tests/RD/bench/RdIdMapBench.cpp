@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#include "protocol/RdId.h"
+#include "std/unordered_map.h"
+#include "util/rdid_map.h"
+
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief The node based map the entity registries used before, behind the interface of [util::rdid_map].
+ */
+template <typename V>
+class node_map
+{
+	rd::unordered_map<RdId, V> map;
+
+public:
+	V* find(RdId const& id)
+	{
+		auto it = map.find(id);
+		return it == map.end() ? nullptr : &it->second;
+	}
+
+	std::pair<V*, bool> try_emplace(RdId const& id, V value)
+	{
+		auto result = map.emplace(id, value);
+		return {&result.first->second, result.second};
+	}
+
+	bool erase(RdId const& id)
+	{
+		return map.erase(id) > 0;
+	}
+};
+
+/**
+ * \brief Ids of entities as the protocol makes them: hashes of names mixed into the id of the parent.
+ */
+std::vector<RdId> make_ids(int64_t count, int64_t salt)
+{
+	std::vector<RdId> result;
+	for (int64_t i = 0; i < count; ++i)
+	{
+		result.push_back(RdId::Null().mix("entity").mix(salt * count + i));
+	}
+	return result;
+}
+
+/**
+ * \brief Looks up range(0) ids in a map of range(0) entries, present ones if [hit] and absent ones otherwise.
+ */
+template <typename Map, bool hit>
+void find(benchmark::State& state)
+{
+	const std::vector<RdId> ids = make_ids(state.range(0), 0);
+	const std::vector<RdId> looked_up = hit ? ids : make_ids(state.range(0), 1);
+	Map map;
+	for (auto const& id : ids)
+	{
+		map.try_emplace(id, 1);
+	}
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(map.find(looked_up[i++ % looked_up.size()]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Binds and unbinds an entity in a map of range(0) entries.
+ */
+template <typename Map>
+void insert_erase(benchmark::State& state)
+{
+	const std::vector<RdId> ids = make_ids(state.range(0), 0);
+	const std::vector<RdId> churned = make_ids(state.range(0), 1);
+	Map map;
+	for (auto const& id : ids)
+	{
+		map.try_emplace(id, 1);
+	}
+	size_t i = 0;
+	for (auto _ : state)
+	{
+		RdId const& id = churned[i++ % churned.size()];
+		map.try_emplace(id, 1);
+		benchmark::DoNotOptimize(map.erase(id));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+}	 // namespace
+
+// lookups in registries of 64 and 4096 entities
+BENCHMARK_TEMPLATE(find, node_map<int64_t>, true)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(find, util::rdid_map<int64_t>, true)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(find, node_map<int64_t>, false)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(find, util::rdid_map<int64_t>, false)->Arg(64)->Arg(4096);
+// binding and unbinding
+BENCHMARK_TEMPLATE(insert_erase, node_map<int64_t>)->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(insert_erase, util::rdid_map<int64_t>)->Arg(64)->Arg(4096);
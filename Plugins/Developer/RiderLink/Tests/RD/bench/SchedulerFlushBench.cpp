@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include "lifetime/LifetimeDefinition.h"
+#include "scheduler/SingleThreadScheduler.h"
+#include "task/RdTask.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Benchmarks run several times and every scheduler registers a logger of its name, so the names must differ.
+ */
+std::string scheduler_name(std::string const& prefix)
+{
+	static std::atomic<int32_t> runs{0};
+	return prefix + "-" + std::to_string(runs++);
+}
+
+/**
+ * \brief Action which takes range(0) microseconds, sleeping meanwhile as if it waited for I/O.
+ */
+std::function<void()> action(benchmark::State const& state)
+{
+	const std::chrono::microseconds duration(state.range(0));
+	return [duration] {
+		if (duration.count() > 0)
+		{
+			std::this_thread::sleep_for(duration);
+		}
+	};
+}
+
+/**
+ * \brief Queues an action and waits for it the way flush() did before: yielding until it is executed.
+ */
+void spinning_flush(benchmark::State& state)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler scheduler(definition.lifetime, scheduler_name("bench-spinning-flush"));
+	std::atomic<bool> executed{false};
+	auto work = action(state);
+	for (auto _ : state)
+	{
+		executed = false;
+		scheduler.queue([&executed, &work] {
+			work();
+			executed = true;
+		});
+		while (!executed)
+		{
+			std::this_thread::yield();
+		}
+	}
+	definition.terminate();
+}
+
+/**
+ * \brief Queues an action and waits for it with flush(), which blocks until the scheduler is idle.
+ */
+void blocking_flush(benchmark::State& state)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler scheduler(definition.lifetime, scheduler_name("bench-blocking-flush"));
+	auto work = action(state);
+	for (auto _ : state)
+	{
+		scheduler.queue(work);
+		scheduler.flush();
+	}
+	definition.terminate();
+}
+
+/**
+ * \brief Waits for a task completed on a scheduler, by polling it like RdCall::sync did before or by RdTask::wait.
+ */
+void task_wait(benchmark::State& state, bool polling)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler scheduler(definition.lifetime, scheduler_name(polling ? "bench-task-polling" : "bench-task-wait"));
+	auto work = action(state);
+	for (auto _ : state)
+	{
+		RdTask<int32_t> task;
+		scheduler.queue([task, &work] {
+			work();
+			task.set(1);
+		});
+		if (polling)
+		{
+			while (!task.has_value())
+			{
+				std::this_thread::yield();
+			}
+		}
+		else
+		{
+			task.wait(definition.lifetime, std::chrono::seconds(10));
+		}
+		benchmark::DoNotOptimize(task.is_succeeded());
+	}
+	definition.terminate();
+}
+}	 // namespace
+
+// a round trip to the scheduler thread for an empty action and a slow one, CPU time is that of the waiting thread
+BENCHMARK(spinning_flush)->Arg(0)->Arg(200);
+BENCHMARK(blocking_flush)->Arg(0)->Arg(200);
+// the same for a task result
+BENCHMARK_CAPTURE(task_wait, polling, true)->Arg(0)->Arg(200);
+BENCHMARK_CAPTURE(task_wait, blocking, false)->Arg(0)->Arg(200);
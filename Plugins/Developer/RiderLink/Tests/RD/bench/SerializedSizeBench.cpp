@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include "protocol/Buffer.h"
+#include "protocol/RdId.h"
+#include "serialization/Polymorphic.h"
+#include "serialization/SerializationCtx.h"
+#include "serialization/SerializedSize.h"
+
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Writes a message the way SocketWire::send0 does: the buffer is allocated for the header and [size] bytes,
+ * so 0 lets it grow while [value] is written.
+ */
+template <typename T>
+size_t write_message(SerializationCtx& ctx, T const& value, size_t size)
+{
+	Buffer buffer(sizeof(int32_t) + sizeof(RdId::hash_t) + sizeof(int16_t) + size);
+	buffer.write_integral<int32_t>(0);
+	RdId(1).write(buffer);
+	buffer.write_integral<int16_t>(0);
+	Polymorphic<T>::write(ctx, buffer, value);
+	return buffer.get_position();
+}
+
+template <typename T>
+void write(benchmark::State& state, T const& value, bool sized)
+{
+	SerializationCtx ctx(nullptr);
+	for (auto _ : state)
+	{
+		const size_t size = sized ? serialized_size(ctx, value) : 0;
+		benchmark::DoNotOptimize(write_message(ctx, value, size));
+	}
+}
+
+void write_string(benchmark::State& state, bool sized)
+{
+	write(state, std::wstring(static_cast<size_t>(state.range(0)), L'a'), sized);
+}
+
+void write_vector(benchmark::State& state, bool sized)
+{
+	write(state, std::vector<int64_t>(static_cast<size_t>(state.range(0)), 42), sized);
+}
+}	 // namespace
+
+// a message buffer grown while the value is written against one allocated from its serialized size
+BENCHMARK_CAPTURE(write_string, growing, false)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+BENCHMARK_CAPTURE(write_string, sized, true)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+BENCHMARK_CAPTURE(write_vector, growing, false)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+BENCHMARK_CAPTURE(write_vector, sized, true)->Arg(16)->Arg(1024)->Arg(64 * 1024);
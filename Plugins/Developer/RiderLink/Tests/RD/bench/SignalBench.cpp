@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include "lifetime/LifetimeDefinition.h"
+#include "reactive/base/SignalX.h"
+#include "util/core_util.h"
+
+#include <functional>
+#include <map>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Listeners as Signal kept them before: a map by advise order, cleaned up of dead ones after every fire.
+ */
+template <typename T>
+class MapSignal
+{
+	struct Event
+	{
+		std::function<void(T const&)> action;
+		Lifetime lifetime;
+	};
+
+	mutable int32_t advise_id = 0;
+	mutable std::map<int32_t, Event> listeners;
+
+public:
+	void fire(T const& value) const
+	{
+		for (auto const& p : listeners)
+		{
+			if (!p.second.lifetime->is_terminated())
+			{
+				p.second.action(value);
+			}
+		}
+		util::erase_if(listeners, [](Event const& e) { return e.lifetime->is_terminated(); });
+	}
+
+	void advise(Lifetime lifetime, std::function<void(T const&)> handler) const
+	{
+		if (lifetime->is_terminated())
+		{
+			return;
+		}
+		listeners.emplace(advise_id++, Event{std::move(handler), lifetime});
+	}
+};
+
+/**
+ * \brief Fires a signal with range(0) listeners, each of them adds the value up.
+ */
+template <typename S>
+void fire(benchmark::State& state)
+{
+	S signal;
+	int64_t sum = 0;
+	for (int64_t i = 0; i < state.range(0); ++i)
+	{
+		signal.advise(Lifetime::Eternal(), [&sum](int32_t const& value) { sum += value; });
+	}
+	for (auto _ : state)
+	{
+		signal.fire(1);
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * \brief Advises a listener for one fire and terminates it, as a temporary subscription does, besides range(0)
+ * long living listeners.
+ */
+template <typename S>
+void advise_fire_terminate(benchmark::State& state)
+{
+	S signal;
+	int64_t sum = 0;
+	for (int64_t i = 0; i < state.range(0); ++i)
+	{
+		signal.advise(Lifetime::Eternal(), [&sum](int32_t const& value) { sum += value; });
+	}
+	for (auto _ : state)
+	{
+		LifetimeDefinition definition(Lifetime::Eternal());
+		signal.advise(definition.lifetime, [&sum](int32_t const& value) { sum -= value; });
+		signal.fire(1);
+		definition.terminate();
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetItemsProcessed(state.iterations());
+}
+}	 // namespace
+
+// a fire reaching 1, 8 and 64 listeners
+BENCHMARK_TEMPLATE(fire, MapSignal<int32_t>)->Arg(1)->Arg(8)->Arg(64);
+BENCHMARK_TEMPLATE(fire, Signal<int32_t>)->Arg(1)->Arg(8)->Arg(64);
+// a short subscription among them
+BENCHMARK_TEMPLATE(advise_fire_terminate, MapSignal<int32_t>)->Arg(1)->Arg(8)->Arg(64);
+BENCHMARK_TEMPLATE(advise_fire_terminate, Signal<int32_t>)->Arg(1)->Arg(8)->Arg(64);
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include "protocol/MessageBroker.h"
+#include "std/unordered_map.h"
+
+#include <memory>
+#include <mutex>
+
+using namespace rd;
+
+namespace
+{
+constexpr int64_t ENTITIES = 256;
+
+/**
+ * \brief Subscriptions as MessageBroker kept them before: a map under the recursive lock of the broker.
+ */
+class LockedSubscriptions
+{
+	mutable std::recursive_mutex lock;
+	rd::unordered_map<RdId, IRdReactive const*> subscriptions;
+
+public:
+	IRdReactive const* find(RdId const& id) const
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		auto it = subscriptions.find(id);
+		return it == subscriptions.end() ? nullptr : it->second;
+	}
+
+	void insert(RdId const& id, IRdReactive const* entity)
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		subscriptions[id] = entity;
+	}
+
+	void erase(RdId const& id)
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		subscriptions.erase(id);
+	}
+};
+
+IRdReactive const* entity(int64_t i)
+{
+	return reinterpret_cast<IRdReactive const*>(static_cast<uintptr_t>(i + 1) * 8);
+}
+
+/**
+ * \brief Every thread looks up subscriptions of received messages, if [advising] the first one also subscribes and
+ * unsubscribes an entity now and then, as binding does.
+ */
+template <typename Table, bool advising>
+void lookup(benchmark::State& state)
+{
+	static std::unique_ptr<Table> table;
+	if (state.thread_index() == 0)
+	{
+		table = std::make_unique<Table>();
+		for (int64_t i = 0; i < ENTITIES; ++i)
+		{
+			table->insert(RdId(i + 1), entity(i));
+		}
+	}
+	int64_t i = state.thread_index();
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(table->find(RdId(i++ % ENTITIES + 1)));
+		if (advising && state.thread_index() == 0 && i % 64 == 0)
+		{
+			const RdId id = RdId(ENTITIES + 1 + i);
+			table->insert(id, entity(i));
+			table->erase(id);
+		}
+	}
+	if (state.thread_index() == 0)
+	{
+		table.reset();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+}	 // namespace
+
+// lookups of MessageBroker::dispatch from 1 to 4 receiving threads
+BENCHMARK_TEMPLATE(lookup, LockedSubscriptions, false)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK_TEMPLATE(lookup, SubscriptionTable, false)->ThreadRange(1, 4)->UseRealTime();
+// the same while entities are advised
+BENCHMARK_TEMPLATE(lookup, LockedSubscriptions, true)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK_TEMPLATE(lookup, SubscriptionTable, true)->ThreadRange(1, 4)->UseRealTime();
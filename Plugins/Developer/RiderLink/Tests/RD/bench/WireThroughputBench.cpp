@@ -0,0 +1,160 @@
+#include <benchmark/benchmark.h>
+
+#include "impl/RdSignal.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SingleThreadScheduler.h"
+#include "wire/SharedMemoryWire.h"
+#include "wire/SocketWire.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+using namespace rd;
+
+namespace
+{
+constexpr int64_t BATCH = 256;
+
+using wires_t = std::pair<std::shared_ptr<WireBase>, std::shared_ptr<WireBase>>;
+
+using connect_t = std::function<wires_t(Lifetime lifetime, IScheduler* server_scheduler, IScheduler* client_scheduler,
+	std::string const& name)>;
+
+/**
+ * \brief Benchmarks run several times and every scheduler and wire registers a logger of its name, so the names must
+ * differ.
+ */
+std::string unique_name(std::string const& prefix)
+{
+	static std::atomic<int32_t> runs{0};
+	return prefix + "-" + std::to_string(runs++);
+}
+
+/**
+ * \brief Server and client wires made by a [connect_t], with a signal from the server to the client which counts
+ * received messages.
+ */
+class Connection
+{
+public:
+	LifetimeDefinition definition{Lifetime::Eternal()};
+	Lifetime lifetime = definition.lifetime;
+	SingleThreadScheduler server_scheduler;
+	SingleThreadScheduler client_scheduler;
+	wires_t wires;
+	std::unique_ptr<Protocol> server_protocol;
+	std::unique_ptr<Protocol> client_protocol;
+	RdSignal<std::wstring> server_signal;
+	RdSignal<std::wstring> client_signal;
+	std::atomic<int64_t> received{0};
+
+	Connection(connect_t const& connect, std::string const& name)
+		: server_scheduler(lifetime, name + "-server"), client_scheduler(lifetime, name + "-client")
+	{
+		wires = connect(lifetime, &server_scheduler, &client_scheduler, name);
+		server_protocol = std::make_unique<Protocol>(Identities::SERVER, &server_scheduler, wires.first, lifetime);
+		client_protocol = std::make_unique<Protocol>(Identities::CLIENT, &client_scheduler, wires.second, lifetime);
+		statics(server_signal, 1);
+		statics(client_signal, 1);
+		server_signal.async = true;
+		server_scheduler.queue([this] { server_signal.bind(lifetime, server_protocol.get(), "signal"); });
+		server_scheduler.flush();
+		client_scheduler.queue([this] {
+			client_signal.bind(lifetime, client_protocol.get(), "signal");
+			client_signal.advise(lifetime, [this](std::wstring const&) { ++received; });
+		});
+		client_scheduler.flush();
+	}
+
+	~Connection()
+	{
+		definition.terminate();
+	}
+
+	bool wait_connected() const
+	{
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (!wires.first->connected.get() || !wires.second->connected.get())
+		{
+			if (std::chrono::steady_clock::now() > deadline)
+			{
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		return true;
+	}
+};
+
+/**
+ * \brief Sends batches of messages of range(0) bytes and waits for each of them to be handled on the other side.
+ */
+void throughput(benchmark::State& state, connect_t const& connect)
+{
+	spdlog::set_level(spdlog::level::off);
+	Connection connection(connect, unique_name("bench-wire"));
+	if (!connection.wait_connected())
+	{
+		state.SkipWithError("wires didn't connect");
+		return;
+	}
+	const std::wstring message(static_cast<size_t>(state.range(0)) / sizeof(wchar_t), L'a');
+	int64_t sent = 0;
+	for (auto _ : state)
+	{
+		for (int64_t i = 0; i < BATCH; ++i)
+		{
+			connection.server_signal.fire(message);
+		}
+		sent += BATCH;
+		while (connection.received < sent)
+		{
+			std::this_thread::yield();
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * BATCH);
+	state.SetBytesProcessed(state.iterations() * BATCH * state.range(0));
+}
+
+wires_t tcp(Lifetime lifetime, IScheduler* server_scheduler, IScheduler* client_scheduler, std::string const& name)
+{
+	auto server = std::make_shared<SocketWire::Server>(lifetime, server_scheduler, 0, name + "-S");
+	auto client = std::make_shared<SocketWire::Client>(lifetime, client_scheduler, server->port, name + "-C");
+	return {server, client};
+}
+
+#ifndef _WIN32
+wires_t unix_socket(Lifetime lifetime, IScheduler* server_scheduler, IScheduler* client_scheduler, std::string const& name)
+{
+	const std::string path = "/tmp/" + name + ".sock";
+	auto server = std::make_shared<SocketWire::Server>(lifetime, server_scheduler, path, name + "-S");
+	auto client = std::make_shared<SocketWire::Client>(lifetime, client_scheduler, path, name + "-C");
+	return {server, client};
+}
+#endif
+
+#ifdef RD_SHARED_MEMORY_WIRE_SUPPORTED
+wires_t shared_memory(Lifetime lifetime, IScheduler* server_scheduler, IScheduler* client_scheduler, std::string const& name)
+{
+	auto server = std::make_shared<SharedMemoryWire::Server>(
+		lifetime, server_scheduler, SharedMemoryWire::DEFAULT_CAPACITY, name + "-S");
+	auto client = std::make_shared<SharedMemoryWire::Client>(lifetime, client_scheduler, server->handle, name + "-C");
+	return {server, client};
+}
+#endif
+}	 // namespace
+
+// messages of 64 bytes and of 4 KB through each wire, handled on the scheduler of the receiving protocol
+BENCHMARK_CAPTURE(throughput, tcp, connect_t(tcp))->Arg(64)->Arg(4096)->UseRealTime();
+#ifndef _WIN32
+BENCHMARK_CAPTURE(throughput, unix_socket, connect_t(unix_socket))->Arg(64)->Arg(4096)->UseRealTime();
+#endif
+#ifdef RD_SHARED_MEMORY_WIRE_SUPPORTED
+BENCHMARK_CAPTURE(throughput, shared_memory, connect_t(shared_memory))->Arg(64)->Arg(4096)->UseRealTime();
+#endif
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include "protocol/Buffer.h"
+
+#include <limits>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+Buffer compact_buffer()
+{
+	Buffer buffer;
+	buffer.set_encoding(Buffer::Encoding::COMPACT);
+	return buffer;
+}
+}	 // namespace
+
+TEST(BufferEncoding, lengths_are_leb128)
+{
+	const std::vector<std::pair<int32_t, size_t>> cases{
+		{0, 1}, {127, 1}, {128, 2}, {16383, 2}, {16384, 3}, {(std::numeric_limits<int32_t>::max)(), 5}};
+	for (auto const& c : cases)
+	{
+		Buffer buffer = compact_buffer();
+		buffer.write_length(c.first);
+		EXPECT_EQ(buffer.get_position(), c.second) << c.first;
+		buffer.rewind();
+		EXPECT_EQ(buffer.read_length(), c.first);
+	}
+
+	Buffer buffer = compact_buffer();
+	buffer.write_length(300);
+	buffer.rewind();
+	EXPECT_EQ(buffer.read_integral<uint8_t>(), 0xac);
+	EXPECT_EQ(buffer.read_integral<uint8_t>(), 0x02);
+}
+
+TEST(BufferEncoding, varints_are_zigzag_encoded)
+{
+	const std::vector<std::pair<int32_t, size_t>> cases{{0, 1}, {-1, 1}, {1, 1}, {-64, 1}, {63, 1}, {64, 2}, {-65, 2},
+		{(std::numeric_limits<int32_t>::max)(), 5}, {(std::numeric_limits<int32_t>::min)(), 5}};
+	for (auto const& c : cases)
+	{
+		Buffer buffer = compact_buffer();
+		buffer.write_varint32(c.first);
+		EXPECT_EQ(buffer.get_position(), c.second) << c.first;
+		buffer.rewind();
+		EXPECT_EQ(buffer.read_varint32(), c.first);
+	}
+
+	Buffer buffer = compact_buffer();
+	buffer.write_varint32(-1);
+	buffer.write_varint32(1);
+	buffer.rewind();
+	EXPECT_EQ(buffer.read_integral<uint8_t>(), 1);
+	EXPECT_EQ(buffer.read_integral<uint8_t>(), 2);
+}
+
+TEST(BufferEncoding, fixed_encoding_writes_int32)
+{
+	Buffer buffer;
+	buffer.write_length(5);
+	buffer.write_varint32(-5);
+	EXPECT_EQ(buffer.get_position(), 2 * sizeof(int32_t));
+	buffer.rewind();
+	EXPECT_EQ(buffer.read_integral<int32_t>(), 5);
+	EXPECT_EQ(buffer.read_integral<int32_t>(), -5);
+}
+
+TEST(BufferEncoding, malformed_varint_throws)
+{
+	Buffer buffer;
+	for (int i = 0; i < 5; ++i)
+	{
+		buffer.write_integral<uint8_t>(0xff);
+	}
+	buffer.write_integral<uint8_t>(0);
+	buffer.set_encoding(Buffer::Encoding::COMPACT);
+	buffer.rewind();
+	EXPECT_THROW(buffer.read_length(), std::out_of_range);
+}
+
+TEST(BufferEncoding, write_length_at_shifts_data_which_doesnt_fit_the_reserved_byte)
+{
+	for (int32_t size : {0, 1, 127, 128, 300, 20000})
+	{
+		Buffer buffer = compact_buffer();
+		buffer.write_integral<int32_t>(-1);
+		const size_t position = buffer.reserve_length();
+		for (int32_t i = 0; i < size; ++i)
+		{
+			buffer.write_integral(static_cast<uint8_t>(i));
+		}
+		buffer.write_length_at(position);
+		buffer.write_integral<int32_t>(-2);
+
+		buffer.rewind();
+		EXPECT_EQ(buffer.read_integral<int32_t>(), -1);
+		ASSERT_EQ(buffer.read_length(), size);
+		for (int32_t i = 0; i < size; ++i)
+		{
+			ASSERT_EQ(buffer.read_integral<uint8_t>(), static_cast<uint8_t>(i)) << size << " " << i;
+		}
+		// data written after the length goes after the shifted data
+		EXPECT_EQ(buffer.read_integral<int32_t>(), -2);
+	}
+}
+
+TEST(BufferEncoding, write_length_at_in_fixed_encoding)
+{
+	Buffer buffer;
+	const size_t position = buffer.reserve_length();
+	buffer.write_integral<int64_t>(7);
+	buffer.write_length_at(position);
+	buffer.rewind();
+	EXPECT_EQ(buffer.read_length(), static_cast<int32_t>(sizeof(int64_t)));
+	EXPECT_EQ(buffer.read_integral<int64_t>(), 7);
+}
@@ -0,0 +1,346 @@
+#include <gtest/gtest.h>
+
+#include "wire/ByteBufferAsyncProcessor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+using Processor = ByteBufferAsyncProcessor;
+
+Buffer::ByteArray package(uint8_t tag, size_t size = 1)
+{
+	return Buffer::ByteArray(size, tag);
+}
+
+/**
+ * \brief Records the tag and the number of packages put to a paused processor, then lets them go at once.
+ */
+class LaneRecorder
+{
+	std::mutex lock;
+	std::vector<std::pair<uint8_t, uint8_t>> processed;
+
+public:
+	Processor processor{"lanes", [this](Processor::batch_t const& batch, sequence_number_t) {
+							std::lock_guard<std::mutex> guard(lock);
+							for (auto const* data : batch)
+							{
+								processed.emplace_back((*data)[0], (*data)[1]);
+							}
+							return true;
+						}};
+
+	LaneRecorder()
+	{
+		processor.pause("test");
+		processor.start();
+	}
+
+	~LaneRecorder()
+	{
+		processor.terminate();
+	}
+
+	void put(uint8_t tag, uint8_t number, int64_t key, int64_t lane_key = 0)
+	{
+		Buffer::ByteArray data = package(tag, 1024);
+		data[1] = number;
+		processor.put(std::move(data), key, lane_key);
+	}
+
+	void put_fragments(uint8_t tag, uint8_t count, int64_t key)
+	{
+		std::vector<Buffer::ByteArray> fragments;
+		for (uint8_t i = 0; i < count; ++i)
+		{
+			fragments.push_back(package(tag, 1024));
+			fragments.back()[1] = i;
+		}
+		processor.put_fragments(std::move(fragments), key);
+	}
+
+	std::vector<std::pair<uint8_t, uint8_t>> resume_and_wait(size_t count)
+	{
+		processor.resume();
+		for (int i = 0; i < 1000; ++i)
+		{
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				if (processed.size() >= count)
+				{
+					return processed;
+				}
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		std::lock_guard<std::mutex> guard(lock);
+		return processed;
+	}
+};
+
+size_t position(std::vector<std::pair<uint8_t, uint8_t>> const& processed, uint8_t tag, uint8_t number)
+{
+	return static_cast<size_t>(
+		std::find(processed.begin(), processed.end(), std::make_pair(tag, number)) - processed.begin());
+}
+}	 // namespace
+
+TEST(ByteBufferAsyncProcessor, limits_arent_overshot_by_concurrent_producers)
+{
+	Processor processor("limits", [](Processor::batch_t const&, sequence_number_t) { return true; });
+	Processor::Limits limits;
+	limits.max_messages = 100;
+	limits.max_bytes = 100 * 16;
+	limits.policy = Processor::OverflowPolicy::Fail;
+	processor.set_limits(limits);
+	processor.start();
+	// nothing leaves the window while it's paused
+	processor.pause("test");
+
+	std::atomic<int32_t> accepted{0};
+	std::vector<std::thread> producers;
+	for (int i = 0; i < 4; ++i)
+	{
+		producers.emplace_back([&processor, &accepted, i]() {
+			for (int j = 0; j < 500; ++j)
+			{
+				if (processor.put(package(static_cast<uint8_t>(i), 16)))
+				{
+					++accepted;
+				}
+			}
+		});
+	}
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+
+	auto stats = processor.get_stats();
+	EXPECT_EQ(accepted, 100);
+	EXPECT_EQ(stats.queued_messages, 100u);
+	EXPECT_EQ(stats.queued_bytes, 100u * 16);
+	EXPECT_EQ(stats.rejected_messages, 1900u);
+	processor.terminate();
+}
+
+TEST(ByteBufferAsyncProcessor, drop_oldest_doesnt_wait_for_processing)
+{
+	std::promise<void> entered;
+	std::promise<void> release;
+	std::shared_future<void> released = release.get_future().share();
+	std::atomic<bool> first{true};
+	Processor processor("drop", [&](Processor::batch_t const&, sequence_number_t) {
+		if (first.exchange(false))
+		{
+			entered.set_value();
+			released.wait();
+		}
+		return true;
+	});
+	Processor::Limits limits;
+	limits.max_messages = 1;
+	limits.policy = Processor::OverflowPolicy::DropOldest;
+	processor.set_limits(limits);
+	processor.set_droppable_key([](Buffer::ByteArray const& data) -> int64_t { return data[0]; });
+	processor.start();
+
+	EXPECT_TRUE(processor.put(package(1)));
+	entered.get_future().wait();
+
+	// the package being processed is never dropped, so the next one is rejected without waiting for the processor
+	auto put = std::async(std::launch::async, [&processor]() { return processor.put(package(1)); });
+	ASSERT_EQ(put.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+	EXPECT_FALSE(put.get());
+	EXPECT_EQ(processor.get_stats().dropped_messages, 0u);
+
+	release.set_value();
+	processor.terminate();
+}
+
+TEST(ByteBufferAsyncProcessor, pause_async_doesnt_wait_for_processing)
+{
+	std::promise<void> entered;
+	std::promise<void> release;
+	std::shared_future<void> released = release.get_future().share();
+	std::atomic<bool> first{true};
+	std::atomic<int32_t> processed{0};
+	Processor processor("pause", [&](Processor::batch_t const& batch, sequence_number_t) {
+		if (first.exchange(false))
+		{
+			entered.set_value();
+			released.wait();
+		}
+		processed += static_cast<int32_t>(batch.size());
+		return true;
+	});
+	processor.start();
+
+	processor.put(package(1));
+	entered.get_future().wait();
+	processor.put(package(2));
+
+	auto paused = std::async(std::launch::async, [&processor]() { processor.pause_async("test"); });
+	ASSERT_EQ(paused.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+
+	// the package being processed completes, the next one waits for resume
+	release.set_value();
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_EQ(processed, 1);
+
+	// the unacknowledged package is resent before the next one
+	processor.resume_async();
+	for (int i = 0; i < 1000 && processed < 3; ++i)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	EXPECT_EQ(processed, 3);
+	processor.terminate();
+}
+
+TEST(ByteBufferAsyncProcessor, resume_async_reprocesses_on_async_thread)
+{
+	std::mutex lock;
+	std::vector<std::pair<sequence_number_t, std::thread::id>> calls;
+	Processor processor("resume", [&](Processor::batch_t const& batch, sequence_number_t first_seqn) {
+		std::lock_guard<std::mutex> guard(lock);
+		for (size_t i = 0; i < batch.size(); ++i)
+		{
+			calls.emplace_back(first_seqn + static_cast<sequence_number_t>(i), std::this_thread::get_id());
+		}
+		return true;
+	});
+	auto processed = [&]() {
+		std::lock_guard<std::mutex> guard(lock);
+		return calls.size();
+	};
+	auto wait_processed = [&](size_t count) {
+		for (int i = 0; i < 1000 && processed() < count; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return processed();
+	};
+	processor.start();
+
+	for (uint8_t i = 1; i <= 3; ++i)
+	{
+		processor.put(package(i));
+	}
+	ASSERT_EQ(wait_processed(3), 3u);
+	processor.acknowledge(1);
+
+	processor.pause_async("test");
+	processor.put(package(4));
+	processor.resume_async();
+	// unacknowledged packages are resent before the one put while paused
+	ASSERT_EQ(wait_processed(6), 6u);
+
+	std::lock_guard<std::mutex> guard(lock);
+	const std::vector<sequence_number_t> expected{1, 2, 3, 2, 3, 4};
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		EXPECT_EQ(calls[i].first, expected[i]);
+		EXPECT_EQ(calls[i].second, calls[0].second);
+	}
+	EXPECT_NE(calls[3].second, std::this_thread::get_id());
+	processor.terminate();
+}
+
+TEST(ByteBufferAsyncProcessor, lanes_let_higher_priorities_overtake_and_keep_order_of_keys)
+{
+	LaneRecorder recorder;
+	recorder.processor.set_priority(1, Processor::Priority::Low);
+	recorder.processor.set_priority(2, Processor::Priority::High);
+	for (uint8_t i = 0; i < 20; ++i)
+	{
+		recorder.put(1, i, 1);
+	}
+	for (uint8_t i = 0; i < 5; ++i)
+	{
+		recorder.put(2, i, 2);
+	}
+	// a response of key 3 in the lane of key 2
+	recorder.put(3, 0, 3, 2);
+
+	auto processed = recorder.resume_and_wait(26);
+	ASSERT_EQ(processed.size(), 26u);
+	// the low lane gets a package a round per unit of its weight, while the high lane is drained at once
+	EXPECT_LT(position(processed, 2, 4), position(processed, 1, 4));
+	EXPECT_LT(position(processed, 3, 0), position(processed, 1, 4));
+	for (uint8_t i = 1; i < 20; ++i)
+	{
+		EXPECT_LT(position(processed, 1, i - 1), position(processed, 1, i));
+	}
+	for (uint8_t i = 1; i < 5; ++i)
+	{
+		EXPECT_LT(position(processed, 2, i - 1), position(processed, 2, i));
+	}
+}
+
+TEST(ByteBufferAsyncProcessor, ordered_keys_are_kept_in_order_with_every_lane)
+{
+	LaneRecorder recorder;
+	recorder.processor.set_priority(1, Processor::Priority::Low);
+	recorder.processor.set_priority(2, Processor::Priority::High);
+	recorder.processor.set_ordered(3);
+	for (uint8_t i = 0; i < 10; ++i)
+	{
+		recorder.put(1, i, 1);
+	}
+	recorder.put(3, 0, 3);
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		recorder.put(2, i, 2);
+	}
+
+	auto processed = recorder.resume_and_wait(14);
+	ASSERT_EQ(processed.size(), 14u);
+	// the ordered package waits for the low lane, and the high lane waits for it
+	for (uint8_t i = 0; i < 10; ++i)
+	{
+		EXPECT_EQ(processed[i], std::make_pair(uint8_t{1}, i));
+	}
+	EXPECT_EQ(processed[10], std::make_pair(uint8_t{3}, uint8_t{0}));
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		EXPECT_EQ(processed[11 + i], std::make_pair(uint8_t{2}, i));
+	}
+}
+
+TEST(ByteBufferAsyncProcessor, packages_put_after_fragments_dont_overtake_the_first_one)
+{
+	LaneRecorder recorder;
+	recorder.processor.set_priority(1, Processor::Priority::Low);
+	recorder.processor.set_priority(4, Processor::Priority::Low);
+	recorder.processor.set_priority(2, Processor::Priority::High);
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		recorder.put(4, i, 4);
+	}
+	recorder.put_fragments(1, 16, 1);
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		recorder.put(2, i, 2);
+	}
+
+	auto processed = recorder.resume_and_wait(22);
+	ASSERT_EQ(processed.size(), 22u);
+	// the high lane waits for the first fragment, which waits for the packages put before it, but not for the rest
+	EXPECT_LT(position(processed, 4, 2), position(processed, 1, 0));
+	EXPECT_LT(position(processed, 1, 0), position(processed, 2, 0));
+	EXPECT_LT(position(processed, 2, 2), position(processed, 1, 15));
+	for (uint8_t i = 1; i < 16; ++i)
+	{
+		EXPECT_LT(position(processed, 1, i - 1), position(processed, 1, i));
+	}
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "reactive/base/ConcurrentSignal.h"
+#include "reactive/base/SignalX.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+TEST(ConcurrentSignal, calls_priority_listeners_first_while_alive)
+{
+	ConcurrentSignal<int32_t> signal;
+	std::vector<int32_t> calls;
+	LifetimeDefinition definition(Lifetime::Eternal());
+	signal.advise(definition.lifetime, [&calls](int32_t const& value) { calls.push_back(value); });
+	priorityAdviseSection([&]() { signal.advise(Lifetime::Eternal(), [&calls](int32_t const& value) { calls.push_back(-value); }); });
+
+	signal.fire(1);
+	EXPECT_EQ(calls, (std::vector<int32_t>{-1, 1}));
+
+	definition.terminate();
+	signal.fire(2);
+	EXPECT_EQ(calls, (std::vector<int32_t>{-1, 1, -2}));
+}
+
+TEST(ConcurrentSignal, listener_advised_while_firing_is_called_from_next_fire)
+{
+	ConcurrentSignal<int32_t> signal;
+	std::vector<int32_t> calls;
+	signal.advise(Lifetime::Eternal(), [&](int32_t const& value) {
+		if (value == 1)
+		{
+			signal.advise(Lifetime::Eternal(), [&calls](int32_t const& v) { calls.push_back(v); });
+		}
+	});
+	signal.fire(1);
+	EXPECT_TRUE(calls.empty());
+	signal.fire(2);
+	EXPECT_EQ(calls, (std::vector<int32_t>{2}));
+}
+
+TEST(ConcurrentSignal, fires_while_listeners_come_and_go_on_other_threads)
+{
+	constexpr int32_t FIRES = 20000;
+	ConcurrentSignal<int32_t> signal;
+	std::atomic<int64_t> sum{0};
+	signal.advise(Lifetime::Eternal(), [&sum](int32_t const& value) { sum += value; });
+
+	std::atomic<bool> done{false};
+	std::atomic<int32_t> rounds{0};
+	std::atomic<int64_t> transient_calls{0};
+	std::thread advising([&]() {
+		while (!done)
+		{
+			LifetimeDefinition definition(Lifetime::Eternal());
+			signal.advise(definition.lifetime, [&transient_calls](int32_t const&) { ++transient_calls; });
+			std::this_thread::yield();
+			definition.terminate();
+			++rounds;
+		}
+	});
+
+	std::atomic<int64_t> fired{0};
+	std::vector<std::thread> firing;
+	for (int i = 0; i < 2; ++i)
+	{
+		firing.emplace_back([&]() {
+			// listeners are advised and terminated meanwhile for a while at least
+			for (int32_t j = 0; j < FIRES || rounds < 1000; ++j)
+			{
+				signal.fire(1);
+				++fired;
+			}
+		});
+	}
+	for (auto& thread : firing)
+	{
+		thread.join();
+	}
+	done = true;
+	advising.join();
+
+	// the listener advised before every fire gets all of them, the transient ones don't outlive their lifetimes
+	EXPECT_EQ(sum, fired);
+	const int64_t calls = transient_calls;
+	signal.fire(1);
+	EXPECT_EQ(transient_calls, calls);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include "base/IWire.h"
+#include "intern/InternTable.h"
+
+#include <memory>
+#include <string>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Sends nothing, a send stays in progress between [begin_send] and [end_send].
+ */
+class TestWire : public IWire
+{
+	std::unique_ptr<SendScope> scope;
+
+public:
+	void send(RdId const& /*id*/, std::function<void(Buffer& buffer)> /*writer*/) const override
+	{
+	}
+
+	void advise(Lifetime /*lifetime*/, IRdReactive const* /*entity*/) const override
+	{
+	}
+
+	void begin_send()
+	{
+		scope = std::make_unique<SendScope>(*this);
+	}
+
+	void end_send()
+	{
+		scope.reset();
+	}
+};
+
+InternedAny value(std::wstring const& s)
+{
+	return any::make_interned_any<std::wstring>(Wrapper<std::wstring>(s));
+}
+
+int32_t intern(InternTable& table, std::wstring const& s)
+{
+	const InternedAny v = value(s);
+	bool inserted = false;
+	InternTable::Entry* entry = table.find_or_insert(v, InternTable::hash(v), inserted);
+	if (table.claim(entry, inserted))
+	{
+		table.publish(entry);
+	}
+	return entry->id;
+}
+
+bool is_known(InternTable const& table, int32_t id)
+{
+	try
+	{
+		table.get(id);
+		return true;
+	}
+	catch (std::exception const&)
+	{
+		return false;
+	}
+}
+}	 // namespace
+
+TEST(InternTable, interns_a_value_once)
+{
+	InternTable table;
+	const int32_t a = intern(table, L"a");
+	EXPECT_EQ(intern(table, L"a"), a);
+	EXPECT_NE(intern(table, L"b"), a);
+	EXPECT_EQ(a % 2, 0);
+	EXPECT_EQ(any::get<std::wstring>(table.get(a)), std::wstring(L"a"));
+	EXPECT_EQ(table.get_stats().own_values, 2u);
+}
+
+TEST(InternTable, evicts_own_generations_once_the_peer_acknowledges)
+{
+	TestWire wire;
+	InternTable table;
+	table.set_capacity(2);
+
+	const int32_t a = intern(table, L"a");
+	intern(table, L"b");
+	table.rotate_if_full(wire);
+	intern(table, L"c");
+	intern(table, L"d");
+	// a message being written may have got ids of the generation which is retired now
+	wire.begin_send();
+	table.rotate_if_full(wire);
+	EXPECT_EQ(table.get_stats().evictions, 2u);
+
+	// the retired generation isn't handed out anymore, but its ids are still readable
+	EXPECT_NE(intern(table, L"a"), a);
+	EXPECT_TRUE(is_known(table, a));
+
+	int32_t retired = 0;
+	int32_t acknowledged = 0;
+	EXPECT_FALSE(table.take_sent(wire, retired, acknowledged));
+	wire.end_send();
+	ASSERT_TRUE(table.take_sent(wire, retired, acknowledged));
+	EXPECT_EQ(retired, 4);
+	EXPECT_EQ(acknowledged, 0);
+	EXPECT_FALSE(table.take_sent(wire, retired, acknowledged));
+
+	// the peer acknowledges the retirement
+	table.free_own(retired);
+	EXPECT_FALSE(is_known(table, a));
+	EXPECT_EQ(table.get_stats().own_values, 3u);
+}
+
+TEST(InternTable, retires_ids_of_the_other_side)
+{
+	TestWire wire;
+	InternTable table;
+	table.set_other(1, value(L"x"));
+	table.set_other(3, value(L"y"));
+	EXPECT_EQ(table.get_stats().other_values, 2u);
+
+	table.retire_other(3, wire);
+	EXPECT_FALSE(is_known(table, 1));
+	EXPECT_TRUE(is_known(table, 3));
+	EXPECT_EQ(table.get_stats().other_values, 1u);
+
+	int32_t retired = 0;
+	int32_t acknowledged = 0;
+	ASSERT_TRUE(table.take_sent(wire, retired, acknowledged));
+	EXPECT_EQ(retired, 0);
+	EXPECT_EQ(acknowledged, 3);
+}
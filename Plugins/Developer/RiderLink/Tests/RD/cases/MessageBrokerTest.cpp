@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include "base/WireBase.h"
+#include "impl/RdSignal.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SingleThreadScheduler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Wire which only receives: messages given to [receive] go to its broker as if they came from the peer.
+ */
+class ReceivingWire : public WireBase
+{
+public:
+	explicit ReceivingWire(IScheduler* scheduler) : WireBase(scheduler)
+	{
+	}
+
+	void send(RdId const& /*id*/, std::function<void(Buffer& buffer)> /*writer*/) const override
+	{
+	}
+
+	void receive(RdId const& id, int32_t value) const
+	{
+		Buffer buffer;
+		buffer.write_integral<int16_t>(0);	  // no context
+		buffer.write_integral(value);
+		buffer.set_position(0);
+		message_broker.dispatch(id, std::move(buffer));
+	}
+};
+
+/**
+ * \brief Blocks the thread which calls [wait] until [open] is called.
+ */
+class Gate
+{
+	std::mutex lock;
+	std::condition_variable cv;
+	bool opened = false;
+
+public:
+	void open()
+	{
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			opened = true;
+		}
+		cv.notify_all();
+	}
+
+	void wait()
+	{
+		std::unique_lock<decltype(lock)> guard(lock);
+		cv.wait(guard, [this] { return opened; });
+	}
+};
+
+/**
+ * \brief Delivers [first] messages to an unbound signal, binds it while their drain is queued behind the binding task,
+ * then delivers [second] more before the drain runs. Values are the indices of the messages.
+ */
+std::vector<int32_t> receive_around_late_subscription(IScheduler* handler_scheduler, std::string const& name, int32_t first,
+	int32_t second)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler scheduler(definition.lifetime, name);
+	auto wire = std::make_shared<ReceivingWire>(&scheduler);
+	Protocol protocol(Identities::CLIENT, &scheduler, wire, definition.lifetime);
+
+	RdSignal<int32_t> signal;
+	statics(signal, 1);
+	std::vector<int32_t> received;
+	std::atomic<int32_t> count{0};
+	Gate messages_queued;
+	Gate subscribed;
+	Gate messages_received;
+	scheduler.queue([&] {
+		messages_queued.wait();
+		signal.bind(definition.lifetime, &protocol, "signal");
+		auto handler = [&](int32_t const& value) {
+			received.push_back(value);
+			++count;
+		};
+		if (handler_scheduler != nullptr)
+		{
+			signal.advise_on(definition.lifetime, handler_scheduler, handler);
+		}
+		else
+		{
+			signal.advise(definition.lifetime, handler);
+		}
+		subscribed.open();
+		messages_received.wait();
+	});
+
+	const RdId id(1);
+	for (int32_t i = 0; i < first; ++i)
+	{
+		wire->receive(id, i);
+	}
+	messages_queued.open();
+	subscribed.wait();
+	for (int32_t i = first; i < first + second; ++i)
+	{
+		wire->receive(id, i);
+	}
+	messages_received.open();
+
+	scheduler.flush();
+	if (handler_scheduler != nullptr)
+	{
+		handler_scheduler->flush();
+	}
+	EXPECT_EQ(signal.get_id(), id);
+	EXPECT_EQ(count, first + second);
+	definition.terminate();
+	return received;
+}
+
+std::vector<int32_t> indices(int32_t count)
+{
+	std::vector<int32_t> result(count);
+	for (int32_t i = 0; i < count; ++i)
+	{
+		result[i] = i;
+	}
+	return result;
+}
+}	 // namespace
+
+TEST(MessageBroker, drain_delivers_messages_received_before_late_subscription_first)
+{
+	EXPECT_EQ(receive_around_late_subscription(nullptr, "broker-late-default", 50, 50), indices(100));
+}
+
+TEST(MessageBroker, drain_delivers_messages_in_order_on_custom_scheduler)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler handler_scheduler(definition.lifetime, "broker-late-custom-handlers");
+	EXPECT_EQ(receive_around_late_subscription(&handler_scheduler, "broker-late-custom", 50, 50), indices(100));
+	definition.terminate();
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "util/mpsc_queue.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+TEST(MpscQueue, pops_in_push_order)
+{
+	util::mpsc_queue<int32_t> queue;
+	int32_t value = 0;
+	EXPECT_TRUE(queue.empty());
+	EXPECT_FALSE(queue.try_pop(value));
+
+	for (int32_t i = 0; i < 10; ++i)
+	{
+		queue.push(i);
+	}
+	EXPECT_FALSE(queue.empty());
+	for (int32_t i = 0; i < 10; ++i)
+	{
+		ASSERT_TRUE(queue.try_pop(value));
+		EXPECT_EQ(value, i);
+	}
+	EXPECT_TRUE(queue.empty());
+	EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(MpscQueue, moves_values_and_frees_them_on_destruction)
+{
+	auto value = std::make_shared<int32_t>(1);
+	{
+		util::mpsc_queue<std::shared_ptr<int32_t>> queue;
+		queue.push(value);
+		queue.push(value);
+		std::shared_ptr<int32_t> popped;
+		ASSERT_TRUE(queue.try_pop(popped));
+		EXPECT_EQ(popped, value);
+		EXPECT_EQ(value.use_count(), 3);
+	}
+	EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST(MpscQueue, keeps_order_of_each_producer)
+{
+	constexpr int32_t PRODUCERS = 4;
+	constexpr int32_t COUNT = 20000;
+	util::mpsc_queue<std::pair<int32_t, int32_t>> queue;
+	std::vector<std::thread> producers;
+	for (int32_t p = 0; p < PRODUCERS; ++p)
+	{
+		producers.emplace_back([&queue, p]() {
+			for (int32_t i = 0; i < COUNT; ++i)
+			{
+				queue.push({p, i});
+			}
+		});
+	}
+
+	// consumed while producers push, each producer's values come in the order it pushed them
+	std::vector<int32_t> next(PRODUCERS, 0);
+	int32_t popped = 0;
+	std::pair<int32_t, int32_t> value;
+	while (popped < PRODUCERS * COUNT)
+	{
+		if (!queue.try_pop(value))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		EXPECT_EQ(value.second, next[value.first]);
+		next[value.first] = value.second + 1;
+		++popped;
+	}
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+	EXPECT_TRUE(queue.empty());
+}
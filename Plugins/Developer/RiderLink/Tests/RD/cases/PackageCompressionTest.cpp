@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "wire/PackageCompression.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+std::vector<uint8_t> generate(std::mt19937& rng, size_t size, int kind)
+{
+	std::vector<uint8_t> data(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		switch (kind)
+		{
+			case 0:
+				data[i] = static_cast<uint8_t>(rng());
+				break;
+			case 1:
+				data[i] = static_cast<uint8_t>("abcabcabd"[i % 9]);
+				break;
+			default:
+				data[i] = static_cast<uint8_t>(rng() % 4);
+		}
+	}
+	return data;
+}
+}	 // namespace
+
+TEST(lz4, round_trip)
+{
+	std::mt19937 rng(42);
+	for (int step = 0; step < 600; ++step)
+	{
+		// random, repetitive and low entropy data of sizes around the block limits
+		const size_t size = rng() % (step < 300 ? 64 : 70000);
+		const auto src = generate(rng, size, step % 3);
+		std::vector<uint8_t> compressed(lz4::compress_bound(size));
+		const size_t compressed_size = lz4::compress(src.data(), size, compressed.data());
+		ASSERT_LE(compressed_size, compressed.size());
+
+		std::vector<uint8_t> decompressed(size + 1);
+		ASSERT_TRUE(lz4::decompress(compressed.data(), compressed_size, decompressed.data(), size)) << "size " << size;
+		ASSERT_TRUE(std::equal(src.begin(), src.end(), decompressed.begin())) << "size " << size;
+		if (size > 0)
+		{
+			// the size is exact
+			EXPECT_FALSE(lz4::decompress(compressed.data(), compressed_size, decompressed.data(), size - 1));
+		}
+	}
+}
+
+TEST(lz4, corrupted_blocks_stay_in_bounds)
+{
+	std::mt19937 rng(7);
+	for (int step = 0; step < 300; ++step)
+	{
+		const size_t size = 1 + rng() % 5000;
+		const auto src = generate(rng, size, 1 + step % 2);
+		std::vector<uint8_t> compressed(lz4::compress_bound(size));
+		const size_t compressed_size = lz4::compress(src.data(), size, compressed.data());
+		// the output has guard bytes, corrupted blocks mustn't write past the declared size
+		std::vector<uint8_t> decompressed(size + 64, 0xAA);
+		for (int k = 0; k < 5; ++k)
+		{
+			auto corrupted = compressed;
+			corrupted[rng() % compressed_size] ^= static_cast<uint8_t>(1 + rng() % 255);
+			lz4::decompress(corrupted.data(), compressed_size, decompressed.data(), size);
+			ASSERT_TRUE(std::all_of(decompressed.begin() + size, decompressed.end(), [](uint8_t b) { return b == 0xAA; }));
+		}
+		EXPECT_FALSE(lz4::decompress(compressed.data(), compressed_size / 2, decompressed.data(), size));
+	}
+}
+
+TEST(PackageCompression, threshold_and_round_trip)
+{
+	PackageCompression compression;
+	std::vector<Buffer::word_t> data(4096);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<Buffer::word_t>(i % 13);
+	}
+	Buffer::ByteArray compressed;
+	// off by default
+	EXPECT_FALSE(compression.compress(data.data(), data.size(), compressed));
+
+	PackageCompression::Settings settings;
+	settings.codec = PackageCompression::Codec::LZ4;
+	settings.threshold = 1024;
+	compression.set_settings(settings);
+	EXPECT_FALSE(compression.compress(data.data(), 1000, compressed));
+	ASSERT_TRUE(compression.compress(data.data(), data.size(), compressed));
+	EXPECT_LT(compressed.size(), data.size());
+
+	ASSERT_EQ(PackageCompression::uncompressed_size(compressed.data(), compressed.size()), static_cast<int32_t>(data.size()));
+	std::vector<Buffer::word_t> decompressed(data.size());
+	ASSERT_TRUE(compression.decompress(compressed.data(), compressed.size(), decompressed.data()));
+	EXPECT_EQ(decompressed, data);
+
+	const auto stats = compression.get_stats();
+	EXPECT_EQ(stats.compressed_packages, 1u);
+	EXPECT_EQ(stats.decompressed_packages, 1u);
+	EXPECT_EQ(stats.bytes_before, data.size());
+}
+
+TEST(PackageCompression, malformed_payloads)
+{
+	PackageCompression compression;
+	const Buffer::word_t negative[] = {0xff, 0xff, 0xff, 0xff, 0};
+	EXPECT_EQ(PackageCompression::uncompressed_size(negative, sizeof(negative)), -1);
+	EXPECT_EQ(PackageCompression::uncompressed_size(negative, 3), -1);
+	Buffer::word_t out[16];
+	EXPECT_FALSE(compression.decompress(negative, sizeof(negative), out));
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include "util/rdid_map.h"
+
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace rd;
+
+TEST(rdid_map, insert_find_erase)
+{
+	util::rdid_map<std::string> map;
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(map.find(RdId(1)), nullptr);
+
+	auto inserted = map.try_emplace(RdId(1), "one");
+	EXPECT_TRUE(inserted.second);
+	EXPECT_EQ(*inserted.first, "one");
+	inserted = map.try_emplace(RdId(1), "other");
+	EXPECT_FALSE(inserted.second);
+	EXPECT_EQ(*inserted.first, "one");
+
+	map[RdId(2)] = "two";
+	EXPECT_EQ(map.size(), 2u);
+	ASSERT_NE(map.find(RdId(2)), nullptr);
+	EXPECT_EQ(*map.find(RdId(2)), "two");
+
+	EXPECT_TRUE(map.erase(RdId(1)));
+	EXPECT_FALSE(map.erase(RdId(1)));
+	EXPECT_FALSE(map.contains(RdId(1)));
+	EXPECT_TRUE(map.contains(RdId(2)));
+	EXPECT_EQ(map.size(), 1u);
+
+	map.clear();
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(map.find(RdId(2)), nullptr);
+}
+
+TEST(rdid_map, null_id)
+{
+	util::rdid_map<int> map;
+	EXPECT_EQ(map.find(RdId::Null()), nullptr);
+	map[RdId(1)] = 1;
+	// the null id marks empty slots, a lookup mustn't match one of them
+	EXPECT_EQ(map.find(RdId::Null()), nullptr);
+	EXPECT_FALSE(map.contains(RdId::Null()));
+	EXPECT_FALSE(map.erase(RdId::Null()));
+	EXPECT_THROW(map.try_emplace(RdId::Null(), 0), std::runtime_error);
+	EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(rdid_map, colliding_ids)
+{
+	util::rdid_map<int64_t> map;
+	// ids which differ in low bits only land in neighbouring slots and form long probe chains
+	for (int64_t i = 1; i <= 1000; ++i)
+	{
+		map[RdId(i)] = i;
+	}
+	// erasing every other id shifts the rest back, each of them stays reachable
+	for (int64_t i = 1; i <= 1000; i += 2)
+	{
+		EXPECT_TRUE(map.erase(RdId(i)));
+	}
+	for (int64_t i = 1; i <= 1000; ++i)
+	{
+		auto const* value = map.find(RdId(i));
+		if (i % 2 == 0)
+		{
+			ASSERT_NE(value, nullptr);
+			EXPECT_EQ(*value, i);
+		}
+		else
+		{
+			EXPECT_EQ(value, nullptr);
+		}
+	}
+	EXPECT_EQ(map.size(), 500u);
+}
+
+TEST(rdid_map, matches_unordered_map)
+{
+	std::mt19937_64 rng(1);
+	util::rdid_map<std::string> map;
+	std::unordered_map<int64_t, std::string> reference;
+	for (int step = 0; step < 200000; ++step)
+	{
+		const int64_t key = static_cast<int64_t>(rng() % 5000) * 1000003 + 1;
+		switch (rng() % 3)
+		{
+			case 0:
+			{
+				auto inserted = map.try_emplace(RdId(key), std::to_string(key));
+				ASSERT_EQ(inserted.second, reference.emplace(key, std::to_string(key)).second);
+				ASSERT_EQ(*inserted.first, std::to_string(key));
+				break;
+			}
+			case 1:
+				ASSERT_EQ(map.erase(RdId(key)), reference.erase(key) == 1);
+				break;
+			default:
+			{
+				auto const* value = map.find(RdId(key));
+				auto it = reference.find(key);
+				ASSERT_EQ(value != nullptr, it != reference.end());
+				if (value != nullptr)
+				{
+					ASSERT_EQ(*value, it->second);
+				}
+			}
+		}
+		ASSERT_EQ(map.size(), reference.size());
+	}
+
+	size_t visited = 0;
+	map.for_each([&](RdId id, std::string const& value) {
+		EXPECT_EQ(reference.at(id.get_hash()), value);
+		++visited;
+	});
+	EXPECT_EQ(visited, reference.size());
+
+	util::rdid_map<std::string> moved(std::move(map));
+	EXPECT_EQ(moved.size(), reference.size());
+	EXPECT_TRUE(map.empty());
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include "wire/SharedMemoryWire.h"
+
+#ifdef RD_SHARED_MEMORY_WIRE_SUPPORTED
+
+#include "lifetime/LifetimeDefinition.h"
+#include "scheduler/SingleThreadScheduler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace rd;
+
+namespace
+{
+constexpr size_t CAPACITY = 4096;
+
+void send_kilobyte(SharedMemoryWire::Base& wire, RdId const& rd_id)
+{
+	wire.send(rd_id, [](Buffer& buffer) {
+		for (int64_t i = 0; i < 128; ++i)
+		{
+			buffer.write_integral(i);
+		}
+	});
+}
+
+/**
+ * \brief Sends messages of a kilobyte to a server without a client, so they stay in the ring and then wait to be sent.
+ */
+int32_t send_to_full_ring(SharedMemoryWire::Base& wire, RdId const& rd_id, int32_t count)
+{
+	int32_t rejected = 0;
+	for (int32_t i = 0; i < count; ++i)
+	{
+		try
+		{
+			send_kilobyte(wire, rd_id);
+		}
+		catch (std::exception const&)
+		{
+			++rejected;
+		}
+	}
+	return rejected;
+}
+
+template <typename F>
+bool wait_for(F&& condition, std::chrono::milliseconds timeout = std::chrono::seconds(10))
+{
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (!condition())
+	{
+		if (std::chrono::steady_clock::now() > deadline)
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	return true;
+}
+}	 // namespace
+
+TEST(SharedMemoryWire, limits_bound_waiting_messages)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler scheduler(definition.lifetime, "limits_bound_waiting_messages");
+	SharedMemoryWire::Server server(definition.lifetime, &scheduler, CAPACITY);
+	ASSERT_FALSE(server.handle.empty());
+
+	ByteBufferAsyncProcessor::Limits limits;
+	limits.max_messages = 4;
+	limits.policy = ByteBufferAsyncProcessor::OverflowPolicy::Fail;
+	server.set_send_limits(limits);
+
+	const int32_t rejected = send_to_full_ring(server, RdId(5), 100);
+	auto stats = server.get_send_stats();
+	EXPECT_GT(rejected, 0);
+	EXPECT_EQ(stats.rejected_messages, static_cast<uint64_t>(rejected));
+	EXPECT_LE(stats.queued_messages, 4u);
+	EXPECT_EQ(stats.dropped_messages, 0u);
+	definition.terminate();
+}
+
+TEST(SharedMemoryWire, limits_drop_superseded_messages)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler scheduler(definition.lifetime, "limits_drop_superseded_messages");
+	SharedMemoryWire::Server server(definition.lifetime, &scheduler, CAPACITY);
+	ASSERT_FALSE(server.handle.empty());
+
+	ByteBufferAsyncProcessor::Limits limits;
+	limits.max_messages = 4;
+	limits.policy = ByteBufferAsyncProcessor::OverflowPolicy::DropOldest;
+	server.set_send_limits(limits);
+	server.mark_droppable(RdId(5));
+
+	EXPECT_EQ(send_to_full_ring(server, RdId(5), 100), 0);
+	auto stats = server.get_send_stats();
+	EXPECT_LE(stats.queued_messages, 4u);
+	EXPECT_GT(stats.dropped_messages, 0u);
+	EXPECT_EQ(stats.rejected_messages, 0u);
+
+	// once only the latest droppable message waits, messages of other entities are rejected
+	EXPECT_GT(send_to_full_ring(server, RdId(6), 10), 0);
+	definition.terminate();
+}
+
+TEST(SharedMemoryWire, oversized_message_drops_connection)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler scheduler(definition.lifetime, "oversized_message_drops_connection");
+	SharedMemoryWire::Server server(definition.lifetime, &scheduler, CAPACITY, "oversized-S");
+	ASSERT_FALSE(server.handle.empty());
+	SharedMemoryWire::Client client(definition.lifetime, &scheduler, server.handle, "oversized-C");
+	ASSERT_TRUE(client.is_attached());
+	client.set_max_message_size(2048);
+	ASSERT_TRUE(wait_for([&] { return server.connected.get() && client.connected.get(); }));
+
+	send_kilobyte(server, RdId(1));
+	// the client rejects the declared length before it allocates anything, and the server learns it's disconnected
+	server.send(RdId(1), [](Buffer& buffer) {
+		for (int64_t i = 0; i < 1024; ++i)
+		{
+			buffer.write_integral(i);
+		}
+	});
+	EXPECT_TRUE(wait_for([&] { return !client.connected.get(); }));
+	EXPECT_TRUE(wait_for([&] { return !server.connected.get(); }));
+	definition.terminate();
+}
+
+TEST(SharedMemoryWire, client_rejects_capacity_which_isnt_power_of_two)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler scheduler(definition.lifetime, "client_rejects_capacity_which_isnt_power_of_two");
+	SharedMemoryWire::Server server(definition.lifetime, &scheduler, CAPACITY);
+	ASSERT_FALSE(server.handle.empty());
+
+	int pid = 0;
+	int server_fd = -1;
+	ASSERT_EQ(sscanf(server.handle.c_str(), "%d:%d", &pid, &server_fd), 2);
+	const int fd = open(("/proc/" + std::to_string(pid) + "/fd/" + std::to_string(server_fd)).c_str(), O_RDWR);
+	ASSERT_NE(fd, -1);
+	struct stat status{};
+	ASSERT_EQ(fstat(fd, &status), 0);
+	// rings of a capacity which isn't a power of two, and still fill the segment: the capacity follows magic and version
+	const size_t header_size = static_cast<size_t>(status.st_size) - 2 * CAPACITY;
+	const uint64_t capacity = 6000;
+	ASSERT_EQ(ftruncate(fd, static_cast<off_t>(header_size + 2 * capacity)), 0);
+	ASSERT_EQ(pwrite(fd, &capacity, sizeof(capacity), 2 * sizeof(uint32_t)), static_cast<ssize_t>(sizeof(capacity)));
+	close(fd);
+
+	SharedMemoryWire::Client client(definition.lifetime, &scheduler, server.handle);
+	EXPECT_FALSE(client.is_attached());
+	definition.terminate();
+}
+
+#endif	  // RD_SHARED_MEMORY_WIRE_SUPPORTED
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include "reactive/base/SignalX.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <memory>
+#include <vector>
+
+using namespace rd;
+
+TEST(Signal, listener_advised_while_firing_is_called_from_next_fire)
+{
+	Signal<int32_t> signal;
+	std::vector<int32_t> calls;
+	signal.advise(Lifetime::Eternal(), [&](int32_t const& value) {
+		calls.push_back(value);
+		if (value == 1)
+		{
+			// enough listeners to reallocate the vector the fire iterates
+			for (int32_t i = 0; i < 64; ++i)
+			{
+				signal.advise(Lifetime::Eternal(), [&calls, i](int32_t const& v) { calls.push_back(v * 1000 + i); });
+			}
+		}
+	});
+
+	signal.fire(1);
+	EXPECT_EQ(calls, (std::vector<int32_t>{1}));
+
+	calls.clear();
+	signal.fire(2);
+	std::vector<int32_t> expected{2};
+	for (int32_t i = 0; i < 64; ++i)
+	{
+		expected.push_back(2000 + i);
+	}
+	EXPECT_EQ(calls, expected);
+}
+
+TEST(Signal, nested_fire_calls_every_listener_before_the_outer_one_goes_on)
+{
+	Signal<int32_t> signal;
+	std::vector<int32_t> calls;
+	signal.advise(Lifetime::Eternal(), [&](int32_t const& value) {
+		calls.push_back(value);
+		if (value == 1)
+		{
+			signal.fire(2);
+		}
+		else if (value == 2)
+		{
+			// advised by the nested fire, so neither of the running fires calls it
+			signal.advise(Lifetime::Eternal(), [&calls](int32_t const& v) { calls.push_back(-v); });
+		}
+	});
+	signal.advise(Lifetime::Eternal(), [&](int32_t const& value) { calls.push_back(value * 10); });
+
+	signal.fire(1);
+	EXPECT_EQ(calls, (std::vector<int32_t>{1, 2, 20, 10}));
+
+	calls.clear();
+	signal.fire(3);
+	EXPECT_EQ(calls, (std::vector<int32_t>{3, 30, -3}));
+}
+
+TEST(Signal, listener_terminated_while_firing_isnt_called)
+{
+	Signal<int32_t> signal;
+	std::vector<int32_t> calls;
+	LifetimeDefinition first(Lifetime::Eternal());
+	LifetimeDefinition second(Lifetime::Eternal());
+	priorityAdviseSection([&] {
+		signal.advise(Lifetime::Eternal(), [&](int32_t const& value) {
+			calls.push_back(-value);
+			if (value == 1)
+			{
+				second.terminate();
+			}
+		});
+	});
+	signal.advise(first.lifetime, [&](int32_t const& value) {
+		calls.push_back(value);
+		// terminates the lifetime of the listener being called
+		first.terminate();
+	});
+	signal.advise(second.lifetime, [&](int32_t const& value) { calls.push_back(value * 10); });
+	signal.advise(Lifetime::Eternal(), [&](int32_t const& value) { calls.push_back(value * 100); });
+
+	signal.fire(1);
+	EXPECT_EQ(calls, (std::vector<int32_t>{-1, 1, 100}));
+
+	calls.clear();
+	signal.fire(2);
+	EXPECT_EQ(calls, (std::vector<int32_t>{-2, 200}));
+}
+
+TEST(Signal, listener_terminated_by_nested_fire_isnt_called_by_outer_one)
+{
+	Signal<int32_t> signal;
+	std::vector<int32_t> calls;
+	LifetimeDefinition definition(Lifetime::Eternal());
+	signal.advise(Lifetime::Eternal(), [&](int32_t const& value) {
+		calls.push_back(value);
+		if (value == 1)
+		{
+			signal.fire(2);
+		}
+	});
+	signal.advise(definition.lifetime, [&](int32_t const& value) {
+		calls.push_back(value * 10);
+		definition.terminate();
+	});
+	signal.advise(Lifetime::Eternal(), [&](int32_t const& value) { calls.push_back(value * 100); });
+
+	// the dead listener stays in place until the outer fire returns, so it doesn't shift the rest under it
+	signal.fire(1);
+	EXPECT_EQ(calls, (std::vector<int32_t>{1, 2, 20, 200, 100}));
+
+	calls.clear();
+	signal.fire(3);
+	EXPECT_EQ(calls, (std::vector<int32_t>{3, 300}));
+}
@@ -0,0 +1,399 @@
+#include <gtest/gtest.h>
+
+#include "impl/RdSignal.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SingleThreadScheduler.h"
+#include "wire/SocketWire.h"
+#include "wire/WireReactor.h"
+
+#include "spdlog/sinks/base_sink.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+template <typename F>
+bool wait_for(F&& condition, std::chrono::milliseconds timeout = std::chrono::seconds(10))
+{
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (!condition())
+	{
+		if (std::chrono::steady_clock::now() > deadline)
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	return true;
+}
+
+/**
+ * \brief Client which lets a test hold back its acks and pings by taking the lock they are sent under.
+ */
+class HoldingClient : public SocketWire::Client
+{
+public:
+	using Client::Client;
+
+	std::mutex& control_lock() const
+	{
+		return socket_send_lock;
+	}
+
+	static std::shared_ptr<spdlog::logger> const& wire_logger()
+	{
+		return logger;
+	}
+};
+
+/**
+ * \brief Counts acks sent by the wire of [id], they are traced as "<id> send ack <seqn>".
+ */
+class AckCounter : public spdlog::sinks::base_sink<std::mutex>
+{
+	const std::string prefix;
+
+public:
+	std::atomic<size_t> acks{0};
+
+	explicit AckCounter(std::string const& id) : prefix(id + " send ack ")
+	{
+	}
+
+protected:
+	void sink_it_(spdlog::details::log_msg const& msg) override
+	{
+		if (std::string(msg.payload.data(), msg.payload.size()).compare(0, prefix.size(), prefix) == 0)
+		{
+			++acks;
+		}
+	}
+
+	void flush_() override
+	{
+	}
+};
+
+/**
+ * \brief Server and client wires connected over loopback, with a signal from the server to the client.
+ */
+class SocketWirePair
+{
+public:
+	LifetimeDefinition definition{Lifetime::Eternal()};
+	Lifetime lifetime = definition.lifetime;
+	SingleThreadScheduler server_scheduler;
+	SingleThreadScheduler client_scheduler;
+	std::shared_ptr<SocketWire::Server> server_wire;
+	std::shared_ptr<HoldingClient> client_wire;
+	std::unique_ptr<Protocol> server_protocol;
+	std::unique_ptr<Protocol> client_protocol;
+	RdSignal<std::wstring> server_signal;
+	RdSignal<std::wstring> client_signal;
+
+	SocketWirePair(std::string const& name, WireReactor* reactor)
+		: server_scheduler(lifetime, name + "-server"), client_scheduler(lifetime, name + "-client")
+	{
+		server_wire = std::make_shared<SocketWire::Server>(lifetime, &server_scheduler, 0, name + "-S", reactor);
+		client_wire = std::make_shared<HoldingClient>(lifetime, &client_scheduler, server_wire->port, name + "-C", reactor);
+		server_protocol = std::make_unique<Protocol>(Identities::SERVER, &server_scheduler, server_wire, lifetime);
+		client_protocol = std::make_unique<Protocol>(Identities::CLIENT, &client_scheduler, client_wire, lifetime);
+		statics(server_signal, 1);
+		statics(client_signal, 1);
+		server_signal.async = true;
+		server_scheduler.queue([this] { server_signal.bind(lifetime, server_protocol.get(), "signal"); });
+		server_scheduler.flush();
+	}
+
+	~SocketWirePair()
+	{
+		definition.terminate();
+	}
+};
+}	 // namespace
+
+enum class Framing
+{
+	Plain,
+	Fragmented,
+	Compressed
+};
+
+class SocketWireTest : public testing::TestWithParam<std::tuple<bool, Framing>>
+{
+};
+
+TEST_P(SocketWireTest, oversized_message_drops_connection)
+{
+	const bool with_reactor = std::get<0>(GetParam());
+	const Framing framing = std::get<1>(GetParam());
+	const std::string name = "oversized-" + std::to_string(with_reactor) + std::to_string(static_cast<int>(framing));
+	std::unique_ptr<WireReactor> reactor = with_reactor ? std::make_unique<WireReactor>(name + "-reactor") : nullptr;
+	SocketWirePair pair(name, reactor.get());
+	pair.client_wire->set_max_message_size(64 * 1024);
+	if (framing == Framing::Fragmented)
+	{
+		// each fragment fits, the size of the whole message doesn't
+		pair.server_wire->set_fragment_size(4096);
+	}
+	else if (framing == Framing::Compressed)
+	{
+		// the compressed package fits, its uncompressed size doesn't
+		PackageCompression::Settings settings;
+		settings.codec = PackageCompression::Codec::LZ4;
+		settings.threshold = 1024;
+		pair.server_wire->set_compression(settings);
+	}
+
+	std::atomic<int> received{0};
+	std::atomic<int> disconnects{0};
+	pair.client_scheduler.queue([&] {
+		pair.client_signal.bind(pair.lifetime, pair.client_protocol.get(), "signal");
+		pair.client_signal.advise(pair.lifetime, [&](std::wstring const& value) {
+			EXPECT_EQ(value.size(), 1000u);
+			++received;
+		});
+	});
+	pair.client_scheduler.flush();
+	pair.client_wire->connected.advise(pair.lifetime, [&, was_connected = false](bool const& connected) mutable {
+		if (was_connected && !connected)
+		{
+			++disconnects;
+		}
+		was_connected = connected;
+	});
+	ASSERT_TRUE(wait_for([&] { return pair.server_wire->connected.get() && pair.client_wire->connected.get(); }));
+
+	pair.server_signal.fire(std::wstring(1000, L'a'));
+	ASSERT_TRUE(wait_for([&] { return received == 1; }));
+
+	// the client rejects the declared length before it allocates anything
+	pair.server_signal.fire(std::wstring(100 * 1024, L'b'));
+	EXPECT_TRUE(wait_for([&] { return disconnects > 0; }));
+	EXPECT_EQ(received, 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(framings, SocketWireTest,
+	testing::Combine(testing::Bool(), testing::Values(Framing::Plain, Framing::Fragmented, Framing::Compressed)));
+
+
+class SocketWireFragmentsTest : public testing::TestWithParam<bool>
+{
+};
+
+TEST_P(SocketWireFragmentsTest, messages_to_entities_bound_by_a_fragmented_message_are_delivered)
+{
+	const bool with_reactor = GetParam();
+	const std::string name = "causal-" + std::to_string(with_reactor);
+	std::unique_ptr<WireReactor> reactor = with_reactor ? std::make_unique<WireReactor>(name + "-reactor") : nullptr;
+	SocketWirePair pair(name, reactor.get());
+	pair.server_wire->set_fragment_size(4096);
+
+	RdSignal<int32_t> server_child;
+	RdSignal<int32_t> client_child;
+	statics(server_child, 2);
+	statics(client_child, 2);
+	server_child.async = true;
+	pair.server_scheduler.queue([&] { server_child.bind(pair.lifetime, pair.server_protocol.get(), "child"); });
+	pair.server_scheduler.flush();
+
+	// the child is bound on the client only by the handler of the fragmented message
+	std::vector<int32_t> received;
+	std::atomic<size_t> count{0};
+	pair.client_scheduler.queue([&] {
+		pair.client_signal.bind(pair.lifetime, pair.client_protocol.get(), "signal");
+		pair.client_signal.advise(pair.lifetime, [&](std::wstring const& value) {
+			received.push_back(static_cast<int32_t>(value.size()));
+			++count;
+			client_child.bind(pair.lifetime, pair.client_protocol.get(), "child");
+			client_child.advise(pair.lifetime, [&](int32_t const& value) {
+				received.push_back(value);
+				++count;
+			});
+		});
+	});
+	pair.client_scheduler.flush();
+	ASSERT_TRUE(wait_for([&] { return pair.server_wire->connected.get() && pair.client_wire->connected.get(); }));
+
+	pair.server_signal.fire(std::wstring(64 * 1024, L'a'));
+	server_child.fire(1);
+	server_child.fire(2);
+	ASSERT_TRUE(wait_for([&] { return count == 3; }));
+	pair.client_scheduler.flush();
+	EXPECT_EQ(received, (std::vector<int32_t>{64 * 1024, 1, 2}));
+}
+
+TEST_P(SocketWireFragmentsTest, messages_interleaved_with_fragments_keep_their_order)
+{
+	const bool with_reactor = GetParam();
+	const std::string name = "interleaved-" + std::to_string(with_reactor);
+	std::unique_ptr<WireReactor> reactor = with_reactor ? std::make_unique<WireReactor>(name + "-reactor") : nullptr;
+	SocketWirePair pair(name, reactor.get());
+	pair.server_wire->set_fragment_size(4096);
+
+	RdSignal<int32_t> server_small;
+	RdSignal<int32_t> client_small;
+	statics(server_small, 2);
+	statics(client_small, 2);
+	server_small.async = true;
+	pair.server_scheduler.queue([&] { server_small.bind(pair.lifetime, pair.server_protocol.get(), "small"); });
+	pair.server_scheduler.flush();
+
+	// both entities are bound up front, so small messages may be handled while a large one is still being reassembled
+	std::vector<std::wstring> large;
+	std::vector<int32_t> small;
+	std::vector<size_t> small_before_large;
+	std::atomic<size_t> count{0};
+	pair.client_scheduler.queue([&] {
+		pair.client_signal.bind(pair.lifetime, pair.client_protocol.get(), "signal");
+		pair.client_signal.advise(pair.lifetime, [&](std::wstring const& value) {
+			large.push_back(value);
+			small_before_large.push_back(small.size());
+			++count;
+		});
+		client_small.bind(pair.lifetime, pair.client_protocol.get(), "small");
+		client_small.advise(pair.lifetime, [&](int32_t const& value) {
+			small.push_back(value);
+			++count;
+		});
+	});
+	pair.client_scheduler.flush();
+	ASSERT_TRUE(wait_for([&] { return pair.server_wire->connected.get() && pair.client_wire->connected.get(); }));
+
+	// every large message is about 10 fragments long, small ones are put between and after its fragments
+	constexpr int32_t rounds = 4;
+	constexpr int32_t small_per_round = 8;
+	for (int32_t i = 0; i < rounds; ++i)
+	{
+		pair.server_signal.fire(std::wstring(20 * 1024, static_cast<wchar_t>(L'a' + i)));
+		for (int32_t j = 0; j < small_per_round; ++j)
+		{
+			server_small.fire(i * small_per_round + j);
+		}
+	}
+	ASSERT_TRUE(wait_for([&] { return count == rounds * (small_per_round + 1); }));
+	pair.client_scheduler.flush();
+
+	ASSERT_EQ(large.size(), static_cast<size_t>(rounds));
+	for (int32_t i = 0; i < rounds; ++i)
+	{
+		EXPECT_EQ(large[i], std::wstring(20 * 1024, static_cast<wchar_t>(L'a' + i)));
+		// messages put before a large one are never overtaken by it
+		EXPECT_GE(small_before_large[i], static_cast<size_t>(i * small_per_round));
+	}
+	std::vector<int32_t> expected(rounds * small_per_round);
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		expected[i] = static_cast<int32_t>(i);
+	}
+	EXPECT_EQ(small, expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(reactors, SocketWireFragmentsTest, testing::Bool());
+
+class SocketWireAckTest : public testing::TestWithParam<bool>
+{
+};
+
+TEST_P(SocketWireAckTest, one_ack_covers_many_packages)
+{
+	const bool with_reactor = GetParam();
+	const std::string name = "acks-" + std::to_string(with_reactor);
+	// the wire logger is shared, only traces of this test's client are counted and the rest stay at their level
+	auto const& logger = HoldingClient::wire_logger();
+	const auto level = logger->level();
+	for (auto const& sink : logger->sinks())
+	{
+		sink->set_level(level);
+	}
+	auto counter = std::make_shared<AckCounter>(name + "-C");
+	logger->sinks().push_back(counter);
+	logger->set_level(spdlog::level::trace);
+	{
+		std::unique_ptr<WireReactor> reactor = with_reactor ? std::make_unique<WireReactor>(name + "-reactor") : nullptr;
+		SocketWirePair pair(name, reactor.get());
+		std::atomic<int32_t> received{0};
+		pair.client_scheduler.queue([&] {
+			pair.client_signal.bind(pair.lifetime, pair.client_protocol.get(), "signal");
+			pair.client_signal.advise(pair.lifetime, [&](std::wstring const&) { ++received; });
+		});
+		pair.client_scheduler.flush();
+		ASSERT_TRUE(wait_for([&] { return pair.server_wire->connected.get() && pair.client_wire->connected.get(); }));
+		const size_t acks_before = counter->acks;
+
+		// every package reaches the client while it can't acknowledge any of them
+		constexpr int32_t count = 200;
+		{
+			std::lock_guard<std::mutex> guard(pair.client_wire->control_lock());
+			for (int32_t i = 0; i < count; ++i)
+			{
+				pair.server_signal.fire(std::wstring(16, L'a'));
+			}
+			ASSERT_TRUE(wait_for([&] { return pair.server_wire->get_send_stats().pending_messages == count; }));
+		}
+		EXPECT_TRUE(wait_for([&] { return received == count; }));
+		EXPECT_TRUE(wait_for([&] { return pair.server_wire->get_send_stats().pending_messages == 0; }));
+		EXPECT_GE(counter->acks - acks_before, 1u);
+		EXPECT_LE(counter->acks - acks_before, 4u);
+	}
+	logger->set_level(level);
+	logger->sinks().pop_back();
+}
+
+TEST_P(SocketWireAckTest, unacknowledged_packages_are_resent_after_reconnection)
+{
+	const bool with_reactor = GetParam();
+	const std::string name = "resend-" + std::to_string(with_reactor);
+	std::unique_ptr<WireReactor> reactor = with_reactor ? std::make_unique<WireReactor>(name + "-reactor") : nullptr;
+	SocketWirePair pair(name, reactor.get());
+	std::vector<std::wstring> received;
+	std::atomic<size_t> count{0};
+	pair.client_scheduler.queue([&] {
+		pair.client_signal.bind(pair.lifetime, pair.client_protocol.get(), "signal");
+		pair.client_signal.advise(pair.lifetime, [&](std::wstring const& value) {
+			received.push_back(value);
+			++count;
+		});
+	});
+	pair.client_scheduler.flush();
+	ASSERT_TRUE(wait_for([&] { return pair.server_wire->connected.get() && pair.client_wire->connected.get(); }));
+
+	// seqn 1 tells the client that the server has started over, so it's acknowledged before anything is held back
+	pair.server_signal.fire(std::to_wstring(0));
+	ASSERT_TRUE(wait_for([&] { return count == 1 && pair.server_wire->get_send_stats().pending_messages == 0; }));
+
+	// the connection is dropped while none of the rest is acknowledged
+	constexpr int32_t sent = 100;
+	{
+		std::lock_guard<std::mutex> guard(pair.client_wire->control_lock());
+		for (int32_t i = 1; i < sent; ++i)
+		{
+			pair.server_signal.fire(std::to_wstring(i));
+		}
+		ASSERT_TRUE(wait_for([&] { return pair.server_wire->get_send_stats().pending_messages == sent - 1; }));
+		pair.server_wire->try_shutdown_connection();
+	}
+
+	// the server resends them over the next connection, the client skips the ones it has and acknowledges all
+	EXPECT_TRUE(wait_for([&] { return pair.server_wire->get_send_stats().pending_messages == 0; }));
+	ASSERT_TRUE(wait_for([&] { return count >= sent; }));
+	pair.client_scheduler.flush();
+	std::vector<std::wstring> expected;
+	for (int32_t i = 0; i < sent; ++i)
+	{
+		expected.push_back(std::to_wstring(i));
+	}
+	EXPECT_EQ(received, expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(reactors, SocketWireAckTest, testing::Bool());
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "protocol/RdId.h"
+#include "serialization/ISerializable.h"
+#include "util/hashing.h"
+
+#include <string>
+
+using namespace rd;
+
+namespace
+{
+class Named : public IPolymorphicSerializable
+{
+public:
+	mutable int32_t type_name_calls = 0;
+
+	std::string type_name() const override
+	{
+		++type_name_calls;
+		return "Named";
+	}
+
+	void write(SerializationCtx& /*ctx*/, Buffer& /*buffer*/) const override
+	{
+	}
+
+	std::string toString() const override
+	{
+		return "Named";
+	}
+
+	bool equals(ISerializable const& other) const override
+	{
+		return this == &other;
+	}
+};
+}	 // namespace
+
+TEST(TypeId, constexpr_ids_match_runtime_ones)
+{
+	constexpr RdId model = RdId::Null().mix("RdEditorModel");
+	constexpr RdId field = model.mix(".isBlueprintPathName");
+	const std::string model_name = "RdEditorModel";
+	const std::string field_name = ".isBlueprintPathName";
+	EXPECT_EQ(model, RdId::Null().mix(model_name));
+	EXPECT_EQ(field, RdId::Null().mix(model_name).mix(field_name));
+	EXPECT_EQ(util::getPlatformIndependentHash(std::string()), util::getPlatformIndependentHash(""));
+}
+
+TEST(TypeId, type_id_is_hash_of_type_name_computed_once)
+{
+	Named first;
+	Named second;
+	const RdId expected(util::getPlatformIndependentHash(std::string("Named")));
+	EXPECT_EQ(first.type_id(), expected);
+	EXPECT_EQ(second.type_id(), expected);
+	EXPECT_EQ(first.type_id(), expected);
+	// the id is cached by the dynamic type, so only the first value of the type builds its name
+	EXPECT_EQ(first.type_name_calls + second.type_name_calls, 1);
+}
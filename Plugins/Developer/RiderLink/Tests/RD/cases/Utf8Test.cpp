@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include "protocol/Buffer.h"
+#include "protocol/Utf8.h"
+
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+using units_t = std::vector<uint16_t>;
+
+std::vector<uint8_t> encode(units_t const& units)
+{
+	std::vector<uint8_t> bytes(utf8::length(units.data(), units.size()));
+	utf8::encode(units.data(), units.size(), bytes.data());
+	return bytes;
+}
+
+units_t decode(std::vector<uint8_t> const& bytes)
+{
+	units_t units(bytes.size());
+	units.resize(utf8::decode(bytes.data(), bytes.size(), units.data()));
+	return units;
+}
+
+units_t ascii(size_t count)
+{
+	units_t units;
+	for (size_t i = 0; i < count; ++i)
+	{
+		units.push_back(static_cast<uint16_t>('a' + i % 26));
+	}
+	return units;
+}
+}	 // namespace
+
+TEST(Utf8, encodes_by_code_point_width)
+{
+	EXPECT_EQ(encode({0x41}), (std::vector<uint8_t>{0x41}));
+	EXPECT_EQ(encode({0xe9}), (std::vector<uint8_t>{0xc3, 0xa9}));
+	EXPECT_EQ(encode({0x20ac}), (std::vector<uint8_t>{0xe2, 0x82, 0xac}));
+	// U+1F600 as a surrogate pair
+	EXPECT_EQ(encode({0xd83d, 0xde00}), (std::vector<uint8_t>{0xf0, 0x9f, 0x98, 0x80}));
+}
+
+TEST(Utf8, round_trips_mixed_text_across_ascii_runs)
+{
+	// runs long enough for the vectorized ASCII paths, broken by wider characters at different offsets
+	for (size_t prefix : {0, 7, 8, 15, 16, 17, 40})
+	{
+		units_t units = ascii(prefix);
+		units.insert(units.end(), {0xe9, 0x20ac, 0xd83d, 0xde00});
+		units_t tail = ascii(prefix + 3);
+		units.insert(units.end(), tail.begin(), tail.end());
+		EXPECT_EQ(decode(encode(units)), units) << prefix;
+	}
+}
+
+TEST(Utf8, keeps_unpaired_surrogates)
+{
+	const units_t units{0x61, 0xd800, 0x62, 0xdc00, 0xd83d};
+	const auto bytes = encode(units);
+	EXPECT_EQ(bytes.size(), 1 + 3 + 1 + 3 + 3);
+	EXPECT_EQ(decode(bytes), units);
+}
+
+TEST(Utf8, decodes_malformed_bytes_to_replacement_characters)
+{
+	// a stray continuation byte, a truncated sequence and a code point above U+10FFFF
+	EXPECT_EQ(decode({0x61, 0x80, 0x62}), (units_t{0x61, 0xfffd, 0x62}));
+	EXPECT_EQ(decode({0xe2, 0x82}), (units_t{0xfffd, 0xfffd}));
+	EXPECT_EQ(decode({0xf7, 0xbf, 0xbf, 0xbf}), (units_t{0xfffd, 0xfffd, 0xfffd, 0xfffd}));
+}
+
+TEST(Utf8, buffer_writes_compact_strings_as_utf8)
+{
+	const std::wstring value = L"caf\u00e9 \u20ac \U0001F600 and some ascii after it";
+	Buffer buffer;
+	buffer.set_encoding(Buffer::Encoding::COMPACT);
+	buffer.write_wstring(value);
+	buffer.write_integral<int32_t>(-1);
+	buffer.rewind();
+
+	EXPECT_EQ(buffer.read_wstring(), value);
+	EXPECT_EQ(buffer.read_integral<int32_t>(), -1);
+}
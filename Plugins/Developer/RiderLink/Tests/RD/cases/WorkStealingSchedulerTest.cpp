@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include "base/WireBase.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SingleThreadScheduler.h"
+#include "scheduler/WorkStealingScheduler.h"
+#include "task/RdEndpoint.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Wire which hands messages given to [receive] to its broker, as if they came from the peer, and counts
+ * what is sent.
+ */
+class LoopbackWire : public WireBase
+{
+public:
+	mutable std::atomic<size_t> sent{0};
+
+	explicit LoopbackWire(IScheduler* scheduler) : WireBase(scheduler)
+	{
+	}
+
+	void send(RdId const& /*id*/, std::function<void(Buffer& buffer)> writer) const override
+	{
+		Buffer buffer;
+		writer(buffer);
+		++sent;
+	}
+
+	void receive(RdId const& id, std::function<void(Buffer& buffer)> writer) const
+	{
+		Buffer buffer;
+		buffer.write_integral<int16_t>(0);	  // no context
+		writer(buffer);
+		buffer.set_position(0);
+		message_broker.dispatch(id, std::move(buffer));
+	}
+};
+}	 // namespace
+
+TEST(WorkStealingScheduler, ordered_actions_keep_their_order_when_stolen)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	WorkStealingScheduler scheduler(definition.lifetime, "ws-stolen", 3);
+
+	constexpr int64_t keys = 8;
+	constexpr int32_t per_key = 300;
+	std::vector<std::vector<int32_t>> executed(keys);
+	std::vector<std::unique_ptr<std::atomic<int>>> running;
+	for (int64_t key = 0; key < keys; ++key)
+	{
+		running.push_back(std::make_unique<std::atomic<int>>(0));
+	}
+	std::atomic<int> overlaps{0};
+	std::atomic<int> total{0};
+	std::atomic<std::thread::id> spawner;
+	std::atomic<int> on_spawner{0};
+
+	// actions queued from a worker go to its own queue, it's kept busy until the others stole all of them
+	scheduler.queue([&] {
+		spawner = std::this_thread::get_id();
+		for (int32_t i = 0; i < per_key; ++i)
+		{
+			for (int64_t key = 0; key < keys; ++key)
+			{
+				scheduler.queue_ordered(key, [&, key, i] {
+					if (++*running[key] != 1)
+					{
+						++overlaps;
+					}
+					executed[key].push_back(i);
+					if (std::this_thread::get_id() == spawner)
+					{
+						++on_spawner;
+					}
+					--*running[key];
+					++total;
+				});
+			}
+		}
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (total < keys * per_key && std::chrono::steady_clock::now() < deadline)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	});
+	scheduler.flush();
+
+	EXPECT_EQ(total, keys * per_key);
+	EXPECT_EQ(on_spawner, 0);
+	EXPECT_EQ(overlaps, 0);
+	std::vector<int32_t> expected(per_key);
+	for (int32_t i = 0; i < per_key; ++i)
+	{
+		expected[i] = i;
+	}
+	for (int64_t key = 0; key < keys; ++key)
+	{
+		EXPECT_EQ(executed[key], expected);
+	}
+}
+
+TEST(WorkStealingScheduler, flush_waits_for_requeued_lanes)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	WorkStealingScheduler scheduler(definition.lifetime, "ws-flush", 2);
+
+	// more than a batch, so the rest of the lane is requeued while flush waits
+	constexpr size_t count = 3 * WorkStealingScheduler::MAX_LANE_BATCH + 1;
+	std::atomic<size_t> executed{0};
+	for (size_t i = 0; i < count; ++i)
+	{
+		scheduler.queue_ordered(1, [&] {
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			++executed;
+		});
+	}
+	scheduler.flush();
+	EXPECT_EQ(executed, count);
+}
+
+TEST(WorkStealingScheduler, stop_executes_queued_lanes)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	WorkStealingScheduler scheduler(definition.lifetime, "ws-stop", 2);
+
+	constexpr size_t count = 2 * WorkStealingScheduler::MAX_LANE_BATCH + 1;
+	std::mutex lock;
+	std::condition_variable started_cv;
+	bool started = false;
+	std::atomic<size_t> executed{0};
+	for (size_t i = 0; i < count; ++i)
+	{
+		scheduler.queue_ordered(1, [&] {
+			{
+				std::lock_guard<decltype(lock)> guard(lock);
+				started = true;
+			}
+			started_cv.notify_all();
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			++executed;
+		});
+	}
+	{
+		std::unique_lock<decltype(lock)> guard(lock);
+		started_cv.wait(guard, [&] { return started; });
+	}
+
+	// the workers are stopped while most of the lane is still queued, they finish it before they exit
+	definition.terminate();
+	EXPECT_EQ(executed, count);
+}
+
+TEST(WorkStealingScheduler, endpoint_handles_requests_on_handler_scheduler)
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler protocol_scheduler(definition.lifetime, "ws-endpoint-protocol");
+	WorkStealingScheduler handlers(definition.lifetime, "ws-endpoint-handlers", 3);
+	auto wire = std::make_shared<LoopbackWire>(&protocol_scheduler);
+	Protocol protocol(Identities::SERVER, &protocol_scheduler, wire, definition.lifetime);
+
+	std::vector<int32_t> handled;
+	std::atomic<int> off_handlers{0};
+	RdEndpoint<int32_t, int32_t> endpoint;
+	statics(endpoint, 1);
+	endpoint.set_handler_scheduler(&handlers);
+	endpoint.set([&](int32_t const& request) {
+		if (!handlers.is_active())
+		{
+			++off_handlers;
+		}
+		handled.push_back(request);
+		return request;
+	});
+	protocol_scheduler.queue([&] { endpoint.bind(definition.lifetime, &protocol, "endpoint"); });
+	protocol_scheduler.flush();
+
+	constexpr int32_t count = 200;
+	for (int32_t i = 0; i < count; ++i)
+	{
+		wire->receive(endpoint.get_id(), [i](Buffer& buffer) {
+			RdId(i + 1).write(buffer);
+			buffer.write_integral(i);
+		});
+	}
+	handlers.flush();
+
+	EXPECT_EQ(off_handlers, 0);
+	std::vector<int32_t> expected(count);
+	for (int32_t i = 0; i < count; ++i)
+	{
+		expected[i] = i;
+	}
+	EXPECT_EQ(handled, expected);
+	EXPECT_EQ(wire->sent, static_cast<size_t>(count));
+	definition.terminate();
+}